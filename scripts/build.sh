@@ -7,12 +7,32 @@ cd ../src
 COMPILATION="${1:-debug}"
 CC="g++-10"
 COMPILER_FLAGS="$(find . -type f) -Isrc/include -std=c++2a -static"
+# gzip support needs zlib. Set NAV_ZSTD=1 to also support zstd (needs libzstd).
+LIBS="-lz"
+DEFINES=""
+if [ -n "$NAV_ZSTD" ]
+then
+	LIBS="$LIBS -lzstd"
+	DEFINES="-DNAV_ZSTD"
+fi
 
 mkdir -p ../builddir
 if [ "$COMPILATION" = "release" ]
 then
-	${CC} $COMPILER_FLAGS -o ../builddir/nav
+	${CC} $COMPILER_FLAGS $DEFINES -o ../builddir/nav $LIBS
 elif [ "$COMPILATION" = "debug" ]
 then
-	${CC} $COMPILER_FLAGS -g -o ../builddir/nav
+	${CC} $COMPILER_FLAGS $DEFINES -g -o ../builddir/nav $LIBS
+elif [ "$COMPILATION" = "lib" ]
+then
+	# libnav: everything but the tool, the server and the tests, as a static and a shared library.
+	LIB_SOURCES="$(find . -type f -name '*.cpp' ! -name 'nav_tool.cpp' ! -name 'nav_server.cpp' ! -name 'test_automation.cpp')"
+	mkdir -p ../builddir/libnav
+	for SOURCE in $LIB_SOURCES
+	do
+		${CC} -c "$SOURCE" -Isrc/include -std=c++2a -O2 -fPIC -DNDEBUG $DEFINES -o ../builddir/libnav/"$(basename "${SOURCE%.cpp}")".o || exit 1
+	done
+	ar rcs ../builddir/libnav.a ../builddir/libnav/*.o
+	${CC} -shared -pthread -o ../builddir/libnav.so ../builddir/libnav/*.o $LIBS
+	cp libnav.h ../builddir/
 fi
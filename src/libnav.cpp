@@ -0,0 +1,283 @@
+#include <new>
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <filesystem>
+#include "libnav.h"
+#include "nav_file.hpp"
+#include "nav_area_table.hpp"
+
+// A loaded mesh, behind the C interface.
+struct nav_file {
+	NavFile file;
+	// Columns for spatial queries. Built on first use, dropped when areas change.
+	std::optional<NavAreaTable> table;
+
+	nav_file() = default;
+	nav_file(const std::filesystem::path& path) : file(path) {}
+	NavAreaTable& GetTable() {
+		if (!table.has_value()) {
+			table.emplace();
+			table.value().Build(file.areas.value());
+		}
+		return table.value();
+	}
+	NavArea* GetArea(const size_t& index) {
+		if (!file.areas.has_value() || index >= file.areas.value().size()) return nullptr;
+		return &file.areas.value()[index];
+	}
+};
+
+// Run f, turning exceptions into results, since they can't cross the C interface.
+template<typename Function>
+static nav_result Guard(Function&& f) noexcept {
+	try {
+		return f();
+	}
+	catch (const std::bad_alloc&) {
+		return NAV_ERROR_MEMORY;
+	}
+	catch (...) {
+		return NAV_ERROR_INTERNAL;
+	}
+}
+
+// Copy the properties of info into area.
+static void SetAreaInfo(NavArea& area, const nav_area_info& info) {
+	area.ID = info.id;
+	area.Flags = info.flags;
+	for (unsigned char axis = 0u; axis < 3u; axis++)
+	{
+		area.nwCorner[axis] = info.nw_corner[axis];
+		area.seCorner[axis] = info.se_corner[axis];
+	}
+	area.NorthEastZ = info.north_east_z;
+	area.SouthWestZ = info.south_west_z;
+	area.PlaceID = info.place_id;
+}
+
+uint32_t nav_abi_version(void) {
+	return LIBNAV_ABI_VERSION;
+}
+
+nav_result nav_open(const char* path, nav_file** file) {
+	if (path == nullptr || file == nullptr) return NAV_ERROR_ARGUMENT;
+	return Guard([&]() -> nav_result {
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(path, ec)) return NAV_ERROR_IO;
+		nav_file* loaded = new nav_file(path);
+		if (!loaded->file.ReadFile()) {
+			delete loaded;
+			return NAV_ERROR_FORMAT;
+		}
+		*file = loaded;
+		return NAV_OK;
+	});
+}
+
+nav_result nav_open_buffer(const void* data, size_t size, nav_file** file) {
+	if ((data == nullptr && size > 0u) || file == nullptr) return NAV_ERROR_ARGUMENT;
+	return Guard([&]() -> nav_result {
+		nav_file* loaded = new nav_file();
+		if (!loaded->file.ReadBuffer(std::span<const std::byte>(static_cast<const std::byte*>(data), size))) {
+			delete loaded;
+			return NAV_ERROR_FORMAT;
+		}
+		*file = loaded;
+		return NAV_OK;
+	});
+}
+
+void nav_close(nav_file* file) {
+	delete file;
+}
+
+uint32_t nav_major_version(const nav_file* file) {
+	if (file == nullptr) return 0u;
+	return const_cast<NavFile&>(file->file).GetMajorVersion();
+}
+
+size_t nav_area_count(const nav_file* file) {
+	if (file == nullptr || !file->file.areas.has_value()) return 0u;
+	return file->file.areas.value().size();
+}
+
+nav_result nav_get_area(nav_file* file, size_t index, nav_area_info* info) {
+	if (file == nullptr || info == nullptr) return NAV_ERROR_ARGUMENT;
+	const NavArea* area = file->GetArea(index);
+	if (area == nullptr) return NAV_ERROR_ARGUMENT;
+	info->id = area->ID;
+	info->flags = area->Flags;
+	for (unsigned char axis = 0u; axis < 3u; axis++)
+	{
+		info->nw_corner[axis] = area->nwCorner[axis];
+		info->se_corner[axis] = area->seCorner[axis];
+	}
+	info->north_east_z = area->NorthEastZ.value_or(area->nwCorner[2]);
+	info->south_west_z = area->SouthWestZ.value_or(area->seCorner[2]);
+	info->place_id = area->PlaceID;
+	for (unsigned char direction = 0u; direction < NAV_DIRECTION_COUNT; direction++) info->connection_counts[direction] = area->connectionData[direction].second.size();
+	info->hide_spot_count = area->hideSpotData.first;
+	return NAV_OK;
+}
+
+nav_result nav_find_area(nav_file* file, uint32_t id, size_t* index) {
+	if (file == nullptr || index == nullptr) return NAV_ERROR_ARGUMENT;
+	// A stale index is rebuilt, which allocates.
+	return Guard([&]() -> nav_result {
+		std::optional<size_t> found = file->file.FindAreaIndex(id);
+		if (!found.has_value()) return NAV_ERROR_NOT_FOUND;
+		*index = found.value();
+		return NAV_OK;
+	});
+}
+
+size_t nav_get_connections(nav_file* file, size_t index, nav_direction direction, uint32_t* ids, size_t capacity) {
+	if (file == nullptr || direction < NAV_NORTH || direction >= NAV_DIRECTION_COUNT || (ids == nullptr && capacity > 0u)) return static_cast<size_t>(-1);
+	const NavArea* area = file->GetArea(index);
+	if (area == nullptr) return static_cast<size_t>(-1);
+	const auto& connections = area->connectionData[direction].second;
+	for (size_t i = 0u; i < connections.size() && i < capacity; i++) ids[i] = connections[i].TargetAreaID;
+	return connections.size();
+}
+
+size_t nav_find_areas_in_bounds(nav_file* file, const float min[3], const float max[3], size_t* indices, size_t capacity) {
+	if (file == nullptr || min == nullptr || max == nullptr || (indices == nullptr && capacity > 0u) || !file->file.areas.has_value()) return 0u;
+	try {
+		NavBounds bounds;
+		for (unsigned char axis = 0u; axis < 3u; axis++)
+		{
+			bounds.Min[axis] = min[axis];
+			bounds.Max[axis] = max[axis];
+		}
+		std::vector<size_t> found = file->GetTable().FindInBounds(bounds);
+		for (size_t i = 0u; i < found.size() && i < capacity; i++) indices[i] = found[i];
+		return found.size();
+	}
+	catch (...) {
+		return 0u;
+	}
+}
+
+nav_result nav_find_area_at(nav_file* file, const float position[3], size_t* index) {
+	if (file == nullptr || position == nullptr || index == nullptr) return NAV_ERROR_ARGUMENT;
+	if (!file->file.areas.has_value()) return NAV_ERROR_NOT_FOUND;
+	return Guard([&]() -> nav_result {
+		NavAreaTable& table = file->GetTable();
+		NavBounds bounds;
+		bounds.Min = {position[0], position[1], std::numeric_limits<float>::lowest()};
+		bounds.Max = {position[0], position[1], std::numeric_limits<float>::max()};
+		std::optional<size_t> closest;
+		float closestDistance = std::numeric_limits<float>::max();
+		for (const size_t& candidate : table.FindInBounds(bounds))
+		{
+			const NavBounds areaBounds = table.GetAreaBounds(candidate);
+			// Distance to the area's height range.
+			const float distance = position[2] < areaBounds.Min[2] ? areaBounds.Min[2] - position[2] : position[2] > areaBounds.Max[2] ? position[2] - areaBounds.Max[2] : 0.0f;
+			if (distance < closestDistance) {
+				closest = candidate;
+				closestDistance = distance;
+			}
+		}
+		if (!closest.has_value()) return NAV_ERROR_NOT_FOUND;
+		*index = closest.value();
+		return NAV_OK;
+	});
+}
+
+nav_result nav_set_area(nav_file* file, size_t index, const nav_area_info* info) {
+	if (file == nullptr || info == nullptr) return NAV_ERROR_ARGUMENT;
+	NavArea* area = file->GetArea(index);
+	if (area == nullptr) return NAV_ERROR_ARGUMENT;
+	return Guard([&]() -> nav_result {
+		if (info->id != area->ID && file->file.FindAreaIndex(info->id).has_value()) return NAV_ERROR_EXISTS;
+		const bool newID = info->id != area->ID;
+		SetAreaInfo(*area, *info);
+		area->MarkDirty();
+		if (newID) file->file.IndexAreas();
+		file->table.reset();
+		return NAV_OK;
+	});
+}
+
+nav_result nav_add_area(nav_file* file, const nav_area_info* info, size_t* index) {
+	if (file == nullptr || info == nullptr) return NAV_ERROR_ARGUMENT;
+	return Guard([&]() -> nav_result {
+		if (info->id != 0u && file->file.FindAreaIndex(info->id).has_value()) return NAV_ERROR_EXISTS;
+		NavFile& navFile = file->file;
+		NavArea area{};
+		SetAreaInfo(area, *info);
+		if (area.ID == 0u) area.ID = navFile.GetNextAreaID();
+		if (navFile.GetMajorVersion() >= 16u) area.visAreaCount = 0u;
+		area.customDataSize = getCustomDataSize(navFile.GetMajorVersion(), navFile.GetMinorVersion());
+		area.customData.resize(area.customDataSize);
+		if (!navFile.areas.has_value()) navFile.areas.emplace();
+		auto areaIt = navFile.InsertArea(navFile.areas.value().cend(), std::move(area));
+		if (index != nullptr) *index = areaIt - navFile.areas.value().begin();
+		file->table.reset();
+		return NAV_OK;
+	});
+}
+
+nav_result nav_remove_area(nav_file* file, size_t index) {
+	if (file == nullptr || file->GetArea(index) == nullptr) return NAV_ERROR_ARGUMENT;
+	return Guard([&]() -> nav_result {
+		file->file.EraseArea(file->file.areas.value().cbegin() + index);
+		file->table.reset();
+		return NAV_OK;
+	});
+}
+
+nav_result nav_add_connection(nav_file* file, size_t index, nav_direction direction, uint32_t target_id) {
+	if (file == nullptr || direction < NAV_NORTH || direction >= NAV_DIRECTION_COUNT) return NAV_ERROR_ARGUMENT;
+	NavArea* area = file->GetArea(index);
+	if (area == nullptr) return NAV_ERROR_ARGUMENT;
+	return Guard([&]() -> nav_result {
+		area->connectionData[direction].second.emplace_back().TargetAreaID = target_id;
+		area->connectionData[direction].first = area->connectionData[direction].second.size();
+		area->MarkDirty();
+		file->table.reset();
+		return NAV_OK;
+	});
+}
+
+nav_result nav_remove_connection(nav_file* file, size_t index, nav_direction direction, uint32_t target_id) {
+	if (file == nullptr || direction < NAV_NORTH || direction >= NAV_DIRECTION_COUNT) return NAV_ERROR_ARGUMENT;
+	NavArea* area = file->GetArea(index);
+	if (area == nullptr) return NAV_ERROR_ARGUMENT;
+	auto& connections = area->connectionData[direction].second;
+	auto it = std::find_if(connections.begin(), connections.end(), [&target_id](const NavConnection& connection) { return connection.TargetAreaID == target_id; });
+	if (it == connections.end()) return NAV_ERROR_NOT_FOUND;
+	connections.erase(it);
+	area->connectionData[direction].first = connections.size();
+	area->MarkDirty();
+	file->table.reset();
+	return NAV_OK;
+}
+
+nav_result nav_save(nav_file* file) {
+	if (file == nullptr || file->file.GetFilePath().empty()) return NAV_ERROR_ARGUMENT;
+	return Guard([&]() -> nav_result {
+		return file->file.SaveFile(false, true) ? NAV_OK : NAV_ERROR_IO;
+	});
+}
+
+nav_result nav_serialize(nav_file* file, void** data, size_t* size) {
+	if (file == nullptr || data == nullptr || size == nullptr) return NAV_ERROR_ARGUMENT;
+	return Guard([&]() -> nav_result {
+		std::string encoded;
+		if (!file->file.SerializeData(encoded)) return NAV_ERROR_INTERNAL;
+		void* buffer = std::malloc(encoded.size() > 0u ? encoded.size() : 1u);
+		if (buffer == nullptr) return NAV_ERROR_MEMORY;
+		std::memcpy(buffer, encoded.data(), encoded.size());
+		*data = buffer;
+		*size = encoded.size();
+		return NAV_OK;
+	});
+}
+
+void nav_free_buffer(void* data) {
+	std::free(data);
+}
@@ -0,0 +1,110 @@
+#ifndef LIBNAV_H
+#define LIBNAV_H
+/*
+	C interface to the NAV library, for programs that load meshes in-process.
+	A nav_file handle owns a loaded mesh. Handles aren't thread-safe; use one per thread or lock around them.
+	Areas are addressed by their index in the file, which changes when areas are added or removed.
+	Functions that can fail return a nav_result. Nothing is written to the standard streams.
+*/
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped whenever a function or struct changes incompatibly.
+#define LIBNAV_ABI_VERSION 1u
+
+typedef enum nav_result {
+	NAV_OK = 0,
+	NAV_ERROR_ARGUMENT = -1, // A null pointer, or an index or direction out of range.
+	NAV_ERROR_IO = -2, // The file couldn't be opened or written.
+	NAV_ERROR_FORMAT = -3, // The data isn't a NAV mesh this library can read.
+	NAV_ERROR_NOT_FOUND = -4, // No area (or connection) with that ID.
+	NAV_ERROR_EXISTS = -5, // An area with that ID already exists.
+	NAV_ERROR_MEMORY = -6, // Out of memory.
+	NAV_ERROR_INTERNAL = -7 // Anything else.
+} nav_result;
+
+// Connection directions.
+typedef enum nav_direction {
+	NAV_NORTH = 0,
+	NAV_EAST,
+	NAV_SOUTH,
+	NAV_WEST,
+	NAV_DIRECTION_COUNT
+} nav_direction;
+
+// Loaded mesh.
+typedef struct nav_file nav_file;
+
+// The basic properties of an area.
+typedef struct nav_area_info {
+	uint32_t id;
+	uint32_t flags; // Attribute flags.
+	float nw_corner[3]; // North-west corner.
+	float se_corner[3]; // South-east corner.
+	float north_east_z; // Height of the north-east corner.
+	float south_west_z; // Height of the south-west corner.
+	uint16_t place_id;
+	uint32_t connection_counts[NAV_DIRECTION_COUNT]; // Read only.
+	uint8_t hide_spot_count; // Read only.
+} nav_area_info;
+
+// LIBNAV_ABI_VERSION of the library that is loaded.
+uint32_t nav_abi_version(void);
+
+// Load the NAV file at path. *file must be freed with nav_close().
+nav_result nav_open(const char* path, nav_file** file);
+// Load NAV data from memory. The data is copied, so it can be freed afterwards.
+// Compressed and big-endian data is read like nav_open() reads it from files.
+// The mesh has no path, so it can only be written out with nav_serialize().
+nav_result nav_open_buffer(const void* data, size_t size, nav_file** file);
+// Free a loaded mesh. file may be null.
+void nav_close(nav_file* file);
+
+// NAV format version.
+uint32_t nav_major_version(const nav_file* file);
+// Number of areas.
+size_t nav_area_count(const nav_file* file);
+// Get the area at index.
+nav_result nav_get_area(nav_file* file, size_t index, nav_area_info* info);
+// Find the index of the area with id.
+nav_result nav_find_area(nav_file* file, uint32_t id, size_t* index);
+/* Get the IDs of the areas the area at index connects to in direction.
+   Up to capacity IDs are written to ids (which may be null if capacity is 0).
+   Returns the number of connections, or (size_t)-1 if the arguments are invalid. */
+size_t nav_get_connections(nav_file* file, size_t index, nav_direction direction, uint32_t* ids, size_t capacity);
+
+/* Find the areas that overlap the box between min and max.
+   Up to capacity indices are written to indices (which may be null if capacity is 0).
+   Returns the number of areas found. */
+size_t nav_find_areas_in_bounds(nav_file* file, const float min[3], const float max[3], size_t* indices, size_t capacity);
+// Find the area above or below position (x, y) whose height is closest to the position's.
+nav_result nav_find_area_at(nav_file* file, const float position[3], size_t* index);
+
+/* Set the ID, flags, corners and place of the area at index from info.
+   Counts in info are ignored. */
+nav_result nav_set_area(nav_file* file, size_t index, const nav_area_info* info);
+/* Add an area with the properties in info at the end. An ID of 0 picks an unused ID.
+   The new area's index is written to index, if it isn't null. */
+nav_result nav_add_area(nav_file* file, const nav_area_info* info, size_t* index);
+// Remove the area at index. The areas after it move down one index.
+nav_result nav_remove_area(nav_file* file, size_t index);
+// Connect the area at index to the area with target_id in direction.
+nav_result nav_add_connection(nav_file* file, size_t index, nav_direction direction, uint32_t target_id);
+// Remove the connection from the area at index to the area with target_id in direction.
+nav_result nav_remove_connection(nav_file* file, size_t index, nav_direction direction, uint32_t target_id);
+
+// Save to the path the mesh was loaded from.
+nav_result nav_save(nav_file* file);
+/* Encode the mesh into a new buffer. *data must be freed with nav_free_buffer(). */
+nav_result nav_serialize(nav_file* file, void** data, size_t* size);
+// Free a buffer from nav_serialize(). data may be null.
+void nav_free_buffer(void* data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
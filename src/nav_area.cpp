@@ -3,8 +3,29 @@
 #include <fstream>
 #include <climits>
 #include <memory>
+#include <cstring>
+#include <type_traits>
 #include "nav_area.hpp"
 #include "nav_base.hpp"
+#include "nav_codec.hpp"
+
+// Otherwise std::vector<NavArea> copies every area (out of its arena) when it grows.
+static_assert(std::is_nothrow_move_constructible_v<NavArea>, "NavArea must be nothrow move constructible.");
+
+// Area whose containers allocate from resource.
+NavArea::NavArea(std::pmr::memory_resource* resource) :
+	connectionData{
+		std::make_pair(0, std::pmr::vector<NavConnection>(resource)),
+		std::make_pair(0, std::pmr::vector<NavConnection>(resource)),
+		std::make_pair(0, std::pmr::vector<NavConnection>(resource)),
+		std::make_pair(0, std::pmr::vector<NavConnection>(resource))},
+	hideSpotData(0u, std::pmr::vector<NavHideSpot>(resource)),
+	ladderData{
+		std::make_pair(0u, std::pmr::list<IntID>(resource)),
+		std::make_pair(0u, std::pmr::list<IntID>(resource))},
+	customData(resource),
+	lazyData(resource) {
+}
 
 NavArea::~NavArea() {
 	
@@ -55,488 +76,700 @@ void NavArea::OutputData(std::ostream& ostream) const {
 	ostream << "\n\tVisibility Inheritance ID: " << InheritVisibilityFromAreaID << '\n';
 }
 
-// Fill data from buffer.
-// Returns true on success, false on failure.
-bool NavArea::ReadData(std::streambuf& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
-	std::streampos startPos = buf.pubseekoff(0, std::ios_base::cur);
-	if (buf.sgetn(reinterpret_cast<char*>(&ID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-		std::cerr << "NavArea::ReadData(): FATAL: Could not read area ID!\n";
-		return false;
-	}; // ID
-	{
-		// 8-bit flag
-		if (MajorVersion < 8) {
-			Flags = buf.sbumpc();
-			if (Flags == std::streambuf::traits_type::eof()) {
-				std::cerr << "NavArea::ReadData(): FATAL: Could not read area 8-bit flag!\n";
-				return false;
-			}
-		}
-		// 16-bit flag
-		else if (MajorVersion <= 13) {
-			unsigned short tmp;
-			if (buf.sgetn(reinterpret_cast<char*>(&tmp), VALVE_SHORT_SIZE) != VALVE_SHORT_SIZE) {
-				std::cerr << "NavArea::ReadData(): FATAL: Could not read area 16-bit flag!\n";
-				return false;
-			}
-			Flags = tmp;
-		}
-		// 32-bit flag
-		else {
-			if (buf.sgetn(reinterpret_cast<char*>(&Flags), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-				std::cerr << "NavArea::ReadData(): FATAL: Could not read area 32-bit flag!\n";
-				return false;
-			}
-		}
+// Raw bytes of a stream or of NAV data in memory.
+static bool ReadBytes(std::streambuf& buf, void* data, const size_t& size) {
+	return static_cast<size_t>(buf.sgetn(reinterpret_cast<char*>(data), size)) == size;
+}
+
+static bool ReadBytes(NavBufferReader& buf, void* data, const size_t& size) {
+	return buf.ReadBytes(data, size);
+}
+
+static bool SkipBytes(std::streambuf& buf, const size_t& size) {
+	return size == 0u || buf.pubseekoff(size, std::ios_base::cur, std::ios_base::in) != std::streampos(-1);
+}
+
+static bool SkipBytes(NavBufferReader& buf, const size_t& size) {
+	return buf.Skip(size);
+}
+
+static bool WriteBytes(std::streambuf& out, const void* data, const size_t& size) {
+	return static_cast<size_t>(out.sputn(reinterpret_cast<const char*>(data), size)) == size;
+}
+
+template<typename T>
+struct IsOptional : std::false_type {};
+template<typename T>
+struct IsOptional<std::optional<T> > : std::true_type {};
+
+// The value of a field as it is stored. Unset fields are stored blank.
+template<typename Packed, typename T>
+static Packed PackField(const T& value) {
+	if constexpr (IsOptional<T>::value) return value.has_value() ? static_cast<Packed>(value.value()) : Packed{};
+	else return static_cast<Packed>(value);
+}
+
+// Empty a section's records. Optional sections are left unset.
+template<typename Container>
+static void ResetRecords(Container& records) {
+	if constexpr (IsOptional<Container>::value) records.reset();
+	else records.clear();
+}
+
+// Get a section's records, creating them if the section is optional.
+template<typename Container>
+static auto& EmplaceRecords(Container& records, std::pmr::memory_resource* resource) {
+	if constexpr (IsOptional<Container>::value) return records.emplace(resource);
+	else return records;
+}
+
+// Get a section's records. Unset sections have none, so their records are written blank.
+template<typename Container>
+static const auto& StoredRecords(const Container& records) {
+	if constexpr (IsOptional<Container>::value) {
+		static const typename Container::value_type noRecords;
+		return records.has_value() ? records.value() : noRecords;
+	}
+	else return records;
+}
+
+// Accessor of an area member, for both mutable and const areas.
+#define NAV_AREA_FIELD(member) [](auto& area) -> auto& { return area.member; }
+
+/*
+	The fields of area data in one NAV major version, in file order.
+	Field is a fixed size field stored as Packed, Run a count followed by that many records.
+	LazyRun and EncounterPaths are sections that may be left undecoded when reading from memory.
+*/
+template<unsigned int MajorVersion, typename Visitor>
+bool NavArea::VisitSchema(Visitor& visitor) {
+	constexpr NavAreaLayout Layout = GetNavAreaLayout(MajorVersion);
+	using Flag = std::conditional_t<Layout.FlagSize == VALVE_CHAR_SIZE, unsigned char, std::conditional_t<Layout.FlagSize == VALVE_SHORT_SIZE, unsigned short, unsigned int> >;
+	// ID, attribute flags, corners, NorthEastZ and SouthWestZ.
+	if (!visitor.template Field<IntID>("area ID", NAV_AREA_FIELD(ID))
+	|| !visitor.template Field<Flag>("attribute flags", NAV_AREA_FIELD(Flags))
+	|| !visitor.template Field<std::array<float, 3> >("nwCorner", NAV_AREA_FIELD(nwCorner))
+	|| !visitor.template Field<std::array<float, 3> >("seCorner", NAV_AREA_FIELD(seCorner))
+	|| !visitor.template Field<float>("NorthEastZ", NAV_AREA_FIELD(NorthEastZ))
+	|| !visitor.template Field<float>("SouthWestZ", NAV_AREA_FIELD(SouthWestZ))) return false;
+	// Connections (NESW).
+	if (!visitor.template Run<NavConnection, unsigned int>("north connections", NAV_AREA_FIELD(connectionData[0].first), NAV_AREA_FIELD(connectionData[0].second))
+	|| !visitor.template Run<NavConnection, unsigned int>("east connections", NAV_AREA_FIELD(connectionData[1].first), NAV_AREA_FIELD(connectionData[1].second))
+	|| !visitor.template Run<NavConnection, unsigned int>("south connections", NAV_AREA_FIELD(connectionData[2].first), NAV_AREA_FIELD(connectionData[2].second))
+	|| !visitor.template Run<NavConnection, unsigned int>("west connections", NAV_AREA_FIELD(connectionData[3].first), NAV_AREA_FIELD(connectionData[3].second))) return false;
+	// Hiding spots.
+	if (!visitor.template LazyRun<NavHideSpot, unsigned char>("hide spots", LazySection::HideSpots, NAV_AREA_FIELD(hideSpotData.first), NAV_AREA_FIELD(hideSpotData.second))) return false;
+	// Approach spots which are not in newer NAV versions.
+	if constexpr (Layout.HasApproachSpots) {
+		if (!visitor.template LazyRun<NavApproachSpot, unsigned char>("approach spots", LazySection::ApproachSpots, NAV_AREA_FIELD(approachSpotCount), NAV_AREA_FIELD(approachSpotData))) return false;
+	}
+	// Encounter paths and place ID.
+	if (!visitor.EncounterPaths("encounter paths", LazySection::EncounterPaths, NAV_AREA_FIELD(encounterPathCount), NAV_AREA_FIELD(encounterPaths))
+	|| !visitor.template Field<unsigned short>("place ID", NAV_AREA_FIELD(PlaceID))) return false;
+	// Ladder IDs (up and down), and occupy times.
+	if (!visitor.template Run<IntID, unsigned int>("up ladders", NAV_AREA_FIELD(ladderData[0].first), NAV_AREA_FIELD(ladderData[0].second))
+	|| !visitor.template Run<IntID, unsigned int>("down ladders", NAV_AREA_FIELD(ladderData[1].first), NAV_AREA_FIELD(ladderData[1].second))
+	|| !visitor.template Field<std::array<float, 2> >("occupy times", NAV_AREA_FIELD(EarliestOccupationTimes))) return false;
+	// Light intensity (NESW).
+	if constexpr (Layout.HasLightIntensity) {
+		if (!visitor.template Field<std::array<float, 4> >("light intensities", NAV_AREA_FIELD(LightIntensity))) return false;
+	}
+	// Visible areas and InheritVisibilityFromAreaID.
+	if constexpr (Layout.HasVisibility) {
+		if (!visitor.template LazyRun<NavVisibleArea, unsigned int>("visible areas", LazySection::VisAreas, NAV_AREA_FIELD(visAreaCount), NAV_AREA_FIELD(visAreas))
+		|| !visitor.template Field<IntID>("InheritVisibilityFromAreaID", NAV_AREA_FIELD(InheritVisibilityFromAreaID))) return false;
+	}
+	// Game-specific data.
+	return visitor.CustomData();
+}
+
+#undef NAV_AREA_FIELD
+
+// Walk the schema of MajorVersion with visitor.
+// Returns true if every field was visited, false if the visitor failed.
+template<typename Visitor>
+bool NavArea::VisitData(const unsigned int& MajorVersion, Visitor& visitor) {
+	// One version of each layout, so versions that share a layout share the generated code.
+	const NavAreaLayout layout = GetNavAreaLayout(MajorVersion);
+	if (layout == GetNavAreaLayout(7u)) return VisitSchema<7u>(visitor);
+	if (layout == GetNavAreaLayout(10u)) return VisitSchema<10u>(visitor);
+	if (layout == GetNavAreaLayout(13u)) return VisitSchema<13u>(visitor);
+	if (layout == GetNavAreaLayout(14u)) return VisitSchema<14u>(visitor);
+	if (layout == GetNavAreaLayout(15u)) return VisitSchema<15u>(visitor);
+	return VisitSchema<LATEST_NAV_MAJOR_VERSION>(visitor);
+}
+
+// Reads area data. Streams are decoded fully, data in memory leaves the lazy sections undecoded.
+template<typename Buffer>
+class NavArea::Decoder {
+	public:
+	static constexpr bool InMemory = std::is_same_v<Buffer, NavBufferReader>;
+	// Raw data of the sections left undecoded.
+	std::array<std::span<const std::byte>, static_cast<size_t>(LazySection::Count)> sections = {};
+
+	Decoder(NavArea& area, Buffer& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion)
+	: area(area), buf(buf), MajorVersion(MajorVersion), MinorVersion(MinorVersion) {
 	}
-	// Read nwCorner corner vector.
-	for (size_t i = 0; i < nwCorner.size(); i++)
-	{
-		if (buf.sgetn(reinterpret_cast<char*>(nwCorner.data() + i), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-			std::cerr << "NavArea::ReadData(): FATAL: Could not read nwCorner["<<i<<"]!\n";
-				return false;
-		}
+
+	template<typename Packed, typename Get>
+	bool Field(const char* name, Get get) {
+		Packed value;
+		if (!ReadBytes(buf, &value, sizeof(Packed))) return Failed(name);
+		get(area) = value;
+		return true;
 	}
-	// Read seCorner corner vector.
-	for (size_t i = 0; i < seCorner.size(); i++)
-	{
-		if (buf.sgetn(reinterpret_cast<char*>(seCorner.data() + i), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-			std::cerr << "NavArea::ReadData(): FATAL: Could not read nwCorner["<<i<<"]!\n";
-			return false;
-		}
+
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool Run(const char* name, GetCount getCount, GetRecords getRecords) {
+		Count count;
+		if (!ReadBytes(buf, &count, sizeof(Count))) return Failed(name);
+		getCount(area) = count;
+		return ReadRecordRun<Record>(buf, count, getRecords(area)) || Failed(name);
 	}
-	// Read NorthEastZ…
-	{
-		float tmp;
-		if (buf.sgetn(reinterpret_cast<char*>(&tmp), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-			std::cerr << "NavArea::ReadData(): Could not get NorthEastZ!\n";
-			return false;
-		}
-		NorthEastZ = tmp;
-		// …and SouthWestZ.
-		if (buf.sgetn(reinterpret_cast<char*>(&tmp), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-			std::cerr << "NavArea::ReadData(): Could not get SouthWestZ!\n";
-			return false;
-		}
-		SouthWestZ = tmp;
+
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool LazyRun(const char* name, const LazySection& section, GetCount getCount, GetRecords getRecords) {
+		Count count;
+		if (!ReadBytes(buf, &count, sizeof(Count))) return Failed(name);
+		getCount(area) = count;
+		auto& records = getRecords(area);
+		ResetRecords(records);
+		if (count == 0u) return true;
+		if constexpr (InMemory) {
+			std::optional<std::span<const std::byte> > run = buf.ReadSpan(static_cast<size_t>(count) * NavRecordCodec<Record>::Size);
+			if (!run.has_value()) return Failed(name);
+			sections[static_cast<size_t>(section)] = run.value();
+			return true;
+		}
+		else return ReadRecordRun<Record>(buf, count, EmplaceRecords(records, area.GetMemoryResource())) || Failed(name);
 	}
 
-	// Read connection data.
-	for (unsigned char currDirection = (char)Direction::North; currDirection < (char)Direction::Count; currDirection++)
-	{
-		if (buf.sgetn(reinterpret_cast<char*>(&connectionData[currDirection].first), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::ReadData(): Could not get direction " << (int)currDirection <<" connection data count!\n";
-			#endif
-			return false;
-		}
-		for (size_t i = 0; i < connectionData[currDirection].first; i++)
-		{
-			connectionData[currDirection].second.emplace_back();
-			if (!connectionData[currDirection].second.back().ReadData(buf)) {
-				#ifndef NDEBUG
-				std::cerr << "NavArea::ReadData(): Failed to read connection data for direction "<<std::to_string(currDirection)<<"!\n";
-				#endif
-				return false;
+	template<typename GetCount, typename GetPaths>
+	bool EncounterPaths(const char* name, const LazySection& section, GetCount getCount, GetPaths getPaths) {
+		unsigned int& count = getCount(area);
+		if (!ReadBytes(buf, &count, sizeof(count))) return Failed(name);
+		auto& paths = getPaths(area);
+		paths.reset();
+		if (count == 0u) return true;
+		if constexpr (InMemory) {
+			// Only their extent is found here.
+			const size_t start = buf.Tell();
+			for (unsigned int pathIndex = 0u; pathIndex < count; pathIndex++)
+			{
+				unsigned char spotCount;
+				if (!buf.Skip(ENCOUNTER_PATH_SIZE) || !buf.Read(spotCount) || !buf.Skip(spotCount * ENCOUNTER_SPOT_SIZE)) return Failed(name);
 			}
+			sections[static_cast<size_t>(section)] = buf.GetData().subspan(start, buf.Tell() - start);
+			return true;
 		}
-	}
-	// Hiding spot count.
-	if (buf.sgetn(reinterpret_cast<char*>(&hideSpotData.first), VALVE_CHAR_SIZE) != VALVE_CHAR_SIZE) {
-		std::cerr << "NavArea::ReadData(): Could not get hide spot count!\n";
-		return false;
-	}
-	for (size_t i = 0; i < hideSpotData.first; i++)
-	{
-		hideSpotData.second.emplace_back();
-		if (!hideSpotData.second.back().ReadData(buf)) {
-			std::cerr << "NavArea::ReadData(): Could not read hide spot data!\n";
-			return false;
+		else {
+			// Added as they are read, so a corrupt count fails at the end of the data instead of allocating for it.
+			paths.emplace(area.GetMemoryResource());
+			for (unsigned int pathIndex = 0u; pathIndex < count; pathIndex++) if (!paths.value().emplace_back().ReadData(buf)) return Failed(name);
+			return true;
 		}
 	}
 
-	// Approach spots which are not in newer NAV versions.
-	if (MajorVersion < 15) {
-		approachSpotCount = buf.sbumpc();
-		if (approachSpotCount == std::streambuf::traits_type::eof()) {
-			std::clog << "NavArea::ReadData(): Could not read approach spot count!\n";
-			return false;
-		}
-		if (approachSpotCount > 0 && !approachSpotData.has_value()) approachSpotData = std::vector<NavApproachSpot>();
-		for (size_t i = 0; i < approachSpotCount; i++)
-		{
-			approachSpotData.value().emplace_back();
-			if (!approachSpotData.value().back().ReadData(buf)) {
-				#ifndef NDEBUG
-				std::clog << "NavArea::ReadData(): Failed to read approach spot data!\n";
-				#endif
-				return false;
-			}
-		}
+	bool CustomData() {
+		// The size is peeked, so no need to seek back.
+		area.customDataSize = getCustomDataSize(buf, MajorVersion, MinorVersion);
+		area.customData.clear();
+		area.customData.resize(area.customDataSize);
+		return ReadBytes(buf, area.customData.data(), area.customDataSize) || Failed("custom data");
 	}
 
-	// Encounter Paths.
-	if (buf.sgetn(reinterpret_cast<char*>(&encounterPathCount), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-		std::clog << "NavArea::ReadData(): Could not get encounter path count!\n";
-		return false;
-	}
-	if (encounterPathCount > 0 && !encounterPaths.has_value()) encounterPaths = std::deque<NavEncounterPath>(encounterPathCount);
-	for (unsigned int pathIndex=0; pathIndex < encounterPathCount; pathIndex++) {
-		if (!encounterPaths.value().at(pathIndex).ReadData(buf)) {
-			#ifndef NDEBUG
-			std::clog << "NavArea::ReadData(): Could not read encounter path data!\n";
-			#endif
-			return false;
-		}
-	}
-	// Read place ID.
-	if (buf.sgetn(reinterpret_cast<char*>(&PlaceID), VALVE_SHORT_SIZE) != VALVE_SHORT_SIZE) {
+	private:
+	NavArea& area;
+	Buffer& buf;
+	const unsigned int& MajorVersion;
+	const std::optional<unsigned int>& MinorVersion;
+
+	static bool Failed(const char* name) {
 		#ifndef NDEBUG
-		std::clog << "NavArea::ReadData(): Could not get place ID!\n";
+		std::clog << "NavArea::ReadData(): Could not read " << name << "!\n";
 		#endif
 		return false;
 	}
-	// Handle ladders
-	for (char i = 0; i < 2; i++)
-	{
-		if (buf.sgetn(reinterpret_cast<char*>(&ladderData[i].first), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::ReadData(): Could not get ladder data count (for direction " << i << ")!\n";
-			#endif
-			return false;
-		}
-		for (size_t it = 0; it < ladderData[i].first; it++)
-		{
-			IntID id;
-			if (buf.sgetn(reinterpret_cast<char*>(&id), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-				std::clog << "NavArea::ReadData(): Could not read ladder ID!\n";
-				return false;
-			}
-			ladderData[i].second.push_back(id);
-		}
-		
+};
+
+// Writes area data. Undecoded sections are written back from their raw data.
+class NavArea::Encoder {
+	public:
+	Encoder(NavArea& area, std::streambuf& out)
+	: area(area), out(out) {
 	}
-	// Occupy times
-	for (size_t i = 0; i < EarliestOccupationTimes.size(); i++)
-	{
-		if (buf.sgetn(reinterpret_cast<char*>(EarliestOccupationTimes.data() + i), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-			std::cerr << "NavArea::ReadData(): Could not read occupy time for team '" << i << "'!\n";
-			return false;
-		}
+
+	template<typename Packed, typename Get>
+	bool Field(const char* name, Get get) {
+		const Packed value = PackField<Packed>(get(area));
+		return WriteBytes(out, &value, sizeof(Packed)) || Failed(name);
 	}
-	// Light intensity
-	if (MajorVersion >= 11) {
-		if (!LightIntensity.has_value()) LightIntensity.emplace(std::array<float, 4>({0.0f, 0.0f, 0.0f, 0.0f}));
-		for (size_t i = 0; i < (char)Direction::Count; i++)
-		{
-			if (buf.sgetn(reinterpret_cast<char*>(LightIntensity.value().data() + i), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-				#ifndef NDEBUG
-				std::cerr << "NavArea::ReadData(): Could not read light intensity for corner["<<i<<"]!\n";
-				#endif
-				return false;
-			}
+
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool Run(const char* name, GetCount getCount, GetRecords getRecords) {
+		const Count count = getCount(area);
+		return (WriteBytes(out, &count, sizeof(Count)) && WriteRecordRun<Record>(out, count, getRecords(area))) || Failed(name);
+	}
+
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool LazyRun(const char* name, const LazySection& section, GetCount getCount, GetRecords getRecords) {
+		const Count count = PackField<Count>(getCount(area));
+		if (!WriteBytes(out, &count, sizeof(Count))) return Failed(name);
+		if (area.IsPending(section)) {
+			std::span<const std::byte> data = area.GetLazyData(section);
+			return WriteBytes(out, data.data(), data.size()) || Failed(name);
 		}
+		// Missing records are written blank.
+		return WriteRecordRun<Record>(out, count, StoredRecords(getRecords(area))) || Failed(name);
 	}
-	// Visible areas
-	if (MajorVersion >= 16) {
+
+	template<typename GetCount, typename GetPaths>
+	bool EncounterPaths(const char* name, const LazySection& section, GetCount getCount, GetPaths getPaths) {
+		const unsigned int count = getCount(area);
+		if (!WriteBytes(out, &count, sizeof(count))) return Failed(name);
+		if (area.IsPending(section)) {
+			std::span<const std::byte> data = area.GetLazyData(section);
+			return WriteBytes(out, data.data(), data.size()) || Failed(name);
+		}
+		// Missing paths are written blank.
+		auto& paths = getPaths(area);
+		NavEncounterPath blankPath{};
+		for (unsigned int pathIndex = 0u; pathIndex < count; pathIndex++)
 		{
-			unsigned int tmp;
-			if (buf.sgetn(reinterpret_cast<char*>(&tmp), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-				std::cerr << "NavArea::ReadData(): Could not read visible area count!\n";
-				return false;
-			}
-			visAreaCount = tmp;
-		}
-		if (visAreaCount.value() > 0){
-			visAreas.emplace(std::vector<NavVisibleArea>(visAreaCount.value()));
-			for (size_t i = 0; i < visAreaCount; i++)
-			{
-				if (!visAreas.value().at(i).ReadData(buf)) {
-					#ifndef NDEBUG
-					std::clog << "NavArea::ReadData(): Could not read visArea data!\n";
-					#endif
-					return false;
-				}
-			}
-		}
-		// Get InheritVisibilityFromAreaID.
-		if (buf.sgetn(reinterpret_cast<char*>(&InheritVisibilityFromAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-			std::clog << "NavArea::ReadData(): Could not read InheritVisibilityFromAreaID!\n";
-			return false;
+			NavEncounterPath& path = paths.has_value() && pathIndex < paths.value().size() ? paths.value()[pathIndex] : blankPath;
+			if (!path.WriteData(out)) return Failed(name);
 		}
+		return true;
 	}
-	// Create custom game data.
-	std::streampos customDataPos = buf.pubseekoff(0, std::ios_base::cur, std::ios_base::in);
-	customDataSize = getCustomDataSize(buf, MajorVersion, MinorVersion);
-	buf.pubseekpos(customDataPos, std::ios_base::in);
-	// Make room for custom data.
-	customData.clear();
-	customData.resize(customDataSize);
-	// Read custom data.
-	if (buf.sgetn(reinterpret_cast<char*>(customData.data()), customDataSize) != customDataSize) {
+
+	bool CustomData() {
+		return area.customDataSize == 0u || WriteBytes(out, area.customData.data(), area.customDataSize) || Failed("custom data");
+	}
+
+	private:
+	NavArea& area;
+	std::streambuf& out;
+
+	static bool Failed(const char* name) {
 		#ifndef NDEBUG
-		std::clog << "NavArea::ReadData(): Could not read custom data!\n";
+		std::cerr << "NavArea::WriteData(): Failed to write " << name << "!\n";
 		#endif
 		return false;
 	}
-	// Set area size
-	size = buf.pubseekoff(0, std::ios_base::cur) - startPos;
-	// Done.
-	return true;
-}
+};
 
-// Write the nav data into a stream.
-bool NavArea::WriteData(std::streambuf& out, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
-	if (out.sputn(reinterpret_cast<char*>(&ID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-		std::cerr << "NavArea::WriteData(): Could not write area ID!\n";
-		return false;
+// Counts the bytes the Encoder writes.
+class NavArea::Sizer {
+	public:
+	size_t size = 0u;
+
+	Sizer(const NavArea& area)
+	: area(area) {
 	}
-	if (MajorVersion < 8) {
-		unsigned char tmp = Flags;
-		if (out.sputc(Flags) == std::streambuf::traits_type::eof()) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write 8-bit attribute flag!\n";
-			#endif
-			return false;
-		}
+
+	template<typename Packed, typename Get>
+	bool Field(const char*, Get) {
+		size += sizeof(Packed);
+		return true;
 	}
-	else if (MajorVersion <= 13) {
-		unsigned short tmp = Flags;
-		if (out.sputn(reinterpret_cast<char*>(&tmp), VALVE_SHORT_SIZE) != VALVE_SHORT_SIZE) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write 16-bit attribute flag!\n";
-			#endif
-			return false;
-		}
+
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool Run(const char*, GetCount getCount, GetRecords) {
+		size += sizeof(Count) + static_cast<size_t>(getCount(area)) * NavRecordCodec<Record>::Size;
+		return true;
 	}
-	else if (out.sputn(reinterpret_cast<char*>(&Flags), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-		#ifndef NDEBUG
-		std::cerr << "NavArea::WriteData(): Failed to write 32-bit attribute flag!\n";
-		#endif
-		return false;
+
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool LazyRun(const char*, const LazySection& section, GetCount getCount, GetRecords) {
+		size += sizeof(Count) + (area.IsPending(section) ? area.GetLazyData(section).size() : static_cast<size_t>(PackField<Count>(getCount(area))) * NavRecordCodec<Record>::Size);
+		return true;
 	}
-	
-	// Write nwCorner corner vector.
-	for (size_t i = 0; i < nwCorner.size(); i++)
-	{
-		if (out.sputn(reinterpret_cast<char*>(nwCorner.data() + i), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write nwCorner["<<i<<"]!\n";
-			#endif
-			return false;
+
+	template<typename GetCount, typename GetPaths>
+	bool EncounterPaths(const char*, const LazySection& section, GetCount getCount, GetPaths getPaths) {
+		const unsigned int count = getCount(area);
+		size += sizeof(count);
+		if (area.IsPending(section)) {
+			size += area.GetLazyData(section).size();
+			return true;
+		}
+		const auto& paths = getPaths(area);
+		for (unsigned int pathIndex = 0u; pathIndex < count; pathIndex++)
+		{
+			size += ENCOUNTER_PATH_SIZE + VALVE_CHAR_SIZE;
+			if (paths.has_value() && pathIndex < paths.value().size()) size += paths.value()[pathIndex].spotCount * ENCOUNTER_SPOT_SIZE;
 		}
+		return true;
 	}
-	// Write seCorner corner vector.
-	for (size_t i = 0; i < seCorner.size(); i++)
-	{
-		if (out.sputn(reinterpret_cast<char*>(seCorner.data() + i), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write seCorner["<<i<<"]!\n";
-			#endif
-			return false;
-		}
+
+	bool CustomData() {
+		size += area.customDataSize;
+		return true;
 	}
-	
-	// Write NorthEastZ…
-	float tmp = NorthEastZ.value_or(0.0f);
-	if (out.sputn(reinterpret_cast<char*>(&tmp), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-		#ifndef NDEBUG
-		std::cerr << "NavArea::WriteData(): Failed to write NorthEast Z height!\n";
-		#endif
-		return false;
+
+	private:
+	const NavArea& area;
+};
+
+// Skips over area data, reading nothing but counts.
+template<typename Buffer>
+class NavArea::Skipper {
+	public:
+	// Bytes skipped so far.
+	size_t size = 0u;
+
+	Skipper(Buffer& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion)
+	: buf(buf), MajorVersion(MajorVersion), MinorVersion(MinorVersion) {
 	}
-	// …and SouthWestZ.
-	tmp = SouthWestZ.value_or(0.0f);
-	if (out.sputn(reinterpret_cast<char*>(&tmp), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-		#ifndef NDEBUG
-		std::cerr << "NavArea::WriteData(): Failed to write SouthWest Z height!\n";
-		#endif
-		return false;
+
+	template<typename Packed, typename Get>
+	bool Field(const char*, Get) {
+		return Skip(sizeof(Packed));
 	}
 
-	// Write connection data.
-	for (unsigned char currDirection = (char)Direction::North; currDirection < (char)Direction::Count; currDirection++)
-	{
-		if (out.sputn(reinterpret_cast<char*>(&connectionData[currDirection].first), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write conneciton count for direction "<<currDirection<<"!\n";
-			#endif
-			return false;
-		}
-		for (size_t i = 0; i < connectionData[currDirection].first; i++)
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool Run(const char*, GetCount, GetRecords) {
+		Count count;
+		return Read(count) && Skip(static_cast<size_t>(count) * NavRecordCodec<Record>::Size);
+	}
+
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool LazyRun(const char* name, const LazySection&, GetCount getCount, GetRecords getRecords) {
+		return Run<Record, Count>(name, getCount, getRecords);
+	}
+
+	template<typename GetCount, typename GetPaths>
+	bool EncounterPaths(const char*, const LazySection&, GetCount, GetPaths) {
+		unsigned int count;
+		if (!Read(count)) return false;
+		for (unsigned int pathIndex = 0u; pathIndex < count; pathIndex++)
 		{
-			if (!connectionData[currDirection].second[i].WriteData(out)) {
-				#ifndef NDEBUG
-				std::cerr << "NavArea::WriteData(): Failed to write connection data!\n";
-				#endif
-				return false;
-			}
+			unsigned char spotCount;
+			if (!Skip(ENCOUNTER_PATH_SIZE) || !Read(spotCount) || !Skip(spotCount * ENCOUNTER_SPOT_SIZE)) return false;
 		}
+		return true;
 	}
-	// Hiding spots
-	if (out.sputc(hideSpotData.first) == std::streambuf::traits_type::eof()) {
-		#ifndef NDEBUG
-		std::cerr << "NavArea::WriteData(): Failed to write hide spot count!\n";
-		#endif
-		return false;
+
+	bool CustomData() {
+		// The size is peeked from the data, so skip up to it first.
+		return Flush() && Skip(getCustomDataSize(buf, MajorVersion, MinorVersion)) && Flush();
 	}
-	for (size_t i = 0; i < hideSpotData.first; i++)
-	{
-		if (!hideSpotData.second[i].WriteData(out)) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write hide spot data!\n";
-			#endif
-			return false;
-		}
+
+	private:
+	Buffer& buf;
+	const unsigned int& MajorVersion;
+	const std::optional<unsigned int>& MinorVersion;
+	// Skips are gathered until something has to be read, so a run of fixed fields is skipped at once.
+	size_t pending = 0u;
+
+	bool Skip(const size_t& len) {
+		pending += len;
+		size += len;
+		return true;
 	}
-	// Approach spots are not in newer NAV versions.
-	if (MajorVersion < 15) {
-		if (out.sputc(approachSpotCount) == EOF) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write approach spot count!\n";
-			#endif
-			return false;
-		}
-		if (approachSpotData.has_value()) for (size_t i = 0; i < approachSpotCount; i++)
-		{
-			if (!approachSpotData.value()[i].WriteData(out)) {
-				#ifndef NDEBUG
-				std::cerr << "NavArea::WriteData(): Failed to write approach spot data!\n";
-				#endif
-				return false;
-			}
-		}
-		else for (size_t i = 0; i < approachSpotCount * APPROACH_SPOT_SIZE; i++)
-		{
-			NavApproachSpot sp;
-			if (!sp.WriteData(out)) {
-				#ifndef NDEBUG
-				std::cerr << "NavArea::WriteData(): Failed to write blank approach spot data!\n";
-				#endif
-				return false;
-			}
-		}
+
+	bool Flush() {
+		const size_t len = pending;
+		pending = 0u;
+		return SkipBytes(buf, len);
 	}
-	// Encounter Paths.
-	if (out.sputn(reinterpret_cast<char*>(&encounterPathCount), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-		#ifndef NDEBUG
-		std::cerr << "NavArea::WriteData(): Failed to write encounter path count!\n";
-		#endif
-		return false;
+
+	template<typename T>
+	bool Read(T& value) {
+		size += sizeof(T);
+		return Flush() && ReadBytes(buf, &value, sizeof(T));
 	}
-	if (encounterPaths.has_value()) for (size_t i = 0; i < encounterPathCount; i++)
-	{
-		if (!encounterPaths.value()[i].WriteData(out)) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write encounter path data!\n";
-			#endif
-			return false;
-		}
+};
+
+// Width of the values a field is made of.
+template<typename T>
+struct FieldWidth : std::integral_constant<size_t, sizeof(T)> {};
+template<typename T, size_t N>
+struct FieldWidth<std::array<T, N> > : std::integral_constant<size_t, sizeof(T)> {};
+
+// Swaps the byte order of area data in place, reading counts in whichever order they end up in the host's.
+class NavArea::Swapper {
+	public:
+	// Bytes swapped so far.
+	size_t size = 0u;
+
+	Swapper(std::span<std::byte> data, const bool& toHost, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion)
+	: data(data), toHost(toHost), MajorVersion(MajorVersion), MinorVersion(MinorVersion) {
 	}
 
-	// Write place ID.
-	if (out.sputn(reinterpret_cast<char*>(&PlaceID), VALVE_SHORT_SIZE) != VALVE_SHORT_SIZE) {
-		#ifndef NDEBUG
-		std::cerr << "NavArea::WriteData(): Failed to write place ID!\n";
-		#endif
-		return false;
+	template<typename Packed, typename Get>
+	bool Field(const char*, Get) {
+		return Swap(sizeof(Packed), FieldWidth<Packed>::value);
 	}
-	// Handle ladders
-	for (char i = 0; i < 2; i++)
-	{
-		// Ladder count
-		if (out.sputn(reinterpret_cast<char*>(&ladderData[i].first), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-			#ifndef NDEBUG
-			std::clog << "NavArea::WriteData(): Failed to write (direction "<<i<<") ladder count!\n";
-			#endif
-			return false;
-		}
-		// Data
-		if (ladderData[i].first > 0u) for (auto& ladderID : ladderData[i].second)
-		{
-			if (out.sputn(reinterpret_cast<char*>(&ladderID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-				#ifndef NDEBUG
-				std::clog << "NavArea::WriteData(): Failed to write (direction "<<i<<") ladder data!\n";
-				#endif
-				return false;
-			}
-		}
+
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool Run(const char*, GetCount, GetRecords) {
+		Count count;
+		if (!SwapCount(count)) return false;
+		const size_t runSize = static_cast<size_t>(count) * NavRecordCodec<Record>::Size;
+		if (!Flush() || runSize > data.size() - size) return false;
+		SwapRecordRun<Record>(data.subspan(size, runSize));
+		size += runSize;
+		return true;
 	}
-	// Occupy times
-	for (size_t i = 0u; i < EarliestOccupationTimes.size(); i++) 
-		if (out.sputn(reinterpret_cast<char*>(EarliestOccupationTimes.data() + i), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write occupation time for team "<<i<<" data!\n";
-			#endif
-			return false;
-		}
 
-	// Light intensity
-	if (MajorVersion >= 11) {
-		float nullval[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-		if (LightIntensity.has_value()) for (size_t i = 0; i < (char)Direction::Count; i++)
+	template<typename Record, typename Count, typename GetCount, typename GetRecords>
+	bool LazyRun(const char* name, const LazySection&, GetCount getCount, GetRecords getRecords) {
+		return Run<Record, Count>(name, getCount, getRecords);
+	}
+
+	template<typename GetCount, typename GetPaths>
+	bool EncounterPaths(const char*, const LazySection&, GetCount, GetPaths) {
+		unsigned int count;
+		if (!SwapCount(count)) return false;
+		for (unsigned int pathIndex = 0u; pathIndex < count; pathIndex++)
 		{
-			if (out.sputn(reinterpret_cast<char*>(LightIntensity.value().data() + i), VALVE_FLOAT_SIZE) != VALVE_FLOAT_SIZE) {
-				#ifndef NDEBUG
-				std::cerr << "NavArea::WriteData(): Failed to write light intensity for direction "<<i<<"!\n";
-				#endif
-				return false;
-			}
+			// FromAreaID, FromDirection, ToAreaID and ToDirection, then the spots.
+			unsigned char spotCount;
+			if (!Swap(VALVE_INT_SIZE, VALVE_INT_SIZE) || !Swap(VALVE_CHAR_SIZE, VALVE_CHAR_SIZE) || !Swap(VALVE_INT_SIZE, VALVE_INT_SIZE) || !Swap(VALVE_CHAR_SIZE, VALVE_CHAR_SIZE)
+			|| !SwapCount(spotCount) || !Flush() || static_cast<size_t>(spotCount) * ENCOUNTER_SPOT_SIZE > data.size() - size) return false;
+			SwapRecordRun<NavEncounterSpot>(data.subspan(size, spotCount * ENCOUNTER_SPOT_SIZE));
+			size += spotCount * ENCOUNTER_SPOT_SIZE;
 		}
-		// No LightIntensities recorded.
-		else if (out.sputn(reinterpret_cast<char*>(nullval), VALVE_FLOAT_SIZE * 4) != VALVE_FLOAT_SIZE * 4) {
-			#ifndef NDEBUG
-			std::cerr << "NavArea::WriteData(): Failed to write blank light intensities!\n";
-			#endif
-			return false;
+		return true;
+	}
+
+	bool CustomData() {
+		if (!Flush()) return false;
+		// The size only depends on single bytes, so it reads the same in either order.
+		NavBufferReader reader(data.subspan(size));
+		const size_t customSize = getCustomDataSize(reader, MajorVersion, MinorVersion);
+		if (customSize > data.size() - size) return false;
+		swapCustomData(data.subspan(size, customSize), MajorVersion, MinorVersion);
+		size += customSize;
+		return true;
+	}
+
+	// Swap the run of words gathered so far.
+	bool Flush() {
+		if (wordRun > 0u) SwapNavBytes(data.subspan(size - wordRun, wordRun), VALVE_INT_SIZE);
+		wordRun = 0u;
+		return true;
+	}
+
+	private:
+	std::span<std::byte> data;
+	bool toHost;
+	const unsigned int& MajorVersion;
+	const std::optional<unsigned int>& MinorVersion;
+	// Consecutive 4-byte fields are gathered, so they are swapped as one block.
+	size_t wordRun = 0u;
+
+	// Swap the next len bytes as width-byte values.
+	bool Swap(const size_t& len, const size_t& width) {
+		if (len > data.size() - size) return false;
+		if (width == VALVE_INT_SIZE) wordRun += len;
+		else {
+			Flush();
+			SwapNavBytes(data.subspan(size, len), width);
 		}
+		size += len;
+		return true;
 	}
 
-	// Visible areas
-	if (MajorVersion >= 16) {
+	// Swap the next value, and get it in the host's order.
+	template<typename T>
+	bool SwapCount(T& count) {
+		if (!Flush() || sizeof(T) > data.size() - size) return false;
+		std::span<std::byte> field = data.subspan(size, sizeof(T));
+		if (toHost) SwapNavBytes(field, sizeof(T));
+		std::memcpy(&count, field.data(), sizeof(T));
+		if (!toHost) SwapNavBytes(field, sizeof(T));
+		size += sizeof(T);
+		return true;
+	}
+};
+
+// Fill data from buffer. The buffer is only read forward, so it can be a pipe.
+// Returns true on success, false on failure.
+bool NavArea::ReadData(std::streambuf& source, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
+	// Count what is read to get the area's size.
+	NavCountingBuf buf(source);
+	ClearLazyData();
+	Decoder<std::streambuf> decoder(*this, buf, MajorVersion, MinorVersion);
+	if (!VisitData(MajorVersion, decoder)) return false;
+	// Set area size
+	size = buf.GetCount();
+	// Done.
+	return true;
+}
+
+// Fill data from NAV data in memory.
+// Returns true on success, false on failure.
+bool NavArea::ReadData(NavBufferReader& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
+	size_t startPos = buf.Tell();
+	ClearLazyData();
+	Decoder<NavBufferReader> decoder(*this, buf, MajorVersion, MinorVersion);
+	if (!VisitData(MajorVersion, decoder)) return false;
+	// Keep the raw data of the sections in one block, to be decoded on first access.
+	{
+		size_t lazySize = 0u;
+		for (const auto& section : decoder.sections) lazySize += section.size();
+		lazyData.resize(lazySize);
+		for (size_t i = 0u; i < decoder.sections.size(); i++)
 		{
-			unsigned int tmp = visAreaCount.value_or(0);
-			if (out.sputn(reinterpret_cast<char*>(&tmp), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-				std::cerr << "NavArea::WriteData(): Failed to write visibility area count!\n";
-				return false;
-			}
-		}
-		if (visAreaCount.value_or(0) > 0) {
-			if (visAreas.has_value()) {
-				for (auto &&VisArea : visAreas.value())
-				{
-					if (!VisArea.WriteData(out)) {
-						std::cerr << "NavArea::WriteData(): Failed to write visArea data!\n";
-						return false;
-					}
-				}
-			}
-			// visAreas vector is not set, so write blanks.
-			else for (size_t i = 0; i < visAreaCount; i++)
-			{
-				NavVisibleArea visArea;
-				visArea.Attributes = 0;
-				visArea.VisibleAreaID = 0u;
-				if (!visArea.WriteData(out)) {
-					std::cerr << "NavArea::WriteData(): Failed to write blank visArea data!\n";
-					return false;
-				}
-			}
+			lazyBounds[i + 1u] = lazyBounds[i] + decoder.sections[i].size();
+			if (decoder.sections[i].empty()) continue;
+			std::memcpy(lazyData.data() + lazyBounds[i], decoder.sections[i].data(), decoder.sections[i].size());
+			lazyPending |= 1u << i;
 		}
 	}
-	// Try to write InheritVisibilityFromAreaID.
-	if (out.sputn(reinterpret_cast<char*>(&InheritVisibilityFromAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
-		std::cerr << "NavArea::WriteData(): Failed to write InheritVisibilityFromAreaID!\n";
-		return false;
-	}
-	// Write custom data.
-	if (customDataSize > 0 && out.sputn(reinterpret_cast<char*>(customData.data()), customDataSize) != customDataSize) {
-		std::cerr << "NavArea::WriteData(): Failed to write custom data!\n";
-		return false;
-	}
+	// Set area size
+	size = buf.Tell() - startPos;
+	// Done.
 	return true;
 }
 
+// Skip over the data of an area in a stream, which is only read forward.
+// Returns data length of the area, nothing if the data is cut short.
+std::optional<size_t> NavArea::SkipData(std::streambuf& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
+	Skipper<std::streambuf> skipper(buf, MajorVersion, MinorVersion);
+	if (!VisitData(MajorVersion, skipper)) return {};
+	return skipper.size;
+}
+
+// Skip over the data of an area in memory.
+// Returns data length of the area, nothing if the data is cut short.
+std::optional<size_t> NavArea::SkipData(NavBufferReader& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
+	Skipper<NavBufferReader> skipper(buf, MajorVersion, MinorVersion);
+	if (!VisitData(MajorVersion, skipper)) return {};
+	return skipper.size;
+}
+
+// Swap the byte order of the area data at the start of data in place: to the host's if toHost is true, from it otherwise.
+// Returns data length of the area, nothing if the data is cut short.
+std::optional<size_t> NavArea::SwapByteOrder(std::span<std::byte> data, const bool& toHost, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
+	Swapper swapper(data, toHost, MajorVersion, MinorVersion);
+	if (!VisitData(MajorVersion, swapper) || !swapper.Flush()) return {};
+	return swapper.size;
+}
+
+// Mark the area as changed since it was read, so saving encodes it again instead of copying its old data.
+void NavArea::MarkDirty() {
+	SourceOffset.reset();
+}
+
+bool NavArea::IsDirty() const {
+	return !SourceOffset.has_value();
+}
+
+std::pair<unsigned char, std::pmr::vector<NavHideSpot> >& NavArea::GetHideSpotData() {
+	DecodeSection(LazySection::HideSpots);
+	return hideSpotData;
+}
+
+std::optional<std::pmr::vector<NavApproachSpot> >& NavArea::GetApproachSpotData() {
+	DecodeSection(LazySection::ApproachSpots);
+	return approachSpotData;
+}
+
+std::optional<std::pmr::vector<NavEncounterPath> >& NavArea::GetEncounterPaths() {
+	DecodeSection(LazySection::EncounterPaths);
+	return encounterPaths;
+}
+
+std::optional<std::pmr::vector<NavVisibleArea> >& NavArea::GetVisAreas() {
+	DecodeSection(LazySection::VisAreas);
+	return visAreas;
+}
+
+// The resource the area's containers allocate from.
+std::pmr::memory_resource* NavArea::GetMemoryResource() const {
+	return customData.get_allocator().resource();
+}
+
+// Decode every section that hasn't been decoded yet.
+// Returns true on success, false on failure.
+bool NavArea::DecodeSections() {
+	bool success = true;
+	for (unsigned char i = 0u; i < static_cast<unsigned char>(LazySection::Count); i++) success = DecodeSection(static_cast<LazySection>(i)) && success;
+	return success;
+}
+
+bool NavArea::IsPending(const LazySection& section) const {
+	return lazyPending & (1u << static_cast<unsigned char>(section));
+}
+
+// Raw data of a pending section.
+std::span<const std::byte> NavArea::GetLazyData(const LazySection& section) const {
+	const size_t i = static_cast<size_t>(section);
+	return std::span<const std::byte>(lazyData).subspan(lazyBounds[i], lazyBounds[i + 1u] - lazyBounds[i]);
+}
+
+// Decode a section if it is pending.
+// Returns true on success, false on failure.
+bool NavArea::DecodeSection(const LazySection& section) {
+	if (!IsPending(section)) return true;
+	std::span<const std::byte> data = GetLazyData(section);
+	bool success = true;
+	switch (section)
+	{
+		// Record counts come from the raw data, in case the count field was changed first.
+		case LazySection::HideSpots:
+			DecodeRecordRun<NavHideSpot>(data, data.size() / HIDE_SPOT_SIZE, hideSpotData.second);
+			break;
+		case LazySection::ApproachSpots:
+			approachSpotData.emplace(GetMemoryResource());
+			DecodeRecordRun<NavApproachSpot>(data, data.size() / APPROACH_SPOT_SIZE, approachSpotData.value());
+			break;
+		case LazySection::EncounterPaths:
+		{
+			NavBufferReader reader(data);
+			encounterPaths.emplace(GetMemoryResource());
+			// Each path takes up at least its fixed part, which bounds a corrupt count.
+			encounterPaths.value().reserve(std::min<size_t>(encounterPathCount, data.size() / (ENCOUNTER_PATH_SIZE + VALVE_CHAR_SIZE)));
+			while (success && reader.Remaining() > 0u) success = encounterPaths.value().emplace_back().ReadData(reader);
+			break;
+		}
+		case LazySection::VisAreas:
+			visAreas.emplace(GetMemoryResource());
+			DecodeRecordRun<NavVisibleArea>(data, data.size() / VISIBLE_AREA_SIZE, visAreas.value());
+			break;
+		default:
+			break;
+	}
+	#ifndef NDEBUG
+	if (!success) std::clog << "NavArea::DecodeSection(): Could not decode section " << static_cast<int>(section) << " of area #" << ID << "!\n";
+	#endif
+	lazyPending &= ~(1u << static_cast<unsigned char>(section));
+	// Everything is decoded, so the raw data isn't needed anymore.
+	if (lazyPending == 0u) ClearLazyData();
+	return success;
+}
+
+// Drop any undecoded sections.
+void NavArea::ClearLazyData() {
+	lazyPending = 0u;
+	lazyBounds = {};
+	lazyData.clear();
+	lazyData.shrink_to_fit();
+}
+
+// Get the fewest bytes the data of an area can take up: every field, and no records.
+size_t NavArea::GetMinDataSize(const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
+	NavArea area;
+	area.customDataSize = getCustomDataSize(MajorVersion, MinorVersion);
+	return area.GetDataSize(MajorVersion, MinorVersion);
+}
+
+// Get the exact number of bytes WriteData() writes for this area.
+size_t NavArea::GetDataSize(const unsigned int& MajorVersion, const std::optional<unsigned int>&) const {
+	Sizer sizer(*this);
+	VisitData(MajorVersion, sizer);
+	return sizer.size;
+}
+
+// Write the nav data into a stream.
+bool NavArea::WriteData(std::streambuf& out, const unsigned int& MajorVersion, const std::optional<unsigned int>&) {
+	Encoder encoder(*this, out);
+	return VisitData(MajorVersion, encoder);
+}
+
 std::optional<bool> NavArea::hasSameNAVData(const NavArea& rhs, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
 	std::stringstream leftVal, rightVal;
 	if (!WriteData(*leftVal.rdbuf(), MajorVersion, MinorVersion)) {
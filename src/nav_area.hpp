@@ -5,6 +5,10 @@
 #include <memory>
 #include <vector>
 #include <any>
+#include <array>
+#include <span>
+#include <cstddef>
+#include <memory_resource>
 #ifndef NAV_AREA_HPP
 #define NAV_AREA_HPP
 #include "nav_connections.hpp"
@@ -20,9 +24,21 @@ class NavEncounterPath;
 class NavArea {
 	public:
 
+	NavArea() = default;
+	// Area whose containers allocate from resource (such as a NavFile's arena).
+	// Copies of the area allocate from the default resource again.
+	explicit NavArea(std::pmr::memory_resource* resource);
+	NavArea(const NavArea&) = default;
+	// Moved areas keep their resource, so shifting areas in their container doesn't copy their data.
+	// Moving can't throw (checked in nav_area.cpp), so a growing area container moves its areas instead of copying them.
+	NavArea(NavArea&&) = default;
+	NavArea& operator=(const NavArea&) = default;
+	NavArea& operator=(NavArea&&) = default;
 	~NavArea();
 	// Total size (in bytes)
 	size_t size = 0u;
+	// Where the area data was read from in the file. Unset once the area is changed (or if it is new).
+	std::optional<size_t> SourceOffset;
 	/* Nav Area data */
 	IntID ID = 0u;// ID of the NavArea. 
 	unsigned int Flags; // Attributes set on this area.
@@ -31,46 +47,122 @@ class NavArea {
 	std::optional<float> NorthEastZ, SouthWestZ; // The Z-coord for the north-east and south-west corners.
 	std::optional<std::array<float, 4> > LightIntensity; // The light intensity of the corners (NESW).
 	// Amount of connections and the connection data in each direction (NESW).
-	std::array<std::pair<unsigned int, std::vector<NavConnection> >, 4> connectionData = {
-		std::make_pair(0, std::vector<NavConnection>()), 
-		std::make_pair(0, std::vector<NavConnection>()), 
-		std::make_pair(0, std::vector<NavConnection>()), 
-		std::make_pair(0, std::vector<NavConnection>())}; 
+	std::array<std::pair<unsigned int, std::pmr::vector<NavConnection> >, 4> connectionData = {
+		std::make_pair(0, std::pmr::vector<NavConnection>()), 
+		std::make_pair(0, std::pmr::vector<NavConnection>()), 
+		std::make_pair(0, std::pmr::vector<NavConnection>()), 
+		std::make_pair(0, std::pmr::vector<NavConnection>())}; 
 	unsigned short PlaceID = 0; // The ID of the place this area is in.
 	/*	[1] - Amount of hide spots. 
 		[2] - Container
 	*/
-	std::pair<unsigned char, std::vector<NavHideSpot> > hideSpotData; 
+	std::pair<unsigned char, std::pmr::vector<NavHideSpot> > hideSpotData; 
 	// Approach spot count (removed in MVer 15)
 	unsigned char approachSpotCount = 0u; 
-	std::optional<std::vector<NavApproachSpot> > approachSpotData; // Approach spot container (removed in MVer 15)
+	std::optional<std::pmr::vector<NavApproachSpot> > approachSpotData; // Approach spot container (removed in MVer 15)
 	/*
 		@brief Container for ladder data.
 		Stores 2 (Directions) of pairs that store the ladder count and ladder data respectively.
 	*/
-	std::array<std::pair<unsigned int, std::list<IntID> >, 2> ladderData;
+	std::array<std::pair<unsigned int, std::pmr::list<IntID> >, 2> ladderData;
 	unsigned int encounterPathCount = 0u; // Amount of encounter paths.
-	std::optional<std::deque<NavEncounterPath> > encounterPaths;
+	std::optional<std::pmr::vector<NavEncounterPath> > encounterPaths;
 	std::array<float, 2> EarliestOccupationTimes = {0.0f, 0.0f}; // The earliest time teams can occupy this area
 
 	std::optional<unsigned int> visAreaCount; // <----- Introduced in major version 16.
-	std::optional<std::vector<NavVisibleArea> > visAreas; // Amount of vis areas.
+	std::optional<std::pmr::vector<NavVisibleArea> > visAreas; // Amount of vis areas.
 	unsigned int InheritVisibilityFromAreaID = 0u; // ID of the area to inherit our visibility from*/
 
 	// Game-specific datum count
 	size_t customDataSize = 0u;
 	// Game-specific data.
-	std::vector<unsigned char> customData;
+	std::pmr::vector<unsigned char> customData;
 	// Funcs
 	void OutputData(std::ostream& ostream) const;
 
+	// Mark the area as changed since it was read, so saving encodes it again instead of copying its old data.
+	void MarkDirty();
+	bool IsDirty() const;
+
+	// Get the exact number of bytes WriteData() writes for this area.
+	size_t GetDataSize(const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) const;
+	// Get the fewest bytes the data of an area can take up: every field, and no records.
+	static size_t GetMinDataSize(const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
+
 	// Write data to stream.
 	// Returns true if successful, false on failure.
 	bool WriteData(std::streambuf& out, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
 
 	// Fills data from stream.
 	bool ReadData(std::streambuf& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
+	// Fills data from NAV data in memory.
+	bool ReadData(NavBufferReader& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
+
+	// Skip over the data of an area, decoding nothing but counts.
+	// Returns data length of the area, nothing if the data is cut short.
+	static std::optional<size_t> SkipData(std::streambuf& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
+	static std::optional<size_t> SkipData(NavBufferReader& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
+	// Swap the byte order of the area data at the start of data in place: to the host's if toHost is true, from it otherwise.
+	// Returns data length of the area, nothing if the data is cut short.
+	static std::optional<size_t> SwapByteOrder(std::span<std::byte> data, const bool& toHost, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
 
 	std::optional<bool> hasSameNAVData(const NavArea& rhs, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
+
+	/*
+		Hide spots, approach spots, encounter paths and visible areas are not decoded when reading from memory.
+		Their counts are, but the containers stay empty until the section is first accessed through one of these.
+		Unchanged sections are written back from their raw data.
+	*/
+	std::pair<unsigned char, std::pmr::vector<NavHideSpot> >& GetHideSpotData();
+	std::optional<std::pmr::vector<NavApproachSpot> >& GetApproachSpotData();
+	std::optional<std::pmr::vector<NavEncounterPath> >& GetEncounterPaths();
+	std::optional<std::pmr::vector<NavVisibleArea> >& GetVisAreas();
+	// The resource the area's containers allocate from.
+	std::pmr::memory_resource* GetMemoryResource() const;
+	// Decode every section that hasn't been decoded yet.
+	// Returns true on success, false on failure.
+	bool DecodeSections();
+
+	private:
+	// Sections that are decoded on first access.
+	enum class LazySection : unsigned char {
+		HideSpots,
+		ApproachSpots,
+		EncounterPaths,
+		VisAreas,
+		Count
+	};
+	// Raw data of the sections that haven't been decoded yet, back to back.
+	std::pmr::vector<std::byte> lazyData;
+	// Where each section starts in lazyData (the last entry is the end).
+	std::array<unsigned int, static_cast<size_t>(LazySection::Count) + 1u> lazyBounds = {};
+	// Bit set of the sections still in lazyData.
+	unsigned char lazyPending = 0u;
+
+	bool IsPending(const LazySection& section) const;
+	// Raw data of a pending section.
+	std::span<const std::byte> GetLazyData(const LazySection& section) const;
+	// Decode a section if it is pending.
+	// Returns true on success, false on failure.
+	bool DecodeSection(const LazySection& section);
+	// Drop any undecoded sections.
+	void ClearLazyData();
+
+	/*
+		The fields of area data in one NAV major version, in file order.
+		Reading, writing, skipping and sizing all walk this schema with their own visitor.
+	*/
+	template<unsigned int MajorVersion, typename Visitor>
+	static bool VisitSchema(Visitor& visitor);
+	// Walk the schema of MajorVersion with visitor.
+	// Returns true if every field was visited, false if the visitor failed.
+	template<typename Visitor>
+	static bool VisitData(const unsigned int& MajorVersion, Visitor& visitor);
+	// Schema visitors.
+	template<typename Buffer> class Decoder;
+	class Encoder;
+	class Sizer;
+	template<typename Buffer> class Skipper;
+	class Swapper;
 };
 #endif
\ No newline at end of file
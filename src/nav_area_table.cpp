@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "nav_area_table.hpp"
+
+// Fill the table from areas, replacing its contents.
+void NavAreaTable::Build(const std::vector<NavArea>& areas) {
+	const size_t count = areas.size();
+	IDs.resize(count);
+	Flags.resize(count);
+	for (unsigned char axis = 0u; axis < 3u; axis++)
+	{
+		nwCorner[axis].resize(count);
+		seCorner[axis].resize(count);
+	}
+	NorthEastZ.resize(count);
+	SouthWestZ.resize(count);
+	PlaceIDs.resize(count);
+	connectionTargets.clear();
+	connectionOffsets.resize(count * static_cast<size_t>(Direction::Count) + 1u);
+	// Size the pool once.
+	size_t connectionCount = 0u;
+	for (const NavArea& area : areas) for (const auto& connections : area.connectionData) connectionCount += connections.second.size();
+	connectionTargets.reserve(connectionCount);
+
+	for (size_t i = 0u; i < count; i++)
+	{
+		const NavArea& area = areas[i];
+		IDs[i] = area.ID;
+		Flags[i] = area.Flags;
+		for (unsigned char axis = 0u; axis < 3u; axis++)
+		{
+			nwCorner[axis][i] = area.nwCorner[axis];
+			seCorner[axis][i] = area.seCorner[axis];
+		}
+		NorthEastZ[i] = area.NorthEastZ.value_or(area.nwCorner[2]);
+		SouthWestZ[i] = area.SouthWestZ.value_or(area.seCorner[2]);
+		PlaceIDs[i] = area.PlaceID;
+		for (unsigned char direction = 0u; direction < static_cast<unsigned char>(Direction::Count); direction++)
+		{
+			connectionOffsets[i * static_cast<size_t>(Direction::Count) + direction] = connectionTargets.size();
+			for (const NavConnection& connection : area.connectionData[direction].second) connectionTargets.push_back(connection.TargetAreaID);
+		}
+	}
+	connectionOffsets.back() = connectionTargets.size();
+}
+
+/* Write the columns back into areas, which must be the container the table was built from.
+Connections aren't written back. Areas that changed are marked dirty.
+Returns true on success, false if areas doesn't match the table. */
+bool NavAreaTable::Apply(std::vector<NavArea>& areas) const {
+	if (areas.size() != size()) return false;
+	for (size_t i = 0u; i < areas.size(); i++)
+	{
+		NavArea& area = areas[i];
+		bool changed = area.ID != IDs[i] || area.Flags != Flags[i] || area.PlaceID != PlaceIDs[i]
+			|| area.NorthEastZ.value_or(area.nwCorner[2]) != NorthEastZ[i] || area.SouthWestZ.value_or(area.seCorner[2]) != SouthWestZ[i];
+		for (unsigned char axis = 0u; axis < 3u; axis++) changed = changed || area.nwCorner[axis] != nwCorner[axis][i] || area.seCorner[axis] != seCorner[axis][i];
+		if (!changed) continue;
+		area.ID = IDs[i];
+		area.Flags = Flags[i];
+		for (unsigned char axis = 0u; axis < 3u; axis++)
+		{
+			area.nwCorner[axis] = nwCorner[axis][i];
+			area.seCorner[axis] = seCorner[axis][i];
+		}
+		area.NorthEastZ = NorthEastZ[i];
+		area.SouthWestZ = SouthWestZ[i];
+		area.PlaceID = PlaceIDs[i];
+		area.MarkDirty();
+	}
+	return true;
+}
+
+// Number of areas.
+size_t NavAreaTable::size() const {
+	return IDs.size();
+}
+
+// Connection target IDs of the area at index in direction.
+std::span<const IntID> NavAreaTable::GetConnections(const size_t& index, const Direction& direction) const {
+	const size_t offsetIndex = index * static_cast<size_t>(Direction::Count) + static_cast<size_t>(direction);
+	return std::span<const IntID>(connectionTargets).subspan(connectionOffsets[offsetIndex], connectionOffsets[offsetIndex + 1u] - connectionOffsets[offsetIndex]);
+}
+
+// Get the bounds of the area at index.
+NavBounds NavAreaTable::GetAreaBounds(const size_t& index) const {
+	NavBounds bounds;
+	for (unsigned char axis = 0u; axis < 3u; axis++)
+	{
+		bounds.Min[axis] = std::min(nwCorner[axis][index], seCorner[axis][index]);
+		bounds.Max[axis] = std::max(nwCorner[axis][index], seCorner[axis][index]);
+	}
+	// The other two corners can be higher or lower.
+	bounds.Min[2] = std::min({bounds.Min[2], NorthEastZ[index], SouthWestZ[index]});
+	bounds.Max[2] = std::max({bounds.Max[2], NorthEastZ[index], SouthWestZ[index]});
+	return bounds;
+}
+
+// Get the bounds of all areas.
+// Returns nothing if the table is empty.
+std::optional<NavBounds> NavAreaTable::GetBounds() const {
+	if (size() == 0u) return {};
+	NavBounds bounds;
+	bounds.Min.fill(std::numeric_limits<float>::max());
+	bounds.Max.fill(std::numeric_limits<float>::lowest());
+	// One pass per column.
+	auto extend = [&bounds](const NavColumn<float>& column, const unsigned char& axis) {
+		auto [minIt, maxIt] = std::minmax_element(column.begin(), column.end());
+		bounds.Min[axis] = std::min(bounds.Min[axis], *minIt);
+		bounds.Max[axis] = std::max(bounds.Max[axis], *maxIt);
+	};
+	for (unsigned char axis = 0u; axis < 3u; axis++)
+	{
+		extend(nwCorner[axis], axis);
+		extend(seCorner[axis], axis);
+	}
+	extend(NorthEastZ, 2u);
+	extend(SouthWestZ, 2u);
+	return bounds;
+}
+
+// Get the indices of the areas that overlap bounds.
+std::vector<size_t> NavAreaTable::FindInBounds(const NavBounds& bounds) const {
+	// Test every area without branching first, so the loop vectorizes.
+	const size_t count = size();
+	std::vector<unsigned char> overlaps(count, 1u);
+	for (unsigned char axis = 0u; axis < 2u; axis++)
+	{
+		const float* nw = nwCorner[axis].data();
+		const float* se = seCorner[axis].data();
+		const float boundsMin = bounds.Min[axis], boundsMax = bounds.Max[axis];
+		for (size_t i = 0u; i < count; i++) overlaps[i] &= (std::max(nw[i], se[i]) >= boundsMin) & (std::min(nw[i], se[i]) <= boundsMax);
+	}
+	{
+		const float* nw = nwCorner[2].data();
+		const float* se = seCorner[2].data();
+		const float* ne = NorthEastZ.data();
+		const float* sw = SouthWestZ.data();
+		const float boundsMin = bounds.Min[2], boundsMax = bounds.Max[2];
+		for (size_t i = 0u; i < count; i++)
+		{
+			const float areaMin = std::min(std::min(nw[i], se[i]), std::min(ne[i], sw[i]));
+			const float areaMax = std::max(std::max(nw[i], se[i]), std::max(ne[i], sw[i]));
+			overlaps[i] &= (areaMax >= boundsMin) & (areaMin <= boundsMax);
+		}
+	}
+	std::vector<size_t> found;
+	for (size_t i = 0u; i < count; i++) if (overlaps[i]) found.push_back(i);
+	return found;
+}
+
+// Move every area by offset.
+void NavAreaTable::Translate(const std::array<float, 3>& offset) {
+	for (unsigned char axis = 0u; axis < 3u; axis++)
+	{
+		for (float& value : nwCorner[axis]) value += offset[axis];
+		for (float& value : seCorner[axis]) value += offset[axis];
+	}
+	for (float& value : NorthEastZ) value += offset[2];
+	for (float& value : SouthWestZ) value += offset[2];
+}
+
+// Scale every area by factor, about origin.
+void NavAreaTable::Scale(const std::array<float, 3>& origin, const float& factor) {
+	for (unsigned char axis = 0u; axis < 3u; axis++)
+	{
+		const float base = origin[axis] * (1.0f - factor);
+		for (float& value : nwCorner[axis]) value = value * factor + base;
+		for (float& value : seCorner[axis]) value = value * factor + base;
+	}
+	const float baseZ = origin[2] * (1.0f - factor);
+	for (float& value : NorthEastZ) value = value * factor + baseZ;
+	for (float& value : SouthWestZ) value = value * factor + baseZ;
+}
+
+// Get totals over the areas.
+NavAreaStats NavAreaTable::GetStats() const {
+	NavAreaStats stats;
+	stats.AreaCount = size();
+	stats.ConnectionCount = connectionTargets.size();
+	if (stats.AreaCount == 0u) return stats;
+	stats.MinSize = std::numeric_limits<float>::max();
+	stats.MaxSize = 0.0f;
+	for (size_t i = 0u; i < stats.AreaCount; i++)
+	{
+		const float areaSize = std::abs(seCorner[0][i] - nwCorner[0][i]) * std::abs(seCorner[1][i] - nwCorner[1][i]);
+		stats.TotalSize += areaSize;
+		stats.MinSize = std::min(stats.MinSize, areaSize);
+		stats.MaxSize = std::max(stats.MaxSize, areaSize);
+	}
+	return stats;
+}
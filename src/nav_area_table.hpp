@@ -0,0 +1,94 @@
+#ifndef NAV_AREA_TABLE_HPP
+#define NAV_AREA_TABLE_HPP
+#include <vector>
+#include <array>
+#include <span>
+#include <new>
+#include <optional>
+#include "nav_base.hpp"
+#include "nav_area.hpp"
+// Alignment of table columns (in bytes), so vectorized passes start on a cache line.
+#define NAV_COLUMN_ALIGNMENT 64u
+
+// Allocator for aligned column storage.
+template<typename T>
+struct NavColumnAllocator {
+	using value_type = T;
+	NavColumnAllocator() = default;
+	template<typename U>
+	NavColumnAllocator(const NavColumnAllocator<U>&) {}
+
+	T* allocate(const size_t& n) {
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(NAV_COLUMN_ALIGNMENT)));
+	}
+	void deallocate(T* p, const size_t&) {
+		::operator delete(p, std::align_val_t(NAV_COLUMN_ALIGNMENT));
+	}
+	template<typename U>
+	bool operator==(const NavColumnAllocator<U>&) const { return true; }
+};
+
+template<typename T>
+using NavColumn = std::vector<T, NavColumnAllocator<T> >;
+
+// Axis-aligned bounding box.
+struct NavBounds {
+	std::array<float, 3> Min = {0.0f, 0.0f, 0.0f}, Max = {0.0f, 0.0f, 0.0f};
+};
+
+// Totals over the areas of a table.
+struct NavAreaStats {
+	size_t AreaCount = 0u, ConnectionCount = 0u;
+	// 2D footprint (X by Y) of the areas.
+	double TotalSize = 0.0;
+	float MinSize = 0.0f, MaxSize = 0.0f;
+};
+
+/*
+	Columnar copy of the hot area fields.
+	IDs, flags, corners, NE/SW Z and place IDs each get a contiguous, aligned array (corners get one per axis),
+	so passes over every area run over packed floats instead of going through NavArea objects.
+	Connection target IDs of all areas share one pooled buffer.
+	Build() fills the table from an area container, Apply() writes changes back.
+*/
+class NavAreaTable {
+	public:
+		NavColumn<IntID> IDs;
+		NavColumn<unsigned int> Flags;
+		// Corners, one column per axis.
+		std::array<NavColumn<float>, 3> nwCorner, seCorner;
+		// Z of the other two corners. Versions that don't store them use the north-west and south-east Z, as libnav does.
+		NavColumn<float> NorthEastZ, SouthWestZ;
+		NavColumn<unsigned short> PlaceIDs;
+		// Connection target IDs of every area, by area and then direction.
+		std::vector<IntID> connectionTargets;
+		// Where the connections of area i in direction d start in connectionTargets: [i * Direction::Count + d].
+		// The last entry is the end.
+		std::vector<unsigned int> connectionOffsets;
+
+		// Fill the table from areas, replacing its contents.
+		void Build(const std::vector<NavArea>& areas);
+		/* Write the columns back into areas, which must be the container the table was built from.
+		   Connections aren't written back. Areas that changed are marked dirty.
+		   Returns true on success, false if areas doesn't match the table. */
+		bool Apply(std::vector<NavArea>& areas) const;
+		// Number of areas.
+		size_t size() const;
+		// Connection target IDs of the area at index in direction.
+		std::span<const IntID> GetConnections(const size_t& index, const Direction& direction) const;
+
+		// Get the bounds of the area at index.
+		NavBounds GetAreaBounds(const size_t& index) const;
+		// Get the bounds of all areas.
+		// Returns nothing if the table is empty.
+		std::optional<NavBounds> GetBounds() const;
+		// Get the indices of the areas that overlap bounds.
+		std::vector<size_t> FindInBounds(const NavBounds& bounds) const;
+		// Move every area by offset.
+		void Translate(const std::array<float, 3>& offset);
+		// Scale every area by factor, about origin.
+		void Scale(const std::array<float, 3>& origin, const float& factor);
+		// Get totals over the areas.
+		NavAreaStats GetStats() const;
+};
+#endif
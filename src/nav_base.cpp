@@ -3,6 +3,8 @@
 #include <map>
 #include <regex>
 #include "nav_base.hpp"
+#include "nav_codec.hpp"
+#include "nav_custom_data.hpp"
 
 // Map between Direction and string.
 std::map<Direction, std::string> directionToStr = {
@@ -25,13 +27,14 @@ std::map<std::string, Direction> strToDirection = {
 */
 // Get Engine Version from Major and Minor version.
 EngineVersion GetAsEngineVersion(const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVer) {
-
-	
+	// Games tell their data apart by sub version.
 	if (MajorVersion == 16) {
 		// Team Fortress 2
-		if (MinorVer == 2) return EngineVersion::TEAM_FORTRESS_2;
+		if (MinorVer == 2u) return EngineVersion::TEAM_FORTRESS_2;
 		// CS:GO
-		else return EngineVersion::COUNTER_STRIKE_GLOBAL_OFFENSIVE;
+		if (MinorVer == 1u) return EngineVersion::COUNTER_STRIKE_GLOBAL_OFFENSIVE;
+		// Left 4 Dead 2
+		if (MinorVer == 14u) return EngineVersion::LEFT_4_DEAD_2;
 	}
 	
 	return EngineVersion::DEFAULT;
@@ -39,79 +42,49 @@ EngineVersion GetAsEngineVersion(const unsigned int& MajorVersion, const std::op
 
 // get the minimum custom data length (in bytes) possible
 std::size_t getCustomDataSize(const unsigned int& version, const std::optional<unsigned int>& subversion) {
-	switch (GetAsEngineVersion(version, subversion))
-	{
-	// Team Fortress 2 data:
-	// TFAttributes (4-byte).
-	case EngineVersion::TEAM_FORTRESS_2:
-		return VALVE_INT_SIZE;
-		break;
-
-	// Subversion stores approach spots in custom data.
-	case EngineVersion::COUNTER_STRIKE_GLOBAL_OFFENSIVE:
-		{
-			// Approach spot count (which is a byte).
-			return VALVE_CHAR_SIZE;
-		}
-		break;
-	// Left 4 Dead has a ton of custom data in pre data AND post data.
-	// Will implement that latter.
-	case EngineVersion::LEFT_4_DEAD:
-	default:
-		return 0u;
-		break;
-	}
-	return 0u;
+	return GetCustomDataCodec(version, subversion).AreaMinSize;
 }
 
 // get the custom data length (in bytes) from a NAV file.
+// Only peeks at the data, so streams never have to seek back.
 std::size_t getCustomDataSize(std::streambuf& buf, const unsigned int& version, const std::optional<unsigned int>& subversion) {
-	switch (GetAsEngineVersion(version, subversion))
-	{
-	// Team Fortress 2 data:
-	// TFAttributes (4-byte).
-	case EngineVersion::TEAM_FORTRESS_2:
-		return 4u;
-		break;
-
-	// Subversion stores approach spots in custom data.
-	case EngineVersion::COUNTER_STRIKE_GLOBAL_OFFENSIVE:
-		{
-			if (subversion.value_or(0u) == 1u)
-			{
-				unsigned char approachSpotCount;
-				if (buf.sgetc() == EOF) {
-					std::clog << "fatal: Failed to get approach spot count in custom data.";
-					return 0u;
-				}
-				else approachSpotCount = buf.sbumpc();
-				// The approach spot count and approach spot data.
-				return VALVE_CHAR_SIZE + (approachSpotCount * APPROACH_SPOT_SIZE);
-			}
-			return 0u;
-		}
-		break;
-	// Left 4 Dead has a ton of custom data in pre data AND post data.
-	case EngineVersion::LEFT_4_DEAD:
-	default:
-		return 0u;
-		break;
-	}
-	return 0u;
+	const NavCustomDataCodec& codec = GetCustomDataCodec(version, subversion);
+	if (!codec.AreaSize) return codec.AreaMinSize;
+	const std::streambuf::int_type first = buf.sgetc();
+	// Reading the data fails at the end of it anyway.
+	if (first == std::streambuf::traits_type::eof()) return codec.AreaMinSize;
+	return codec.AreaSize(static_cast<unsigned char>(first));
+}
+
+// get the custom data length (in bytes) from NAV data in memory.
+// Like the streambuf version, this only peeks at the data.
+std::size_t getCustomDataSize(const NavBufferReader& buf, const unsigned int& version, const std::optional<unsigned int>& subversion) {
+	const NavCustomDataCodec& codec = GetCustomDataCodec(version, subversion);
+	if (!codec.AreaSize) return codec.AreaMinSize;
+	const std::optional<unsigned char> first = buf.Peek();
+	if (!first.has_value()) return codec.AreaMinSize;
+	return codec.AreaSize(first.value());
+}
+
+// Swap the byte order of an area's custom data in place.
+// Custom data of games whose layout isn't known is left as it is.
+void swapCustomData(std::span<std::byte> data, const unsigned int& version, const std::optional<unsigned int>& subversion) {
+	const NavCustomDataCodec& codec = GetCustomDataCodec(version, subversion);
+	if (codec.SwapArea) codec.SwapArea(data);
 }
 
 // Get the ideal attribute flag size (in bytes) of an area.
 // Returns a value if it can find the Area attribute size.
 std::optional<unsigned char> getAreaAttributeFlagSize(const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
-	if (MajorVersion <= 8) return VALVE_CHAR_SIZE;
-	else if (MajorVersion < 13) return VALVE_SHORT_SIZE;
-	else if (MajorVersion <= LATEST_NAV_MAJOR_VERSION) return VALVE_INT_SIZE;
-	else return {};
+	if (MajorVersion > LATEST_NAV_MAJOR_VERSION) return {};
+	return GetNavAreaLayout(MajorVersion).FlagSize;
 }
 
 bool NavVisibleArea::WriteData(std::streambuf& out) {
 	if (out.sputn(reinterpret_cast<char*>(&VisibleAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "NavVisibleArea::WriteData(): Could not read vis area ID!\n";
+		#endif
 		return false;
 	}
 	if (out.sputc(Attributes) == std::streambuf::traits_type::eof()) {
@@ -125,12 +98,32 @@ bool NavVisibleArea::WriteData(std::streambuf& out) {
 
 bool NavVisibleArea::ReadData(std::streambuf& in) {
 	if (in.sgetn(reinterpret_cast<char*>(&VisibleAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "NavVisibleArea::ReadData(): Could not read area ID!\n";
+		#endif
 		return false;
 	}
 	Attributes = in.sbumpc();
 	if (Attributes == std::streambuf::traits_type::eof()) {
+		#ifndef NDEBUG
 		std::cerr << "NavVisibleArea::ReadData(): Could not read vis area attributes!\n";
+		#endif
+		return false;
+	}
+	return true;
+}
+
+bool NavVisibleArea::ReadData(NavBufferReader& in) {
+	if (!in.Read(VisibleAreaID)) {
+		#ifndef NDEBUG
+		std::cerr << "NavVisibleArea::ReadData(): Could not read area ID!\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(Attributes)) {
+		#ifndef NDEBUG
+		std::cerr << "NavVisibleArea::ReadData(): Could not read vis area attributes!\n";
+		#endif
 		return false;
 	}
 	return true;
@@ -171,16 +164,46 @@ bool NavHideSpot::WriteData(std::streambuf& out) {
 // Return true on success. false on failure.
 bool NavHideSpot::ReadData(std::streambuf& in) {
 	if (in.sgetn(reinterpret_cast<char*>(&ID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "NavHideSpot::ReadData(): Could not read hide spot ID!\n";
+		#endif
 		return false;
 	}
 	if (in.sgetn(reinterpret_cast<char*>(&position), VALVE_FLOAT_SIZE * 3) != VALVE_FLOAT_SIZE * 3) {
+		#ifndef NDEBUG
 		std::cerr << "NavHideSpot::ReadData(): Could not read hide spot position!\n";
+		#endif
 		return false;
 	}
 	Attributes = in.sbumpc();
 	if (Attributes == std::streambuf::traits_type::eof()) {
+		#ifndef NDEBUG
+		std::cerr << "NavHideSpot::ReadData(): Could not read attribute flag!\n";
+		#endif
+		return false;
+	}
+	return true;
+}
+
+// Read hide spot data from memory.
+// Return true on success. false on failure.
+bool NavHideSpot::ReadData(NavBufferReader& in) {
+	if (!in.Read(ID)) {
+		#ifndef NDEBUG
+		std::cerr << "NavHideSpot::ReadData(): Could not read hide spot ID!\n";
+		#endif
+		return false;
+	}
+	if (!in.ReadBytes(position.data(), VALVE_FLOAT_SIZE * 3)) {
+		#ifndef NDEBUG
+		std::cerr << "NavHideSpot::ReadData(): Could not read hide spot position!\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(Attributes)) {
+		#ifndef NDEBUG
 		std::cerr << "NavHideSpot::ReadData(): Could not read attribute flag!\n";
+		#endif
 		return false;
 	}
 	return true;
@@ -235,6 +258,41 @@ bool NavApproachSpot::ReadData(std::streambuf& in) {
 	return true;
 }
 
+// Fill data from memory.
+bool NavApproachSpot::ReadData(NavBufferReader& in) {
+	if (!in.Read(approachHereId)) {
+		#ifndef NDEBUG
+		std::clog << "NavApproachSpot::ReadData(): Failed to read approach current ID\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(approachPrevId)) {
+		#ifndef NDEBUG
+		std::clog << "NavApproachSpot::ReadData(): Failed to read approach source ID\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(approachType)) {
+		#ifndef NDEBUG
+		std::clog << "NavApproachSpot::ReadData(): Failed to read approach type!\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(approachNextId)) {
+		#ifndef NDEBUG
+		std::clog << "NavApproachSpot::ReadData(): Failed to read next approach ID!\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(approachHow)) {
+		#ifndef NDEBUG
+		std::clog << "NavApproachSpot::ReadData(): Failed to read approach method!\n";
+		#endif
+		return false;
+	}
+	return true;
+}
+
 // Write approach spot data to stream.
 // Returns true on success, false on failure.
 bool NavApproachSpot::WriteData(std::streambuf& out) {
@@ -285,36 +343,84 @@ std::optional<bool> NavApproachSpot::hasSameNAVData(NavApproachSpot& rhs) {
 // Read data of the structure.
 bool NavEncounterPath::ReadData(std::streambuf& in) {
 	if (in.sgetn(reinterpret_cast<char*>(&FromAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "fatal: Could not read source area ID!\n";
+		#endif
 		return false;
 	}
 	FromDirection = static_cast<Direction>(in.sbumpc());
 	if (FromDirection == static_cast<Direction>(EOF)) {
+		#ifndef NDEBUG
 		std::cerr << "fatal: Could not read source direction!\n";
+		#endif
 		return false;
 	}
 	if (in.sgetn(reinterpret_cast<char*>(&ToAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::clog << "fatal: Could not read target area ID!\n";
+		#endif
 		return false;
 	}
 	ToDirection = static_cast<Direction>(in.sbumpc());
 	if (ToDirection == static_cast<Direction>(EOF)) {
+		#ifndef NDEBUG
 		std::clog << "fatal: Could not read target direction!\n";
+		#endif
 		return false;
 	}
 	spotCount = in.sbumpc();
 	if (spotCount == EOF) {
+		#ifndef NDEBUG
 		std::clog << "fatal: Could not read encounter spot count!\n";
+		#endif
 		return false;
 	}
-	for (size_t i = 0; i < spotCount; i++)
-	{
-		NavEncounterSpot spot;
-		if (!spot.ReadData(in)) {
-			std::clog << "fatal: Could not read encounter spot data!\n";
-			return false;
-		}
-		spotContainer.push_back(spot);
+	if (!ReadRecordRun<NavEncounterSpot>(in, spotCount, spotContainer)) {
+		#ifndef NDEBUG
+		std::clog << "fatal: Could not read encounter spot data!\n";
+		#endif
+		return false;
+	}
+	return true;
+}
+
+// Read data of the structure from memory.
+bool NavEncounterPath::ReadData(NavBufferReader& in) {
+	if (!in.Read(FromAreaID)) {
+		#ifndef NDEBUG
+		std::cerr << "fatal: Could not read source area ID!\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(FromDirection)) {
+		#ifndef NDEBUG
+		std::cerr << "fatal: Could not read source direction!\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(ToAreaID)) {
+		#ifndef NDEBUG
+		std::clog << "fatal: Could not read target area ID!\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(ToDirection)) {
+		#ifndef NDEBUG
+		std::clog << "fatal: Could not read target direction!\n";
+		#endif
+		return false;
+	}
+	if (!in.Read(spotCount)) {
+		#ifndef NDEBUG
+		std::clog << "fatal: Could not read encounter spot count!\n";
+		#endif
+		return false;
+	}
+	if (!ReadRecordRun<NavEncounterSpot>(in, spotCount, spotContainer)) {
+		#ifndef NDEBUG
+		std::clog << "fatal: Could not read encounter spot data!\n";
+		#endif
+		return false;
 	}
 	return true;
 }
@@ -322,47 +428,41 @@ bool NavEncounterPath::ReadData(std::streambuf& in) {
 // Write data to the structure.
 bool NavEncounterPath::WriteData(std::streambuf& out) {
 	if (out.sputn(reinterpret_cast<char*>(&FromAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "NavEncounterPath::WriteData(): Could not write source area ID!\n";
+		#endif
 		return false;
 	}
 	if (out.sputc((char)FromDirection) != (char)FromDirection) {
+		#ifndef NDEBUG
 		std::cerr << "NavEncounterPath::WriteData(): Could not write source direction!\n";
+		#endif
 		return false;
 	}
 	if (out.sputn(reinterpret_cast<char*>(&ToAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "NavEncounterPath::WriteData(): Could not write destination area ID!\n";
+		#endif
 		return false;
 	}
 	if (out.sputc((char)ToDirection) != (char)ToDirection) {
+		#ifndef NDEBUG
 		std::cerr << "NavEncounterPath::WriteData(): Could not write destination direction!\n";
+		#endif
 		return false;
 	}
 	if (out.sputc(spotCount) != spotCount) {
+		#ifndef NDEBUG
 		std::cerr << "NavEncounterPath::WriteData(): Could not write hide spot count!\n";
+		#endif
 		return false;
 	}
-	if (spotCount == spotContainer.size()) for (size_t i = 0; i < spotCount; i++)
-	{
-		NavEncounterSpot spot;
-		if (!spot.WriteData(out)) {
-			#ifndef NDEBUG
-			std::cerr << "NavEncounterPath::WriteData(): Could not write hide spot data !\n";
-			#endif
-			return false;
-		}
-		spotContainer.push_back(spot);
-	}
-	else {
-		NavEncounterSpot blank;
-		for (size_t i = 0; i < spotCount; i++)
-		{
-			if (!blank.WriteData(out)) {
-				#ifndef NDEBUG
-				std::cerr << "NavEncounterPath::WriteData(): Could not write hide spot data !\n";
-				#endif
-				return false;
-			}
-		}
+	// Missing encounter spots are written blank.
+	if (!WriteRecordRun<NavEncounterSpot>(out, spotCount, spotContainer)) {
+		#ifndef NDEBUG
+		std::cerr << "NavEncounterPath::WriteData(): Could not write encounter spot data!\n";
+		#endif
+		return false;
 	}
 	return true;
 }
@@ -389,24 +489,51 @@ void NavEncounterPath::Output(std::ostream& out) {
 
 bool NavEncounterSpot::ReadData(std::streambuf& in) {
 	if (in.sgetn(reinterpret_cast<char*>(&OrderID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "NavEncounterSpot::ReadData(): Could not read order ID!\n";
+		#endif
 		return false;
 	}
 	ParametricDistance = in.sbumpc();
 	if (ParametricDistance == std::streambuf::traits_type::eof()) {
+		#ifndef NDEBUG
+		std::cerr << "NavEncounterSpot::ReadData(): Could not read distance!\n";
+		#endif
+		return false;
+	}
+	return true;
+}
+
+bool NavEncounterSpot::ReadData(NavBufferReader& in) {
+	if (!in.Read(OrderID)) {
+		#ifndef NDEBUG
+		std::cerr << "NavEncounterSpot::ReadData(): Could not read order ID!\n";
+		#endif
+		return false;
+	}
+	// Distance is stored as a single byte.
+	unsigned char distance;
+	if (!in.Read(distance)) {
+		#ifndef NDEBUG
 		std::cerr << "NavEncounterSpot::ReadData(): Could not read distance!\n";
+		#endif
 		return false;
 	}
+	ParametricDistance = distance;
 	return true;
 }
 
 bool NavEncounterSpot::WriteData(std::streambuf& out) {
 	if (out.sputn(reinterpret_cast<char*>(&OrderID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "NavEncounterSpot::WriteData(): Could not write order ID!\n";
+		#endif
 		return false;
 	}
 	if (out.sputc((char)ParametricDistance) != (char)(ParametricDistance)) {
+		#ifndef NDEBUG
 		std::cerr << "NavEncounterSpot::WriteData(): Could not write distance!\n";
+		#endif
 		return false;
 	}
 	return true;
@@ -492,6 +619,58 @@ bool NavLadder::ReadData(std::streambuf& in) {
 	return true;
 }
 
+// Read data for NavLadder from memory.
+// Returns true on success, false on failure.
+bool NavLadder::ReadData(NavBufferReader& in) {
+	if (!in.Read(ID)) {
+		#ifndef NDEBUG
+		std::clog << "Failed to read ladder ID!\n";
+		#endif
+		return false;
+	}
+	// Read ladder width.
+	if (!in.Read(Width)) {
+		#ifndef NDEBUG
+		std::clog << "Failed to read ladder width!\n";
+		#endif
+		return false;
+	}
+	if (!in.ReadBytes(TopVec.data(), VALVE_FLOAT_SIZE * TopVec.size())) {
+		#ifndef NDEBUG
+		std::clog << "Failed to read ladder top vector!\n";
+		#endif
+		return false;
+	}
+	if (!in.ReadBytes(BottomVec.data(), VALVE_FLOAT_SIZE * BottomVec.size())) {
+		#ifndef NDEBUG
+		std::clog << "Failed to read ladder bottom vector!\n";
+		#endif
+		return false;
+	}
+	// Read ladder length.
+	if (!in.Read(Length)) {
+		#ifndef NDEBUG
+		std::clog << "Failed to read ladder length!\n";
+		#endif
+		return false;
+	}
+	// Ladder Direction
+	if (!in.Read(direction)) {
+		#ifndef NDEBUG
+		std::clog << "Failed to read ladder direction!\n";
+		#endif
+		return false;
+	}
+	// Get area IDs
+	if (!in.Read(TopForwardAreaID) || !in.Read(TopLeftAreaID) || !in.Read(TopRightAreaID) || !in.Read(TopBehindAreaID) || !in.Read(BottomAreaID)) {
+		#ifndef NDEBUG
+		std::clog << "Failed to get ladder area IDs.\n";
+		#endif
+		return false;
+	}
+	return true;
+}
+
 // Write data for NavLadder.
 // Returns true on success, false on failure.
 bool NavLadder::WriteData(std::streambuf& out) {
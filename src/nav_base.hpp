@@ -6,6 +6,9 @@
 #include <vector>
 #include <tuple>
 #include <any>
+#include <span>
+#include <cstddef>
+#include "nav_buffer.hpp"
 // Data type sizes in valve stuff.
 #define VALVE_CHAR_SIZE 1
 #define VALVE_SHORT_SIZE 2
@@ -47,11 +50,34 @@ enum EngineVersion {
 EngineVersion GetAsEngineVersion(const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
 // get the minimum custom data length (in bytes) possible
 std::size_t getCustomDataSize(const unsigned int& version, const std::optional<unsigned int>& subversion);
-// get the custom data length (in bytes) from a NAV file.
+// get the custom data length (in bytes) from a NAV file. Does not advance the stream.
 std::size_t getCustomDataSize(std::streambuf& buf, const unsigned int& version, const std::optional<unsigned int>& subversion);
+// get the custom data length (in bytes) from NAV data in memory. Does not advance the reader.
+std::size_t getCustomDataSize(const NavBufferReader& buf, const unsigned int& version, const std::optional<unsigned int>& subversion);
+// Swap the byte order of an area's custom data in place. Custom data of unknown games is left as it is.
+void swapCustomData(std::span<std::byte> data, const unsigned int& version, const std::optional<unsigned int>& subversion);
 // Get the ideal attribute flag size (in bytes) of an area.
 std::optional<unsigned char> getAreaAttributeFlagSize(const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
 
+// The parts of area data that change between NAV major versions.
+struct NavAreaLayout {
+	unsigned char FlagSize; // Size of the attribute flags (in bytes).
+	bool HasLightIntensity; // Added in version 11.
+	bool HasApproachSpots; // Removed in version 15.
+	bool HasVisibility; // Visible areas and InheritVisibilityFromAreaID, added in version 16.
+
+	constexpr bool operator==(const NavAreaLayout&) const = default;
+};
+// Get the area data layout of a NAV major version.
+constexpr NavAreaLayout GetNavAreaLayout(const unsigned int& MajorVersion) {
+	return {
+		static_cast<unsigned char>(MajorVersion < 8 ? VALVE_CHAR_SIZE : MajorVersion <= 13 ? VALVE_SHORT_SIZE : VALVE_INT_SIZE),
+		MajorVersion >= 11,
+		MajorVersion < 15,
+		MajorVersion >= 16
+	};
+}
+
 // Hiding spots.
 #define HIDE_SPOT_SIZE (VALVE_INT_SIZE + (VALVE_FLOAT_SIZE * 3) + VALVE_CHAR_SIZE)
 class NavHideSpot {
@@ -61,6 +87,7 @@ public:
 	unsigned char Attributes; // Attributes.
 
 	bool ReadData(std::streambuf& in);
+	bool ReadData(NavBufferReader& in);
 	void OutputData(std::ostream& out);
 	bool WriteData(std::streambuf& out);
 
@@ -78,6 +105,7 @@ public:
 	// Write data to stream.
 	bool WriteData(std::streambuf& out);
 	bool ReadData(std::streambuf& in);
+	bool ReadData(NavBufferReader& in);
 
 	std::optional<bool> hasSameNAVData(NavApproachSpot& rhs);
 };
@@ -92,6 +120,7 @@ public:
 
 	bool WriteData(std::streambuf& out);
 	bool ReadData(std::streambuf& in);
+	bool ReadData(NavBufferReader& in);
 };
 
 #define ENCOUNTER_PATH_SIZE 10 // Total size of encounter path data.
@@ -110,6 +139,7 @@ public:
 
 	bool WriteData(std::streambuf& out);
 	bool ReadData(std::streambuf& in);
+	bool ReadData(NavBufferReader& in);
 
 	// Output data.
 	void Output(std::ostream& out);
@@ -126,11 +156,12 @@ public:
 
 	bool WriteData(std::streambuf& out);
 	bool ReadData(std::streambuf& in);
+	bool ReadData(NavBufferReader& in);
 
 	bool hasSameNAVData(const NavVisibleArea& rhs) const;
 };
 
-#define LADDER_SIZE 53 // Total size of ladder data.
+#define LADDER_SIZE 60 // Total size of ladder data.
 // Ladder
 class NavLadder {
 public:
@@ -147,6 +178,7 @@ public:
 	unsigned int BottomAreaID; // ID of the area connected to the bottom of the ladder
 
 	bool ReadData(std::streambuf& in);
+	bool ReadData(NavBufferReader& in);
 	bool WriteData(std::streambuf& out);
 };
 
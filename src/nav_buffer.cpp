@@ -0,0 +1,71 @@
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "nav_buffer.hpp"
+
+NavMappedFile::NavMappedFile() {}
+
+NavMappedFile::~NavMappedFile() {
+	Close();
+}
+
+// Map the file at path into memory.
+// Returns true on success, false on failure.
+bool NavMappedFile::Open(const std::filesystem::path& path) {
+	Close();
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1) {
+		#ifndef NDEBUG
+		std::cerr << "NavMappedFile::Open(): Could not open \'" << path << "\'!\n";
+		#endif
+		return false;
+	}
+	struct stat st;
+	// Only regular files can be mapped. Empty files can't be mapped either.
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+		close(fd);
+		return false;
+	}
+	void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file.
+	close(fd);
+	if (addr == MAP_FAILED) {
+		#ifndef NDEBUG
+		std::cerr << "NavMappedFile::Open(): Could not map \'" << path << "\'!\n";
+		#endif
+		return false;
+	}
+	// NAV data is decoded front to back, so let the kernel read ahead.
+	madvise(addr, st.st_size, MADV_SEQUENTIAL);
+	madvise(addr, st.st_size, MADV_WILLNEED);
+	mapData = addr;
+	mapSize = st.st_size;
+	return true;
+}
+
+// Unmap the file.
+void NavMappedFile::Close() {
+	if (mapData) munmap(mapData, mapSize);
+	mapData = nullptr;
+	mapSize = 0u;
+}
+
+bool NavMappedFile::IsOpen() const {
+	return mapData != nullptr;
+}
+
+// The mapped file contents.
+std::span<const std::byte> NavMappedFile::GetData() const {
+	return std::span<const std::byte>(static_cast<const std::byte*>(mapData), mapSize);
+}
+
+NavBufferReader::NavBufferReader(std::span<const std::byte> buffer)
+: data(buffer) {
+}
+
+NavBufferWriter::NavBufferWriter(std::span<std::byte> buffer) {
+	char* begin = reinterpret_cast<char*>(buffer.data());
+	setp(begin, begin + buffer.size());
+}
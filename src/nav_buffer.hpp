@@ -0,0 +1,120 @@
+#ifndef NAV_BUFFER_HPP
+#define NAV_BUFFER_HPP
+#include <span>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <filesystem>
+#include <type_traits>
+#include <streambuf>
+// Most memory allocated ahead of the data read from a stream. A stream doesn't know how much data is left,
+// so counts read from one can't be checked before allocating; anything larger grows as its data is read instead.
+#define NAV_STREAM_RESERVE_SIZE (1u << 20)
+
+// Read-only memory mapping of a whole file.
+class NavMappedFile {
+	private:
+		void* mapData = nullptr; // Start of the mapping.
+		size_t mapSize = 0u; // Length of the mapping (in bytes).
+	public:
+		NavMappedFile();
+		NavMappedFile(const NavMappedFile&) = delete;
+		NavMappedFile& operator=(const NavMappedFile&) = delete;
+		~NavMappedFile();
+
+		// Map the file at path into memory.
+		// Returns true on success, false on failure.
+		bool Open(const std::filesystem::path& path);
+		// Unmap the file.
+		void Close();
+		bool IsOpen() const;
+		// The mapped file contents.
+		std::span<const std::byte> GetData() const;
+};
+
+// Forward cursor over a span of NAV data.
+// Decodes fields straight from memory instead of going through std::streambuf.
+class NavBufferReader {
+	private:
+		std::span<const std::byte> data;
+		size_t pos = 0u;
+	public:
+		NavBufferReader(std::span<const std::byte> buffer);
+
+		// Copy len bytes into out and advance.
+		// Returns false (without advancing) if there are not enough bytes left.
+		bool ReadBytes(void* out, const size_t& len) {
+			if (len > data.size() - pos) return false;
+			std::memcpy(out, data.data() + pos, len);
+			pos += len;
+			return true;
+		}
+		// Read a trivially copyable value and advance.
+		template<typename T>
+		bool Read(T& out) {
+			static_assert(std::is_trivially_copyable_v<T>, "NavBufferReader::Read() needs a trivially copyable type.");
+			return ReadBytes(&out, sizeof(T));
+		}
+		// Take a view of the next len bytes and advance.
+		// Returns nothing (without advancing) if there are not enough bytes left.
+		std::optional<std::span<const std::byte> > ReadSpan(const size_t& len) {
+			if (len > data.size() - pos) return {};
+			pos += len;
+			return data.subspan(pos - len, len);
+		}
+		// Advance without reading.
+		bool Skip(const size_t& len) {
+			if (len > data.size() - pos) return false;
+			pos += len;
+			return true;
+		}
+		// Look at the next byte without consuming it.
+		std::optional<unsigned char> Peek() const {
+			if (pos >= data.size()) return {};
+			return static_cast<unsigned char>(data[pos]);
+		}
+		// Move to an absolute position.
+		bool Seek(const size_t& newPos) {
+			if (newPos > data.size()) return false;
+			pos = newPos;
+			return true;
+		}
+		size_t Tell() const { return pos; }
+		size_t Remaining() const { return data.size() - pos; }
+		std::span<const std::byte> GetData() const { return data; }
+};
+
+// Stream buffer that reads through to another one, counting the bytes taken from it.
+// Decoders use it to measure what they read without asking the source for its position, which pipes can't tell.
+class NavCountingBuf : public std::streambuf {
+	private:
+		std::streambuf& source;
+		size_t count = 0u;
+	protected:
+		// Nothing is buffered here, so peeks and reads go straight to the source.
+		int_type underflow() override { return source.sgetc(); }
+		int_type uflow() override {
+			int_type c = source.sbumpc();
+			if (!traits_type::eq_int_type(c, traits_type::eof())) count++;
+			return c;
+		}
+		std::streamsize xsgetn(char* s, std::streamsize n) override {
+			std::streamsize read = source.sgetn(s, n);
+			count += read;
+			return read;
+		}
+	public:
+		NavCountingBuf(std::streambuf& source) : source(source) {}
+		// Bytes read so far.
+		size_t GetCount() const { return count; }
+};
+
+// Stream buffer over a fixed span of memory, for encoding straight into a preallocated buffer.
+// Writing past the end of the span fails.
+class NavBufferWriter : public std::streambuf {
+	public:
+		NavBufferWriter(std::span<std::byte> buffer);
+		// Bytes written so far.
+		size_t Tell() const { return static_cast<size_t>(pptr() - pbase()); }
+};
+#endif
@@ -0,0 +1,71 @@
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#include "nav_byte_order.hpp"
+
+// Byte order of NAV data, from its magic number.
+// Returns nothing if the data doesn't start with one.
+std::optional<std::endian> DetectNavByteOrder(std::span<const std::byte> data) {
+	static constexpr unsigned char littleMagic[] = {0xCE, 0xFA, 0xED, 0xFE}, bigMagic[] = {0xFE, 0xED, 0xFA, 0xCE};
+	if (data.size() < sizeof(littleMagic)) return {};
+	if (std::memcmp(data.data(), littleMagic, sizeof(littleMagic)) == 0) return std::endian::little;
+	if (std::memcmp(data.data(), bigMagic, sizeof(bigMagic)) == 0) return std::endian::big;
+	return {};
+}
+
+// Swap each 16-bit value in data. Returns how many bytes were swapped with SIMD.
+static size_t SwapBlocks16(std::byte* data, const size_t& size) {
+	size_t pos = 0u;
+	#if defined(__SSE2__)
+	for (; pos + 16u <= size; pos += 16u)
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+		block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + pos), block);
+	}
+	#elif defined(__ARM_NEON)
+	for (; pos + 16u <= size; pos += 16u)
+	{
+		uint8_t* block = reinterpret_cast<uint8_t*>(data + pos);
+		vst1q_u8(block, vrev16q_u8(vld1q_u8(block)));
+	}
+	#endif
+	return pos;
+}
+
+// Swap each 32-bit value in data. Returns how many bytes were swapped with SIMD.
+static size_t SwapBlocks32(std::byte* data, const size_t& size) {
+	size_t pos = 0u;
+	#if defined(__SSE2__)
+	for (; pos + 16u <= size; pos += 16u)
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+		// Swap the bytes of each half, then the halves.
+		block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+		block = _mm_shufflehi_epi16(_mm_shufflelo_epi16(block, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + pos), block);
+	}
+	#elif defined(__ARM_NEON)
+	for (; pos + 16u <= size; pos += 16u)
+	{
+		uint8_t* block = reinterpret_cast<uint8_t*>(data + pos);
+		vst1q_u8(block, vrev32q_u8(vld1q_u8(block)));
+	}
+	#endif
+	return pos;
+}
+
+// Swap the byte order of each width-byte value in data, in place (width is 1, 2, 4 or 8).
+void SwapNavBytes(std::span<std::byte> data, const size_t& width) {
+	if (width < 2u) return;
+	size_t pos = 0u;
+	if (width == 2u) pos = SwapBlocks16(data.data(), data.size());
+	else if (width == 4u) pos = SwapBlocks32(data.data(), data.size());
+	// What's left (and 8-byte values).
+	for (; pos + width <= data.size(); pos += width) std::reverse(data.begin() + pos, data.begin() + pos + width);
+}
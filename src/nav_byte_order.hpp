@@ -0,0 +1,16 @@
+#ifndef NAV_BYTE_ORDER_HPP
+#define NAV_BYTE_ORDER_HPP
+#include <bit>
+#include <span>
+#include <cstddef>
+#include <optional>
+// NAV files are little-endian, except those of console builds, which are big-endian.
+// Both start with the magic number 0xFEEDFACE, so its bytes tell the byte order.
+
+// Byte order of NAV data, from its magic number.
+// Returns nothing if the data doesn't start with one.
+std::optional<std::endian> DetectNavByteOrder(std::span<const std::byte> data);
+// Swap the byte order of each width-byte value in data, in place (width is 1, 2, 4 or 8).
+// Runs of 2 and 4-byte values are swapped with SIMD where the target has it.
+void SwapNavBytes(std::span<std::byte> data, const size_t& width);
+#endif
@@ -0,0 +1,308 @@
+#ifndef NAV_CODEC_HPP
+#define NAV_CODEC_HPP
+#include <cstring>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <streambuf>
+#include "nav_base.hpp"
+#include "nav_buffer.hpp"
+#include "nav_connections.hpp"
+#include "nav_byte_order.hpp"
+
+/*
+	Bulk codecs for fixed-size NAV records.
+	Each record type gets a NavRecordCodec specialization that knows the packed size of the record,
+	the widths of its fields (for byte swapping), and how to decode/encode one record from/to raw bytes.
+	ReadRecordRun()/WriteRecordRun() then move a whole count-prefixed run of records in one block.
+*/
+template<typename T>
+struct NavRecordCodec;
+
+// Copy a field out of packed record data.
+template<typename T>
+inline void DecodeField(const std::byte*& src, T& field, const size_t& len = sizeof(T)) {
+	std::memcpy(&field, src, len);
+	src += len;
+}
+
+// Copy a field into packed record data.
+template<typename T>
+inline void EncodeField(std::byte*& dst, const T& field, const size_t& len = sizeof(T)) {
+	std::memcpy(dst, &field, len);
+	dst += len;
+}
+
+// Plain IDs (ladder IDs in areas).
+template<>
+struct NavRecordCodec<IntID> {
+	static constexpr size_t Size = VALVE_INT_SIZE;
+	static constexpr std::array<unsigned char, 1> Fields = {4};
+	static void Decode(const std::byte* src, IntID& id) { DecodeField(src, id); }
+	static void Encode(std::byte* dst, const IntID& id) { EncodeField(dst, id); }
+};
+
+template<>
+struct NavRecordCodec<NavConnection> {
+	static constexpr size_t Size = CONNECTION_SIZE;
+	static constexpr std::array<unsigned char, 1> Fields = {4};
+	static void Decode(const std::byte* src, NavConnection& connection) { DecodeField(src, connection.TargetAreaID); }
+	static void Encode(std::byte* dst, const NavConnection& connection) { EncodeField(dst, connection.TargetAreaID); }
+};
+
+template<>
+struct NavRecordCodec<NavHideSpot> {
+	static constexpr size_t Size = HIDE_SPOT_SIZE;
+	static constexpr std::array<unsigned char, 5> Fields = {4, 4, 4, 4, 1};
+	static void Decode(const std::byte* src, NavHideSpot& hideSpot) {
+		DecodeField(src, hideSpot.ID);
+		DecodeField(src, hideSpot.position);
+		DecodeField(src, hideSpot.Attributes);
+	}
+	static void Encode(std::byte* dst, const NavHideSpot& hideSpot) {
+		EncodeField(dst, hideSpot.ID);
+		EncodeField(dst, hideSpot.position);
+		EncodeField(dst, hideSpot.Attributes);
+	}
+};
+
+template<>
+struct NavRecordCodec<NavApproachSpot> {
+	static constexpr size_t Size = APPROACH_SPOT_SIZE;
+	static constexpr std::array<unsigned char, 5> Fields = {4, 4, 1, 4, 1};
+	static void Decode(const std::byte* src, NavApproachSpot& approachSpot) {
+		DecodeField(src, approachSpot.approachHereId);
+		DecodeField(src, approachSpot.approachPrevId);
+		DecodeField(src, approachSpot.approachType);
+		DecodeField(src, approachSpot.approachNextId);
+		DecodeField(src, approachSpot.approachHow);
+	}
+	static void Encode(std::byte* dst, const NavApproachSpot& approachSpot) {
+		EncodeField(dst, approachSpot.approachHereId);
+		EncodeField(dst, approachSpot.approachPrevId);
+		EncodeField(dst, approachSpot.approachType);
+		EncodeField(dst, approachSpot.approachNextId);
+		EncodeField(dst, approachSpot.approachHow);
+	}
+};
+
+template<>
+struct NavRecordCodec<NavEncounterSpot> {
+	static constexpr size_t Size = ENCOUNTER_SPOT_SIZE;
+	static constexpr std::array<unsigned char, 2> Fields = {4, 1};
+	static void Decode(const std::byte* src, NavEncounterSpot& encounterSpot) {
+		unsigned char distance;
+		DecodeField(src, encounterSpot.OrderID);
+		DecodeField(src, distance);
+		encounterSpot.ParametricDistance = distance;
+	}
+	static void Encode(std::byte* dst, const NavEncounterSpot& encounterSpot) {
+		unsigned char distance = static_cast<unsigned char>(encounterSpot.ParametricDistance);
+		EncodeField(dst, encounterSpot.OrderID);
+		EncodeField(dst, distance);
+	}
+};
+
+template<>
+struct NavRecordCodec<NavVisibleArea> {
+	static constexpr size_t Size = VISIBLE_AREA_SIZE;
+	static constexpr std::array<unsigned char, 2> Fields = {4, 1};
+	static void Decode(const std::byte* src, NavVisibleArea& visArea) {
+		DecodeField(src, visArea.VisibleAreaID);
+		DecodeField(src, visArea.Attributes);
+	}
+	static void Encode(std::byte* dst, const NavVisibleArea& visArea) {
+		EncodeField(dst, visArea.VisibleAreaID);
+		EncodeField(dst, visArea.Attributes);
+	}
+};
+
+template<>
+struct NavRecordCodec<NavLadder> {
+	static constexpr size_t Size = LADDER_SIZE;
+	static constexpr std::array<unsigned char, 15> Fields = {4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4};
+	static void Decode(const std::byte* src, NavLadder& ladder) {
+		DecodeField(src, ladder.ID);
+		DecodeField(src, ladder.Width);
+		DecodeField(src, ladder.TopVec);
+		DecodeField(src, ladder.BottomVec);
+		DecodeField(src, ladder.Length);
+		DecodeField(src, ladder.direction);
+		DecodeField(src, ladder.TopForwardAreaID);
+		DecodeField(src, ladder.TopLeftAreaID);
+		DecodeField(src, ladder.TopRightAreaID);
+		DecodeField(src, ladder.TopBehindAreaID);
+		DecodeField(src, ladder.BottomAreaID);
+	}
+	static void Encode(std::byte* dst, const NavLadder& ladder) {
+		EncodeField(dst, ladder.ID);
+		EncodeField(dst, ladder.Width);
+		EncodeField(dst, ladder.TopVec);
+		EncodeField(dst, ladder.BottomVec);
+		EncodeField(dst, ladder.Length);
+		EncodeField(dst, ladder.direction);
+		EncodeField(dst, ladder.TopForwardAreaID);
+		EncodeField(dst, ladder.TopLeftAreaID);
+		EncodeField(dst, ladder.TopRightAreaID);
+		EncodeField(dst, ladder.TopBehindAreaID);
+		EncodeField(dst, ladder.BottomAreaID);
+	}
+};
+
+// Total width of a record's fields, and whether they are all 4 bytes wide.
+template<size_t N>
+constexpr size_t FieldsSize(const std::array<unsigned char, N>& fields) {
+	size_t size = 0u;
+	for (const unsigned char& width : fields) size += width;
+	return size;
+}
+
+template<size_t N>
+constexpr bool AllWordFields(const std::array<unsigned char, N>& fields) {
+	for (const unsigned char& width : fields) if (width != 4u) return false;
+	return true;
+}
+
+// Number of 4-byte fields in a record, and whether the rest are single bytes (which don't need swapping).
+template<size_t N>
+constexpr size_t WordFieldCount(const std::array<unsigned char, N>& fields) {
+	size_t count = 0u;
+	for (const unsigned char& width : fields) if (width == 4u) count++;
+	return count;
+}
+
+template<size_t N>
+constexpr bool WordAndByteFields(const std::array<unsigned char, N>& fields) {
+	for (const unsigned char& width : fields) if (width != 4u && width != 1u) return false;
+	return true;
+}
+
+// Offsets of the 4-byte fields of a record.
+template<typename T>
+constexpr std::array<size_t, WordFieldCount(NavRecordCodec<T>::Fields)> WordFieldOffsets() {
+	std::array<size_t, WordFieldCount(NavRecordCodec<T>::Fields)> offsets = {};
+	size_t offset = 0u, index = 0u;
+	for (const unsigned char& width : NavRecordCodec<T>::Fields)
+	{
+		if (width == 4u) offsets[index++] = offset;
+		offset += width;
+	}
+	return offsets;
+}
+
+// Records gathered into one block of words at a time, by SwapRecordRun().
+inline constexpr size_t NAV_SWAP_BATCH_COUNT = 64u;
+
+// Swap the byte order of every field of a run of packed records, in place.
+// Runs of records made of 4-byte fields only are swapped as one block of words.
+// Otherwise the 4-byte fields of a batch of records are gathered into one block, swapped, and scattered back.
+template<typename T>
+void SwapRecordRun(std::span<std::byte> run) {
+	constexpr auto Fields = NavRecordCodec<T>::Fields;
+	constexpr size_t Size = NavRecordCodec<T>::Size;
+	static_assert(FieldsSize(Fields) == Size, "Record fields don't add up to the record size.");
+	static_assert(WordAndByteFields(Fields), "Record fields must be 4 or 1 bytes wide.");
+	if constexpr (AllWordFields(Fields)) SwapNavBytes(run, 4u);
+	else {
+		constexpr auto Offsets = WordFieldOffsets<T>();
+		std::array<std::byte, NAV_SWAP_BATCH_COUNT * Offsets.size() * 4u> words;
+		const size_t count = run.size() / Size;
+		for (size_t first = 0u; first < count; first += NAV_SWAP_BATCH_COUNT)
+		{
+			const size_t batch = std::min(count - first, NAV_SWAP_BATCH_COUNT);
+			std::byte* record = run.data() + first * Size;
+			std::byte* word = words.data();
+			for (size_t i = 0u; i < batch; i++, record += Size) for (const size_t& offset : Offsets)
+			{
+				std::memcpy(word, record + offset, 4u);
+				word += 4u;
+			}
+			SwapNavBytes(std::span(words).first(word - words.data()), 4u);
+			record = run.data() + first * Size;
+			word = words.data();
+			for (size_t i = 0u; i < batch; i++, record += Size) for (const size_t& offset : Offsets)
+			{
+				std::memcpy(record + offset, word, 4u);
+				word += 4u;
+			}
+		}
+	}
+}
+
+// Decode a run of count records from packed data into out, replacing its contents.
+template<typename T, typename Container>
+void DecodeRecordRun(std::span<const std::byte> run, const size_t& count, Container& out) {
+	out.resize(count);
+	const std::byte* src = run.data();
+	for (auto& record : out)
+	{
+		NavRecordCodec<T>::Decode(src, record);
+		src += NavRecordCodec<T>::Size;
+	}
+}
+
+// Decode a run of count records from packed data, adding them to the end of out.
+template<typename T, typename Container>
+void AppendRecordRun(std::span<const std::byte> run, const size_t& count, Container& out) {
+	const size_t start = out.size();
+	out.resize(start + count);
+	const std::byte* src = run.data();
+	for (auto it = std::next(out.begin(), start); it != out.end(); it++)
+	{
+		NavRecordCodec<T>::Decode(src, *it);
+		src += NavRecordCodec<T>::Size;
+	}
+}
+
+// Read a run of count records from memory into out.
+// Returns true on success, false if the run is cut short.
+template<typename T, typename Container>
+bool ReadRecordRun(NavBufferReader& in, const size_t& count, Container& out) {
+	std::optional<std::span<const std::byte> > run = in.ReadSpan(count * NavRecordCodec<T>::Size);
+	if (!run.has_value()) return false;
+	DecodeRecordRun<T>(run.value(), count, out);
+	return true;
+}
+
+// Read a run of count records from a stream into out, with a single read if it fits in NAV_STREAM_RESERVE_SIZE.
+// Longer runs are read a chunk at a time, so a corrupt count fails at the end of the data instead of allocating for it.
+// Returns true on success, false if the run is cut short.
+template<typename T, typename Container>
+bool ReadRecordRun(std::streambuf& in, const size_t& count, Container& out) {
+	constexpr size_t ChunkCount = std::max<size_t>(NAV_STREAM_RESERVE_SIZE / NavRecordCodec<T>::Size, 1u);
+	std::vector<std::byte> run(std::min(count, ChunkCount) * NavRecordCodec<T>::Size);
+	out.clear();
+	for (size_t done = 0u; done < count;)
+	{
+		const size_t chunk = std::min(count - done, ChunkCount), chunkSize = chunk * NavRecordCodec<T>::Size;
+		if (static_cast<size_t>(in.sgetn(reinterpret_cast<char*>(run.data()), chunkSize)) != chunkSize) return false;
+		AppendRecordRun<T>(std::span(run).first(chunkSize), chunk, out);
+		done += chunk;
+	}
+	return true;
+}
+
+// Encode count records into packed data. Missing records are written blank.
+template<typename T, typename Container>
+void EncodeRecordRun(std::span<std::byte> run, const size_t& count, const Container& in) {
+	std::byte* dst = run.data();
+	size_t written = 0u;
+	for (auto it = in.begin(); it != in.end() && written < count; it++, written++)
+	{
+		NavRecordCodec<T>::Encode(dst, *it);
+		dst += NavRecordCodec<T>::Size;
+	}
+	std::memset(dst, 0, (count - written) * NavRecordCodec<T>::Size);
+}
+
+// Write count records from in to a stream, with a single write.
+// Returns true on success, false on failure.
+template<typename T, typename Container>
+bool WriteRecordRun(std::streambuf& out, const size_t& count, const Container& in) {
+	const size_t runSize = count * NavRecordCodec<T>::Size;
+	std::vector<std::byte> run(runSize);
+	EncodeRecordRun<T>(run, count, in);
+	return static_cast<size_t>(out.sputn(reinterpret_cast<const char*>(run.data()), runSize)) == runSize;
+}
+#endif
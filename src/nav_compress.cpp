@@ -0,0 +1,311 @@
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef NAV_ZSTD
+#include <zstd.h>
+#endif
+#include "nav_compress.hpp"
+
+// Tell how data is compressed from its first bytes.
+NavCompression DetectNavCompression(std::span<const std::byte> data) {
+	auto startsWith = [&data](std::initializer_list<unsigned char> magic) -> bool {
+		return data.size() >= magic.size() && std::equal(magic.begin(), magic.end(), data.begin(), [](const unsigned char& lhs, const std::byte& rhs) { return lhs == static_cast<unsigned char>(rhs); });
+	};
+	if (startsWith({0x1F, 0x8B})) return NavCompression::GZIP;
+	if (startsWith({0x28, 0xB5, 0x2F, 0xFD})) return NavCompression::ZSTD;
+	return NavCompression::NONE;
+}
+
+// Can data compressed this way be read and written?
+bool IsNavCompressionSupported(const NavCompression& compression) {
+	#ifdef NAV_ZSTD
+	return true;
+	#else
+	return compression != NavCompression::ZSTD;
+	#endif
+}
+
+/* Compress data into out.
+Returns true on success, false on failure. */
+bool CompressNavData(std::span<const std::byte> data, const NavCompression& compression, std::string& out) {
+	switch (compression)
+	{
+	case NavCompression::NONE:
+		out.assign(reinterpret_cast<const char*>(data.data()), data.size());
+		return true;
+	case NavCompression::GZIP:
+		{
+			z_stream stream{};
+			// 16 selects a gzip header instead of a zlib one.
+			if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+			out.resize(deflateBound(&stream, data.size()));
+			size_t inPos = 0u, outPos = 0u;
+			int ret;
+			// zlib counts in 32 bits, so feed it in chunks.
+			do {
+				const size_t inLen = std::min<size_t>(data.size() - inPos, std::numeric_limits<uInt>::max());
+				const size_t outLen = std::min<size_t>(out.size() - outPos, std::numeric_limits<uInt>::max());
+				stream.next_in = reinterpret_cast<Bytef*>(const_cast<std::byte*>(data.data() + inPos));
+				stream.avail_in = inLen;
+				stream.next_out = reinterpret_cast<Bytef*>(out.data() + outPos);
+				stream.avail_out = outLen;
+				ret = deflate(&stream, inPos + inLen == data.size() ? Z_FINISH : Z_NO_FLUSH);
+				inPos += inLen - stream.avail_in;
+				outPos += outLen - stream.avail_out;
+			} while (ret == Z_OK);
+			deflateEnd(&stream);
+			if (ret != Z_STREAM_END) {
+				#ifndef NDEBUG
+				std::clog << "CompressNavData(): gzip compression failed.\n";
+				#endif
+				return false;
+			}
+			out.resize(outPos);
+			return true;
+		}
+	case NavCompression::ZSTD:
+		#ifdef NAV_ZSTD
+		{
+			out.resize(ZSTD_compressBound(data.size()));
+			const size_t ret = ZSTD_compress(out.data(), out.size(), data.data(), data.size(), ZSTD_CLEVEL_DEFAULT);
+			if (ZSTD_isError(ret)) {
+				#ifndef NDEBUG
+				std::clog << "CompressNavData(): zstd compression failed: " << ZSTD_getErrorName(ret) << "\n";
+				#endif
+				return false;
+			}
+			out.resize(ret);
+			return true;
+		}
+		#endif
+	default:
+		break;
+	}
+	return false;
+}
+
+// Read from fd, which stays open.
+NavReadBuf::NavReadBuf(const int& fd)
+: fd(fd), inBuf(NAV_READ_BUF_SIZE), outBuf(NAV_READ_BUF_SIZE) {
+}
+
+// Read from data in memory, which must outlive the buffer.
+NavReadBuf::NavReadBuf(std::span<const std::byte> data)
+: fd(-1), memory(data), inBuf(NAV_READ_BUF_SIZE), outBuf(NAV_READ_BUF_SIZE) {
+}
+
+NavReadBuf::~NavReadBuf() {
+	if (gzipStream) {
+		inflateEnd(gzipStream);
+		delete gzipStream;
+	}
+	#ifdef NAV_ZSTD
+	if (zstdStream) ZSTD_freeDCtx(zstdStream);
+	#endif
+}
+
+// How the data is compressed. Known once the first byte has been read.
+NavCompression NavReadBuf::GetCompression() const {
+	return compression;
+}
+
+// Did reading or decompressing fail (as opposed to reaching the end of the data)?
+bool NavReadBuf::Failed() const {
+	return failed;
+}
+
+/* Copy the next len bytes into out without consuming them.
+Returns false if fewer than len bytes are buffered (which only happens near the end of the data). */
+bool NavReadBuf::Peek(void* out, const size_t& len) {
+	if (gptr() == egptr() && traits_type::eq_int_type(underflow(), traits_type::eof())) return false;
+	if (static_cast<size_t>(egptr() - gptr()) < len) return false;
+	std::memcpy(out, gptr(), len);
+	return true;
+}
+
+// Read up to len bytes from fd (or memory) into out. Returns what read() returns.
+ssize_t NavReadBuf::ReadRaw(char* out, const size_t& len) {
+	if (fd == -1) {
+		const size_t count = std::min(len, memory.size() - memoryPos);
+		std::memcpy(out, memory.data() + memoryPos, count);
+		memoryPos += count;
+		return count;
+	}
+	return read(fd, out, len);
+}
+
+/* Read more data from fd into inBuf, keeping what hasn't been used.
+Returns the number of bytes read, 0 at the end of the data or on failure. */
+size_t NavReadBuf::ReadInput() {
+	if (inputDone || failed) return 0u;
+	// Move what hasn't been used to the front.
+	if (inPos > 0u) {
+		std::memmove(inBuf.data(), inBuf.data() + inPos, inEnd - inPos);
+		inEnd -= inPos;
+		inPos = 0u;
+	}
+	while (true)
+	{
+		ssize_t ret = ReadRaw(inBuf.data() + inEnd, inBuf.size() - inEnd);
+		if (ret == -1 && errno == EINTR) continue;
+		if (ret == -1) {
+			#ifndef NDEBUG
+			std::clog << "NavReadBuf::ReadInput(): " << std::strerror(errno) << "\n";
+			#endif
+			failed = true;
+			return 0u;
+		}
+		if (ret == 0) inputDone = true;
+		inEnd += ret;
+		return ret;
+	}
+}
+
+/* Decompress into outBuf.
+Returns the number of bytes decompressed, 0 at the end of the data or on failure. */
+size_t NavReadBuf::Decompress() {
+	if (failed) return 0u;
+	// Look at the first bytes to see how the data is compressed.
+	if (!detected) {
+		detected = true;
+		while (inEnd < 4u && ReadInput() > 0u);
+		compression = DetectNavCompression(std::as_bytes(std::span(inBuf.data(), inEnd)));
+		if (!IsNavCompressionSupported(compression)) {
+			#ifndef NDEBUG
+			std::clog << "NavReadBuf::Decompress(): zstd support is not built in.\n";
+			#endif
+			failed = true;
+			return 0u;
+		}
+		if (compression == NavCompression::GZIP) {
+			gzipStream = new z_stream{};
+			if (inflateInit2(gzipStream, 15 + 16) != Z_OK) {
+				failed = true;
+				return 0u;
+			}
+		}
+		#ifdef NAV_ZSTD
+		else if (compression == NavCompression::ZSTD) {
+			zstdStream = ZSTD_createDCtx();
+			if (!zstdStream) {
+				failed = true;
+				return 0u;
+			}
+		}
+		#endif
+	}
+	switch (compression)
+	{
+	case NavCompression::NONE:
+		// Hand over what was read to detect the compression, then read straight into outBuf.
+		if (inPos < inEnd) {
+			const size_t count = inEnd - inPos;
+			std::memcpy(outBuf.data(), inBuf.data() + inPos, count);
+			inPos = inEnd;
+			return count;
+		}
+		while (!inputDone)
+		{
+			ssize_t ret = ReadRaw(outBuf.data(), outBuf.size());
+			if (ret == -1 && errno == EINTR) continue;
+			if (ret == -1) {
+				failed = true;
+				return 0u;
+			}
+			if (ret == 0) inputDone = true;
+			return ret;
+		}
+		return 0u;
+	case NavCompression::GZIP:
+		while (true)
+		{
+			if (inPos == inEnd && ReadInput() == 0u) {
+				// A member that ends early means the data was cut short.
+				if (!inputDone || gzipStream->total_in > 0u) failed = true;
+				return 0u;
+			}
+			gzipStream->next_in = reinterpret_cast<Bytef*>(inBuf.data() + inPos);
+			gzipStream->avail_in = inEnd - inPos;
+			gzipStream->next_out = reinterpret_cast<Bytef*>(outBuf.data());
+			gzipStream->avail_out = outBuf.size();
+			int ret = inflate(gzipStream, Z_NO_FLUSH);
+			inPos = inEnd - gzipStream->avail_in;
+			const size_t count = outBuf.size() - gzipStream->avail_out;
+			if (ret == Z_STREAM_END) {
+				// Concatenated gzip files decompress to their concatenated contents.
+				inflateReset(gzipStream);
+			}
+			else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+				#ifndef NDEBUG
+				std::clog << "NavReadBuf::Decompress(): gzip data is corrupt.\n";
+				#endif
+				failed = true;
+				return 0u;
+			}
+			if (count > 0u) return count;
+		}
+	#ifdef NAV_ZSTD
+	case NavCompression::ZSTD:
+		while (true)
+		{
+			if (inPos == inEnd && ReadInput() == 0u) {
+				// A frame that isn't finished means the data was cut short.
+				if (!inputDone || inFrame) failed = true;
+				return 0u;
+			}
+			ZSTD_inBuffer input = {inBuf.data() + inPos, inEnd - inPos, 0u};
+			ZSTD_outBuffer output = {outBuf.data(), outBuf.size(), 0u};
+			const size_t ret = ZSTD_decompressStream(zstdStream, &output, &input);
+			inPos += input.pos;
+			if (ZSTD_isError(ret)) {
+				#ifndef NDEBUG
+				std::clog << "NavReadBuf::Decompress(): zstd data is corrupt: " << ZSTD_getErrorName(ret) << "\n";
+				#endif
+				failed = true;
+				return 0u;
+			}
+			inFrame = ret != 0u;
+			if (output.pos > 0u) return output.pos;
+		}
+	#endif
+	default:
+		break;
+	}
+	return 0u;
+}
+
+std::streambuf::int_type NavReadBuf::underflow() {
+	if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+	getAreaPos += egptr() - eback();
+	const size_t count = Decompress();
+	setg(outBuf.data(), outBuf.data(), outBuf.data() + count);
+	if (count == 0u) return traits_type::eof();
+	return traits_type::to_int_type(*gptr());
+}
+
+std::streambuf::pos_type NavReadBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+	if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+	std::streamoff pos = getAreaPos + (gptr() - eback());
+	std::streamoff target;
+	if (dir == std::ios_base::cur) target = pos + off;
+	else if (dir == std::ios_base::beg) target = off;
+	else return pos_type(off_type(-1));
+	if (target < pos) return pos_type(off_type(-1));
+	// Skip ahead.
+	while (pos < target)
+	{
+		if (gptr() == egptr() && traits_type::eq_int_type(underflow(), traits_type::eof())) return pos_type(off_type(-1));
+		const std::streamoff count = std::min<std::streamoff>(egptr() - gptr(), target - pos);
+		gbump(count);
+		pos += count;
+	}
+	return pos_type(target);
+}
+
+std::streambuf::pos_type NavReadBuf::seekpos(pos_type pos, std::ios_base::openmode which) {
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
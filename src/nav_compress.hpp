@@ -0,0 +1,82 @@
+#ifndef NAV_COMPRESS_HPP
+#define NAV_COMPRESS_HPP
+#include <span>
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <streambuf>
+#include <sys/types.h>
+// Size of the chunks read from the file descriptor (and decompressed into).
+#define NAV_READ_BUF_SIZE (1u << 16)
+// zstd support needs libzstd, so it is only built with NAV_ZSTD defined.
+
+struct z_stream_s;
+struct ZSTD_DCtx_s;
+
+// How a NAV file is compressed.
+enum class NavCompression : unsigned char {
+	NONE,
+	GZIP,
+	ZSTD
+};
+
+// Tell how data is compressed from its first bytes.
+NavCompression DetectNavCompression(std::span<const std::byte> data);
+// Can data compressed this way be read and written?
+bool IsNavCompressionSupported(const NavCompression& compression);
+/* Compress data into out.
+   Returns true on success, false on failure. */
+bool CompressNavData(std::span<const std::byte> data, const NavCompression& compression, std::string& out);
+
+/*
+	Forward-only stream buffer over a file descriptor (or compressed data in memory), for NAV data that can't be read from memory as it is.
+	Compressed (gzip or zstd) data is detected from its first bytes, and decompressed as it is read.
+	Positions are in decompressed bytes. Seeking forward skips data; seeking backward fails.
+*/
+class NavReadBuf : public std::streambuf {
+	private:
+		// -1 when reading from memory.
+		int fd;
+		std::span<const std::byte> memory;
+		size_t memoryPos = 0u;
+		NavCompression compression = NavCompression::NONE;
+		// Data read from fd, and what it decompresses to.
+		std::vector<char> inBuf, outBuf;
+		size_t inPos = 0u, inEnd = 0u;
+		// Position of the start of the get area.
+		std::streamoff getAreaPos = 0;
+		z_stream_s* gzipStream = nullptr;
+		ZSTD_DCtx_s* zstdStream = nullptr;
+		bool detected = false, inputDone = false, failed = false;
+		// Is a zstd frame partly decompressed?
+		bool inFrame = false;
+
+		// Read up to len bytes from fd (or memory) into out. Returns what read() returns.
+		ssize_t ReadRaw(char* out, const size_t& len);
+		/* Read more data from fd into inBuf, keeping what hasn't been used.
+		   Returns the number of bytes read, 0 at the end of the data or on failure. */
+		size_t ReadInput();
+		/* Decompress into outBuf.
+		   Returns the number of bytes decompressed, 0 at the end of the data or on failure. */
+		size_t Decompress();
+	protected:
+		int_type underflow() override;
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which = std::ios_base::in) override;
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in) override;
+	public:
+		// Read from fd, which stays open.
+		NavReadBuf(const int& fd);
+		// Read from data in memory, which must outlive the buffer.
+		NavReadBuf(std::span<const std::byte> data);
+		NavReadBuf(const NavReadBuf&) = delete;
+		NavReadBuf& operator=(const NavReadBuf&) = delete;
+		~NavReadBuf();
+		// How the data is compressed. Known once the first byte has been read.
+		NavCompression GetCompression() const;
+		// Did reading or decompressing fail (as opposed to reaching the end of the data)?
+		bool Failed() const;
+		/* Copy the next len bytes into out without consuming them.
+		   Returns false if fewer than len bytes are buffered (which only happens near the end of the data). */
+		bool Peek(void* out, const size_t& len);
+};
+#endif
@@ -6,7 +6,21 @@
 // Return true if successful.
 bool NavConnection::ReadData(std::streambuf& buf) {
 	if (buf.sgetn(reinterpret_cast<char*>(&TargetAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "NavConnection::ReadData(): Failed to read TargetAreaID!\n";
+		#endif
+		return false;
+	}
+	return true;
+}
+
+// Fill data from memory.
+// Return true if successful.
+bool NavConnection::ReadData(NavBufferReader& buf) {
+	if (!buf.Read(TargetAreaID)) {
+		#ifndef NDEBUG
+		std::cerr << "NavConnection::ReadData(): Failed to read TargetAreaID!\n";
+		#endif
 		return false;
 	}
 	return true;
@@ -16,7 +30,9 @@ bool NavConnection::ReadData(std::streambuf& buf) {
 // Return true if successful, false upon failure.
 bool NavConnection::WriteData(std::streambuf& out) {
 	if (out.sputn(reinterpret_cast<char*>(&TargetAreaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
 		std::cerr << "NavConnection::WriteData(): Could not write area ID";
+		#endif
 		return false;
 	}
 	return true;
@@ -7,12 +7,10 @@ class NavArea;
 #define CONNECTION_SIZE 4
 class NavConnection {
 	public:
-	NavArea *SourceArea; // The starting area for this connection
 	IntID TargetAreaID; // The ID of the target area for this NavConnection
-	NavArea *TargetArea; // The target area for this connection
-	Direction NavDirection; // The direction of the connection between these two areas
 
 	bool ReadData(std::streambuf& buf);
+	bool ReadData(NavBufferReader& buf);
 	bool WriteData(std::streambuf& out);
 
 	bool operator==(const NavConnection& rhs) const;
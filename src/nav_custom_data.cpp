@@ -0,0 +1,96 @@
+#include <array>
+#include <vector>
+#include <cstring>
+#include <iomanip>
+#include "nav_custom_data.hpp"
+#include "nav_codec.hpp"
+
+// Team Fortress 2: TFAttributes (4-byte).
+static constexpr NavCustomDataCodec TeamFortress2Codec = {
+	"Team Fortress 2",
+	VALVE_INT_SIZE,
+	nullptr,
+	[](std::span<std::byte> data) {
+		SwapNavBytes(data.first(std::min<size_t>(data.size(), VALVE_INT_SIZE)), VALVE_INT_SIZE);
+	},
+	[](std::ostream& ostream, std::span<const std::byte> data) {
+		unsigned int TFAttributes = 0u;
+		std::memcpy(&TFAttributes, data.data(), std::min<size_t>(data.size(), VALVE_INT_SIZE));
+		ostream << "\n\t\tTFAttributes Flag: 0x" << std::hex << TFAttributes << std::dec;
+	}
+};
+
+// CS:GO: approach spots, after their count (which is a byte).
+static constexpr NavCustomDataCodec CounterStrikeGlobalOffensiveCodec = {
+	"Counter-Strike: Global Offensive",
+	VALVE_CHAR_SIZE,
+	[](const unsigned char& first) -> size_t {
+		return VALVE_CHAR_SIZE + first * APPROACH_SPOT_SIZE;
+	},
+	[](std::span<std::byte> data) {
+		if (!data.empty()) SwapRecordRun<NavApproachSpot>(data.subspan(VALVE_CHAR_SIZE));
+	},
+	[](std::ostream& ostream, std::span<const std::byte> data) {
+		if (data.empty()) return;
+		std::vector<NavApproachSpot> approachSpots;
+		DecodeRecordRun<NavApproachSpot>(data.subspan(VALVE_CHAR_SIZE), (data.size() - VALVE_CHAR_SIZE) / APPROACH_SPOT_SIZE, approachSpots);
+		ostream << "\n\t\tApproach Spot Count: " << approachSpots.size();
+		for (const NavApproachSpot& approachSpot : approachSpots)
+		{
+			ostream << "\n\t\tApproach Spot (here, previous, next): " << approachSpot.approachHereId << ", " << approachSpot.approachPrevId << ", " << approachSpot.approachNextId
+			<< " (type " << static_cast<int>(approachSpot.approachType) << ", how " << static_cast<int>(approachSpot.approachHow) << ')';
+		}
+	}
+};
+
+// Left 4 Dead 2: spawn attributes (4-byte).
+const NavCustomDataCodec LeftFourDead2Codec = {
+	"Left 4 Dead 2",
+	VALVE_INT_SIZE,
+	nullptr,
+	[](std::span<std::byte> data) {
+		SwapNavBytes(data.first(std::min<size_t>(data.size(), VALVE_INT_SIZE)), VALVE_INT_SIZE);
+	},
+	[](std::ostream& ostream, std::span<const std::byte> data) {
+		unsigned int spawnAttributes = 0u;
+		std::memcpy(&spawnAttributes, data.data(), std::min<size_t>(data.size(), VALVE_INT_SIZE));
+		ostream << "\n\t\tSpawn Attributes Flag: 0x" << std::hex << spawnAttributes << std::dec;
+	}
+};
+
+// Codecs by engine version.
+static std::array<NavCustomDataCodec, EngineVersion::UNKNOWN + 1>& GetCustomDataCodecs() {
+	static std::array<NavCustomDataCodec, EngineVersion::UNKNOWN + 1> codecs = [] {
+		std::array<NavCustomDataCodec, EngineVersion::UNKNOWN + 1> builtIn = {};
+		builtIn[EngineVersion::TEAM_FORTRESS_2] = TeamFortress2Codec;
+		builtIn[EngineVersion::COUNTER_STRIKE_GLOBAL_OFFENSIVE] = CounterStrikeGlobalOffensiveCodec;
+		return builtIn;
+	}();
+	return codecs;
+}
+
+// Get the custom data codec of a NAV version. Versions of games without one get an empty codec.
+const NavCustomDataCodec& GetCustomDataCodec(const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
+	return GetCustomDataCodecs()[GetAsEngineVersion(MajorVersion, MinorVersion)];
+}
+
+// Add or replace the codec of an engine version.
+void RegisterCustomDataCodec(const EngineVersion& engineVersion, const NavCustomDataCodec& codec) {
+	GetCustomDataCodecs()[engineVersion] = codec;
+}
+
+// Output an area's custom data, with the codec of its NAV version.
+void OutputCustomData(std::ostream& ostream, std::span<const std::byte> data, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion) {
+	const NavCustomDataCodec& codec = GetCustomDataCodec(MajorVersion, MinorVersion);
+	ostream << "\tCustom Data: ";
+	if (codec.Name) ostream << '(' << codec.Name << ')';
+	else if (data.empty()) ostream << "(None)";
+	else ostream << "(Unknown custom data.)";
+	if (codec.OutputArea) codec.OutputArea(ostream, data);
+	else if (!data.empty()) {
+		ostream << "\n\t\t";
+		for (const std::byte& b : data) ostream << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
+		ostream << std::dec << std::setfill(' ');
+	}
+	ostream << '\n';
+}
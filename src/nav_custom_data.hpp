@@ -0,0 +1,41 @@
+#ifndef NAV_CUSTOM_DATA_HPP
+#define NAV_CUSTOM_DATA_HPP
+#include <span>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include "nav_base.hpp"
+
+/*
+	How a game stores its own data in NAV files. Every area ends with custom data, and the file can have
+	a section of it between the places and the area count (pre-area data).
+	Codecs are looked up by engine version. Data of games without a codec, or parts a codec doesn't decode,
+	is passed through as it is. Data after the ladders (trailing data) is always passed through.
+*/
+struct NavCustomDataCodec {
+	// Name of the game, for output.
+	const char* Name = nullptr;
+	// Fewest bytes of custom data an area has.
+	size_t AreaMinSize = 0u;
+	// Size of an area's custom data, from its first byte. AreaMinSize if not set.
+	size_t (*AreaSize)(const unsigned char& first) = nullptr;
+	// Swap the byte order of an area's custom data, in place. Left as it is if not set.
+	void (*SwapArea)(std::span<std::byte> data) = nullptr;
+	// Output an area's custom data, decoded. Output as raw bytes if not set.
+	void (*OutputArea)(std::ostream& ostream, std::span<const std::byte> data) = nullptr;
+	// Size of the pre-area data.
+	size_t PreAreaSize = 0u;
+};
+
+/* Left 4 Dead 2 spawn attributes, as 4 bytes at the end of each area of version 16/14 files.
+   The layout isn't confirmed against a real L4D2 mesh, so it isn't registered by default.
+   Register it for EngineVersion::LEFT_4_DEAD_2 to use it. */
+extern const NavCustomDataCodec LeftFourDead2Codec;
+// Get the custom data codec of a NAV version. Versions of games without one get an empty codec.
+const NavCustomDataCodec& GetCustomDataCodec(const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
+// Add or replace the codec of an engine version.
+// Not thread-safe: register codecs before reading any files.
+void RegisterCustomDataCodec(const EngineVersion& engineVersion, const NavCustomDataCodec& codec);
+// Output an area's custom data, with the codec of its NAV version.
+void OutputCustomData(std::ostream& ostream, std::span<const std::byte> data, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion);
+#endif
@@ -1,12 +1,25 @@
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <array>
 #include <iostream>
 #include <exception>
 #include <bit>
 #include <unistd.h>
+#include <fcntl.h>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
 #include <functional>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <type_traits>
 #include "nav_file.hpp"
 #include "nav_area.hpp"
+#include "nav_codec.hpp"
+#include "nav_custom_data.hpp"
 
 NavFile::NavFile() {}
 
@@ -56,6 +69,18 @@ unsigned int NavFile::GetLadderCount() {
 	return LadderCount;
 }
 
+bool NavFile::IsLadderCountKnown() {
+	return LadderCountKnown;
+}
+
+std::vector<std::byte>& NavFile::GetPreAreaData() {
+	return PreAreaData;
+}
+
+std::vector<std::byte>& NavFile::GetTrailingData() {
+	return TrailingData;
+}
+
 const std::streampos& NavFile::GetAreaDataLoc() {
 	return AreaDataLoc;
 }
@@ -64,20 +89,52 @@ const std::streampos& NavFile::GetLadderDataLoc() {
 	return LadderDataLoc;
 }
 
-/* Write header info.
+unsigned int NavFile::GetThreadCount() {
+	return ThreadCount;
+}
+
+void NavFile::SetThreadCount(const unsigned int& threadCount) {
+	ThreadCount = threadCount;
+}
+
+NavCompression NavFile::GetCompression() {
+	return Compression;
+}
+
+// Set how the file is compressed when saved.
+void NavFile::SetCompression(const NavCompression& compression) {
+	Compression = compression;
+}
+
+std::endian NavFile::GetByteOrder() {
+	return ByteOrder;
+}
+
+// Set the byte order the file is saved in.
+void NavFile::SetByteOrder(const std::endian& byteOrder) {
+	ByteOrder = byteOrder;
+}
+
+// Number of threads to split count areas over. 1 if they should be handled serially.
+unsigned int NavFile::GetAreaThreadCount(const size_t& count) {
+	unsigned int threadCount = ThreadCount > 0u ? ThreadCount : std::thread::hardware_concurrency();
+	return std::max(1u, std::min<unsigned int>(threadCount, count / NAV_PARALLEL_MIN_AREAS));
+}
+
+/* Write the header, up to and including the area count.
 Returns true on success, false on failure. */
-bool NavFile::WriteData(std::streambuf& buf) {
+bool NavFile::WriteHeader(std::streambuf& buf) {
 	// Write header.
 	if (buf.sputn(reinterpret_cast<char*>(&MagicNumber), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
 		#ifndef NDEBUG
-		std::cerr << "NavFile::WriteData(): failed to write magic number.\n";
+		std::cerr << "NavFile::WriteHeader(): failed to write magic number.\n";
 		#endif
 		return false;
 	}
 	// Write major version.
 	if (buf.sputn(reinterpret_cast<char*>(&MajorVersion), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
 		#ifndef NDEBUG
-		std::cerr << "NavFile::WriteData(): failed to write major version.\n";
+		std::cerr << "NavFile::WriteHeader(): failed to write major version.\n";
 		#endif
 		return false;
 	}
@@ -86,7 +143,7 @@ bool NavFile::WriteData(std::streambuf& buf) {
 		unsigned int tmp = MinorVersion.value_or(0u);
 		if (MajorVersion >= 10 && buf.sputn(reinterpret_cast<char*>(&tmp), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
 			#ifndef NDEBUG
-			std::cerr << "NavFile::WriteData(): failed to write minor version.\n";
+			std::cerr << "NavFile::WriteHeader(): failed to write minor version.\n";
 			#endif
 			return false;
 		}
@@ -95,7 +152,7 @@ bool NavFile::WriteData(std::streambuf& buf) {
 		tmp = BSPSize.value_or(0u);
 		if (MajorVersion >= 4 && buf.sputn(reinterpret_cast<char*>(&tmp), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
 			#ifndef NDEBUG
-			std::cerr << "NavFile::WriteData(): failed to write BSP size.\n";
+			std::cerr << "NavFile::WriteHeader(): failed to write BSP size.\n";
 			#endif
 			return false;
 		}
@@ -105,7 +162,7 @@ bool NavFile::WriteData(std::streambuf& buf) {
 		bool tmp = isAnalyzed.value_or(false);
 		if (MajorVersion >= 4 && buf.sputc(tmp) == EOF) {
 			#ifndef NDEBUG
-			std::cerr << "NavFile::WriteData(): failed to write analyzed boolean.\n";
+			std::cerr << "NavFile::WriteHeader(): failed to write analyzed boolean.\n";
 			#endif
 			return false;
 		}
@@ -115,7 +172,7 @@ bool NavFile::WriteData(std::streambuf& buf) {
 	if (MajorVersion >= 5)  {
 		if (buf.sputn(reinterpret_cast<char*>(&PlaceCount), VALVE_SHORT_SIZE) != VALVE_SHORT_SIZE) {
 			#ifndef NDEBUG
-			std::cerr << "NavFile::WriteData(): failed to write place count.\n";
+			std::cerr << "NavFile::WriteHeader(): failed to write place count.\n";
 			#endif
 			return false;
 		}
@@ -126,20 +183,20 @@ bool NavFile::WriteData(std::streambuf& buf) {
 				unsigned short placeNameLength = std::clamp<unsigned short>(placeName.length(), 0u, UINT16_MAX);
 				if (buf.sputn(reinterpret_cast<char*>(&placeNameLength), VALVE_SHORT_SIZE) != VALVE_SHORT_SIZE) {
 					#ifndef NDEBUG
-					std::cerr << "NavFile::WriteData(): failed to write place name length.\n";
+					std::cerr << "NavFile::WriteHeader(): failed to write place name length.\n";
 					#endif
 					return false;
 				}
 				if (buf.sputn(placeName.data(), placeNameLength) != placeNameLength) {
 					#ifndef NDEBUG
-					std::cerr << "NavFile::WriteData(): failed to write place name.\n";
+					std::cerr << "NavFile::WriteHeader(): failed to write place name.\n";
 					#endif
 					return false;
 				}
 				return true;
 			})) {
 				#ifndef NDEBUG
-				std::cerr << "NavFile::WriteData(): failed to write place data.\n";
+				std::cerr << "NavFile::WriteHeader(): failed to write place data.\n";
 				#endif
 				return false;
 			}
@@ -148,20 +205,34 @@ bool NavFile::WriteData(std::streambuf& buf) {
 		// Has unnamed areas?
 		if (MajorVersion > 11 && buf.sputc(hasUnnamedAreas.value_or(false)) == EOF) {
 			#ifndef NDEBUG
-			std::cerr << "NavFile::WriteData(): Could not write 'unnamed areas exist' boolean.\n";
+			std::cerr << "NavFile::WriteHeader(): Could not write 'unnamed areas exist' boolean.\n";
 			#endif
 			return false;
 		}
 	}
-	
+	// Write pre-area data. Missing data is written blank.
+	PreAreaData.resize(GetCustomDataCodec(MajorVersion, MinorVersion).PreAreaSize);
+	if (buf.sputn(reinterpret_cast<char*>(PreAreaData.data()), PreAreaData.size()) != static_cast<std::streamsize>(PreAreaData.size())) {
+		#ifndef NDEBUG
+		std::cerr << "NavFile::WriteHeader(): Could not write pre-area data.\n";
+		#endif
+		return false;
+	}
 	// Write area count.
 	if (buf.sputn(reinterpret_cast<char*>(&AreaCount), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
 		#ifndef NDEBUG
-		std::cerr << "NavFile::WriteData(): Could not write area count.\n";
+		std::cerr << "NavFile::WriteHeader(): Could not write area count.\n";
 		#endif
 		return false;
 	}
-	AreaDataLoc = buf.pubseekoff(0, std::ios_base::cur);
+	AreaDataLoc = buf.pubseekoff(0, std::ios_base::cur, std::ios_base::out);
+	return true;
+}
+
+/* Write header info.
+Returns true on success, false on failure. */
+bool NavFile::WriteData(std::streambuf& buf) {
+	if (!WriteHeader(buf)) return false;
 	// Writes area data.
 	if (AreaCount > 0u) {
 		if (!areas.has_value()) areas = std::vector<NavArea>(AreaCount);
@@ -188,33 +259,122 @@ bool NavFile::WriteData(std::streambuf& buf) {
 		#endif
 		return false;
 	}
-	LadderDataLoc = buf.pubseekoff(0, std::ios_base::cur);
-	for (auto& ladder : ladders)
+	LadderDataLoc = buf.pubseekoff(0, std::ios_base::cur, std::ios_base::out);
+	if (!WriteRecordRun<NavLadder>(buf, LadderCount, ladders))
 	{
-		if (!ladder.WriteData(buf))
+		#ifndef NDEBUG
+		std::clog << "NavFile::WriteData(): Could not write ladder data.\n";
+		#endif
+		return false;
+	}
+	if (buf.sputn(reinterpret_cast<const char*>(TrailingData.data()), TrailingData.size()) != static_cast<std::streamsize>(TrailingData.size())) {
+		#ifndef NDEBUG
+		std::clog << "NavFile::WriteData(): Could not write trailing data.\n";
+		#endif
+		return false;
+	}
+	return true;
+}
+
+/* Serialize the whole file into out, which is sized exactly once.
+Area sizes are computed up front, so large meshes are encoded on several threads, each into its own slice of out.
+Returns true on success, false on failure. */
+bool NavFile::SerializeData(std::string& out) {
+	std::stringbuf headerBuf(std::ios_base::out);
+	if (!WriteHeader(headerBuf)) return false;
+	const std::string header = std::move(headerBuf).str();
+	if (AreaCount > 0u && !areas.has_value()) areas = std::vector<NavArea>(AreaCount);
+	const size_t areaCount = AreaCount > 0u ? areas.value().size() : 0u;
+	// Where every area starts.
+	std::vector<size_t> areaOffsets(areaCount + 1u);
+	areaOffsets[0] = header.size();
+	for (size_t index = 0u; index < areaCount; index++)
+	{
+		areaOffsets[index + 1u] = areaOffsets[index] + areas.value()[index].GetDataSize(MajorVersion, MinorVersion);
+	}
+	const size_t ladderSize = VALVE_INT_SIZE + static_cast<size_t>(LadderCount) * LADDER_SIZE;
+	out.resize(areaOffsets[areaCount] + ladderSize + TrailingData.size());
+	std::span<std::byte> data = std::as_writable_bytes(std::span(out));
+	std::memcpy(data.data(), header.data(), header.size());
+
+	// Encode runs of areas.
+	const unsigned int threadCount = GetAreaThreadCount(areaCount);
+	const size_t runLength = (areaCount + threadCount - 1u) / threadCount;
+	std::vector<size_t> failedIndex(threadCount, areaCount);
+	auto encodeRun = [&](const unsigned int run) {
+		const size_t first = std::min<size_t>(run * runLength, areaCount), last = std::min<size_t>(first + runLength, areaCount);
+		for (size_t index = first; index < last; index++)
 		{
+			// The area must fill its slice exactly.
+			NavBufferWriter areaBuf(data.subspan(areaOffsets[index], areaOffsets[index + 1u] - areaOffsets[index]));
+			if (!areas.value()[index].WriteData(areaBuf, MajorVersion, MinorVersion) || areaBuf.Tell() != areaOffsets[index + 1u] - areaOffsets[index]) {
+				failedIndex[run] = index;
+				return;
+			}
+		}
+	};
+	if (threadCount > 1u) {
+		std::vector<std::thread> workers;
+		workers.reserve(threadCount - 1u);
+		for (unsigned int run = 1u; run < threadCount; run++) workers.emplace_back(encodeRun, run);
+		encodeRun(0u);
+		for (std::thread& worker : workers) worker.join();
+	}
+	else encodeRun(0u);
+	for (const size_t& index : failedIndex)
+	{
+		if (index < areaCount) {
 			#ifndef NDEBUG
-			std::clog << "NavFile::WriteData(): Could not write ladder data.\n";
+			std::cerr << "NavFile::SerializeData(index "<<std::to_string(index)<<"): Failed to write area data.\n";
 			#endif
 			return false;
 		}
 	}
+
+	// Ladders, then trailing data.
+	NavBufferWriter ladderBuf(data.subspan(areaOffsets[areaCount]));
+	if (ladderBuf.sputn(reinterpret_cast<char*>(&LadderCount), VALVE_INT_SIZE) != VALVE_INT_SIZE || !WriteRecordRun<NavLadder>(ladderBuf, LadderCount, ladders)) {
+		#ifndef NDEBUG
+		std::clog << "NavFile::SerializeData(): Could not write ladder data.\n";
+		#endif
+		return false;
+	}
+	if (!TrailingData.empty()) std::memcpy(data.data() + areaOffsets[areaCount] + ladderSize, TrailingData.data(), TrailingData.size());
+	LadderDataLoc = areaOffsets[areaCount] + VALVE_INT_SIZE;
 	return true;
 }
-/* Read header info.
+
+// Raw bytes and values of a stream or of NAV data in memory.
+static bool ReadBytes(std::streambuf& buf, void* data, const size_t& size) {
+	return static_cast<size_t>(buf.sgetn(reinterpret_cast<char*>(data), size)) == size;
+}
+
+static bool ReadBytes(NavBufferReader& buf, void* data, const size_t& size) {
+	return buf.ReadBytes(data, size);
+}
+
+template<typename Buffer, typename T>
+static bool ReadValue(Buffer& buf, T& value) {
+	return ReadBytes(buf, &value, sizeof(T));
+}
+
+/* Read the header from a stream (counting what is read) or from NAV data in memory, up to and including the area count.
 Returns true on success, false on failure. */
-bool NavFile::ReadData(std::streambuf& buf) {
+template<typename Buffer>
+bool NavFile::ReadHeaderData(Buffer& buf) {
+	// The rest of the file is read after the header.
+	LadderCountKnown = true;
 	// Read header.
-	if (buf.sgetn(reinterpret_cast<char*>(&MagicNumber), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+	if (!ReadValue(buf, MagicNumber)) {
 		#ifndef NDEBUG
-		std::cerr << "NavFile::ReadData(): failed to write magic number.\n";
+		std::cerr << "NavFile::ReadHeader(): failed to read magic number.\n";
 		#endif
 		return false;
 	}
 	// Read major version.
-	if (buf.sgetn(reinterpret_cast<char*>(&MajorVersion), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+	if (!ReadValue(buf, MajorVersion)) {
 		#ifndef NDEBUG
-		std::cerr << "NavFile::ReadData(): failed to write major version.\n";
+		std::cerr << "NavFile::ReadHeader(): failed to read major version.\n";
 		#endif
 		return false;
 	}
@@ -222,9 +382,9 @@ bool NavFile::ReadData(std::streambuf& buf) {
 	{
 		unsigned int tmp;
 		if (MajorVersion >= 10) {
-			if (buf.sgetn(reinterpret_cast<char*>(&tmp), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+			if (!ReadValue(buf, tmp)) {
 				#ifndef NDEBUG
-				std::cerr << "NavFile::ReadData(): failed to write minor version.\n";
+				std::cerr << "NavFile::ReadHeader(): failed to read minor version.\n";
 				#endif
 				return false;
 			}
@@ -233,30 +393,35 @@ bool NavFile::ReadData(std::streambuf& buf) {
 
 		// Read BSPSize if major version is ≥4.
 		if (MajorVersion >= 4) {
-			if (buf.sgetn(reinterpret_cast<char*>(&tmp), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+			if (!ReadValue(buf, tmp)) {
 				#ifndef NDEBUG
-				std::cerr << "NavFile::ReadData(): failed to write BSP size.\n";
+				std::cerr << "NavFile::ReadHeader(): failed to read BSP size.\n";
 				#endif
 				return false;
 			}
 			BSPSize = tmp;
 		}
 	}
-	// Read analyzed boolean if major version is ≥14.
-	{
-		if (MajorVersion >= 4 && (isAnalyzed = buf.sbumpc()) == EOF) {
+	// Read analyzed boolean.
+	if (MajorVersion >= 4) {
+		unsigned char tmp;
+		if (!ReadValue(buf, tmp)) {
 			#ifndef NDEBUG
-			std::cerr << "NavFile::ReadData(): failed to read analyzed boolean.\n";
+			std::cerr << "NavFile::ReadHeader(): failed to read analyzed boolean.\n";
 			#endif
 			return false;
 		}
+		isAnalyzed = tmp;
 	}
 
 	// Read place count.
 	if (MajorVersion >= 5)  {
-		if (buf.sgetn(reinterpret_cast<char*>(&PlaceCount), VALVE_SHORT_SIZE) != VALVE_SHORT_SIZE) {
+		// Each place name takes up at least its length. Streams can't tell how much data is left.
+		bool readPlaceCount = ReadValue(buf, PlaceCount);
+		if constexpr (std::is_same_v<Buffer, NavBufferReader>) readPlaceCount = readPlaceCount && PlaceCount <= buf.Remaining() / VALVE_SHORT_SIZE;
+		if (!readPlaceCount) {
 			#ifndef NDEBUG
-			std::clog << "NavFile::ReadData(): failed to read place count.\n";
+			std::clog << "NavFile::ReadHeader(): failed to read place count.\n";
 			#endif
 			return false;
 		}
@@ -266,17 +431,16 @@ bool NavFile::ReadData(std::streambuf& buf) {
 		// Read place data.
 		for (unsigned int i = 0u; i < PlaceCount; i++) {
 			unsigned short placeNameLength;
-			if (buf.sgetn(reinterpret_cast<char*>(&placeNameLength), VALVE_SHORT_SIZE) != VALVE_SHORT_SIZE) {
+			if (!ReadValue(buf, placeNameLength)) {
 				#ifndef NDEBUG
-				std::clog << "NavFile::ReadData(): failed to read place name length.\n";
+				std::clog << "NavFile::ReadHeader(): failed to read place name length.\n";
 				#endif
 				return false;
 			}
-			//std::vector<char> placeNameBuf[256];
 			PlaceNames.at(i).resize(placeNameLength);
-			if (buf.sgetn(PlaceNames.at(i).data(), placeNameLength) != placeNameLength) {
+			if (!ReadBytes(buf, PlaceNames.at(i).data(), placeNameLength)) {
 				#ifndef NDEBUG
-				std::clog << "NavFile::ReadData(): failed to read place name.\n";
+				std::clog << "NavFile::ReadHeader(): failed to read place name.\n";
 				#endif
 				return false;
 			}
@@ -284,51 +448,73 @@ bool NavFile::ReadData(std::streambuf& buf) {
 
 		// Read has unnamed areas?
 		if (MajorVersion > 11) {
-			hasUnnamedAreas = buf.sbumpc();
-			if (hasUnnamedAreas == EOF) {
+			unsigned char tmp;
+			if (!ReadValue(buf, tmp)) {
 				#ifndef NDEBUG
-				std::clog << "NavFile::ReadData(): Could not read 'unnamed areas exist' boolean.\n";
+				std::clog << "NavFile::ReadHeader(): Could not read 'unnamed areas exist' boolean.\n";
 				#endif
 				return false;
 			}
+			hasUnnamedAreas = tmp;
 		}
 	}
-	/*
-		NOTE: Left 4 Dead and some games load custom data here.
-		Not really sure how to implement the reading though, so just assume that there's no custom data here for now.
-	*/
+	// Read pre-area data.
+	PreAreaData.resize(GetCustomDataCodec(MajorVersion, MinorVersion).PreAreaSize);
+	if (!ReadBytes(buf, PreAreaData.data(), PreAreaData.size())) {
+		#ifndef NDEBUG
+		std::clog << "NavFile::ReadHeader(): Could not read pre-area data.\n";
+		#endif
+		return false;
+	}
 	// Read area count.
-	if (buf.sgetn(reinterpret_cast<char*>(&AreaCount), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+	if (!ReadValue(buf, AreaCount)) {
 		#ifndef NDEBUG
-		std::clog << "NavFile::ReadData(): Could not read area count.\n";
+		std::clog << "NavFile::ReadHeader(): Could not read area count.\n";
 		#endif
 		return false;
 	}
 
-	AreaDataLoc = buf.pubseekoff(0, std::ios_base::cur);
-	// Reserve memory for areas.
-	if (!areas.has_value()) areas = std::vector<NavArea>(AreaCount);
-	else {
-		areas.value().clear();
-		areas.value().resize(AreaCount);
-	}
+	if constexpr (std::is_same_v<Buffer, NavBufferReader>) AreaDataLoc = buf.Tell();
+	else AreaDataLoc = buf.GetCount();
+	return true;
+}
+
+/* Read the header, up to and including the area count.
+buf must be at the start of the file. It is only read forward, so it can be a pipe.
+Returns true on success, false on failure. */
+bool NavFile::ReadHeader(std::streambuf& source) {
+	// Count what is read to find where the area data starts.
+	NavCountingBuf buf(source);
+	return ReadHeaderData(buf);
+}
+
+/* Read the header from NAV data in memory, up to and including the area count.
+Returns true on success, false on failure. */
+bool NavFile::ReadHeader(NavBufferReader& buf) {
+	return ReadHeaderData(buf);
+}
+
+/* Read header info. buf is only read forward, so it can be a pipe.
+Returns true on success, false on failure. */
+bool NavFile::ReadData(std::streambuf& buf) {
+	SourceState.reset();
+	if (!ReadHeader(buf)) return false;
+	// Reserve memory for areas. The size of the area data isn't known here, so neither is how many areas it can hold:
+	// areas are added as they are read, with no more than NAV_STREAM_RESERVE_SIZE reserved up front.
+	AllocateAreas(1u, 0u, 0u);
+	areas.value().reserve(std::min<size_t>(AreaCount, NAV_STREAM_RESERVE_SIZE / sizeof(NavArea)));
 	// Store area data.
-	unsigned int index = 0u;
-	if (!std::all_of(areas.value().begin(), areas.value().end(), [&buf, &majV = MajorVersion, &minV = MinorVersion, &index](NavArea& area) mutable {
-		if (area.ReadData(buf, majV, minV)) {
-			index++;
-			return true;
-		}
-		else {
+	for (unsigned int index = 0u; index < AreaCount; index++)
+	{
+		if (!areas.value().emplace_back(arenas.resources.back().get()).ReadData(buf, MajorVersion, MinorVersion)) {
 			#ifndef NDEBUG
 			std::clog << "NavFile::ReadData(index "<<std::to_string(index)<<"): failed to read area data.\n";
 			#endif
 			return false;
 		}
-	}))
-	{
-		return false;
 	}
+	SetAreaSources();
+	IndexAreas();
 
 	// Read ladder count.
 	if (buf.sgetn(reinterpret_cast<char*>(&LadderCount), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
@@ -337,28 +523,797 @@ bool NavFile::ReadData(std::streambuf& buf) {
 		#endif
 		return false;
 	}
+	LadderDataLoc = static_cast<std::streamoff>(AreaDataLoc) + static_cast<std::streamoff>(std::accumulate(areas.value().begin(), areas.value().end(), size_t(0u), [](const size_t& sum, const NavArea& area) { return sum + area.size; })) + VALVE_INT_SIZE;
 	// Store ladder data.
-	ladders.clear();
-	ladders.resize(LadderCount);
-	for (auto& ladder : ladders)
+	if (!ReadRecordRun<NavLadder>(buf, LadderCount, ladders)) {
+		#ifndef NDEBUG
+		std::clog << "NavFile::ReadData(): Could not read ladder data.\n";
+		#endif
+		return false;
+	}
+	// Keep whatever follows as trailing data.
+	TrailingData.clear();
+	std::streamsize count;
+	do {
+		const size_t size = TrailingData.size();
+		TrailingData.resize(size + NAV_STREAM_RESERVE_SIZE);
+		count = buf.sgetn(reinterpret_cast<char*>(TrailingData.data() + size), NAV_STREAM_RESERVE_SIZE);
+		TrailingData.resize(size + count);
+	} while (count == NAV_STREAM_RESERVE_SIZE);
+	TrailingData.shrink_to_fit();
+	// Done
+	return true;
+}
+
+/* Read header info from NAV data in memory.
+Returns true on success, false on failure. */
+bool NavFile::ReadData(NavBufferReader& buf) {
+	SourceState.reset();
+	if (!ReadHeader(buf)) return false;
+	// Every area takes up some bytes, so a count the data can't hold is corrupt. Checked before allocating for it.
+	if (AreaCount > buf.Remaining() / NavArea::GetMinDataSize(MajorVersion, MinorVersion)) {
+		#ifndef NDEBUG
+		std::clog << "NavFile::ReadData(): Area count is larger than the data can hold.\n";
+		#endif
+		return false;
+	}
+	// Store area data. Large meshes are split across threads.
+	const unsigned int threadCount = GetAreaThreadCount(AreaCount);
+	// Reserve memory for areas.
+	AllocateAreas(threadCount, buf.Remaining(), AreaCount);
+	if (threadCount > 1u) {
+		if (!ReadAreaDataParallel(buf, threadCount)) return false;
+	}
+	else for (size_t index = 0u; index < AreaCount; index++)
 	{
-		if (!ladder.ReadData(buf)) {
+		if (!areas.value()[index].ReadData(buf, MajorVersion, MinorVersion)) {
 			#ifndef NDEBUG
-			std::clog << "NavFile::ReadData(): Could not read ladder data.\n";
+			std::clog << "NavFile::ReadData(index "<<std::to_string(index)<<"): failed to read area data.\n";
 			#endif
 			return false;
 		}
 	}
-	
-	// Assume that remaining data left is custom data.
+	SetAreaSources();
+	IndexAreas();
+
+	// Read ladder count.
+	if (!buf.Read(LadderCount)) {
+		#ifndef NDEBUG
+		std::clog << "NavFile::ReadData(): Could not read ladder count.\n";
+		#endif
+		return false;
+	}
+	LadderDataLoc = buf.Tell();
+	// Store ladder data.
+	if (!ReadRecordRun<NavLadder>(buf, LadderCount, ladders)) {
+		#ifndef NDEBUG
+		std::clog << "NavFile::ReadData(): Could not read ladder data.\n";
+		#endif
+		return false;
+	}
+	// Keep whatever follows as trailing data.
+	std::span<const std::byte> trailingData = buf.ReadSpan(buf.Remaining()).value();
+	TrailingData.assign(trailingData.begin(), trailingData.end());
 	// Done
 	return true;
 }
 
+/* Replace the area container with count empty areas.
+The areas are split into runCount runs (as ReadAreaDataParallel() splits them), each drawing from its own arena.
+dataSize is the size of the area data, used to size the arenas. */
+void NavFile::AllocateAreas(const unsigned int& runCount, const size_t& dataSize, const size_t& count) {
+	// Drop the old areas before the arenas they use.
+	areas.reset();
+	arenas.resources.clear();
+	areas.emplace();
+	areas.value().reserve(count);
+	const size_t runLength = (count + runCount - 1u) / runCount;
+	for (unsigned int run = 0u; run < runCount; run++)
+	{
+		// Decoded areas take up about as much as their data.
+		arenas.resources.push_back(std::make_shared<std::pmr::monotonic_buffer_resource>(std::max<size_t>(dataSize / runCount, 1u)));
+		for (size_t index = run * runLength; index < std::min<size_t>((run + 1u) * runLength, count); index++) areas.value().emplace_back(arenas.resources.back().get());
+	}
+}
+
+/* Decode AreaCount areas from buf on threadCount threads.
+Area boundaries are found with a serial scan first, then each thread decodes a run of areas.
+Returns true on success, false on failure. */
+bool NavFile::ReadAreaDataParallel(NavBufferReader& buf, const unsigned int& threadCount) {
+	// Find where every area starts.
+	std::vector<size_t> boundaries(AreaCount + 1u);
+	for (size_t index = 0u; index < AreaCount; index++)
+	{
+		boundaries[index] = buf.Tell();
+		if (!TraverseNavAreaData(buf).has_value()) {
+			#ifndef NDEBUG
+			std::clog << "NavFile::ReadAreaDataParallel(index "<<std::to_string(index)<<"): area data is cut short.\n";
+			#endif
+			return false;
+		}
+	}
+	boundaries[AreaCount] = buf.Tell();
+
+	// Decode runs of areas. Each run gets its own reader, so the areas decode exactly as they would serially.
+	const size_t runLength = (AreaCount + threadCount - 1u) / threadCount;
+	std::vector<size_t> failedIndex(threadCount, AreaCount);
+	auto decodeRun = [&](const unsigned int run) {
+		const size_t first = std::min<size_t>(run * runLength, AreaCount), last = std::min<size_t>(first + runLength, AreaCount);
+		NavBufferReader runReader(buf.GetData().subspan(boundaries[first], boundaries[last] - boundaries[first]));
+		for (size_t index = first; index < last; index++)
+		{
+			// The decoded size must agree with the boundary scan.
+			if (!areas.value()[index].ReadData(runReader, MajorVersion, MinorVersion) || areas.value()[index].size != boundaries[index + 1u] - boundaries[index]) {
+				failedIndex[run] = index;
+				return;
+			}
+		}
+	};
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount - 1u);
+	for (unsigned int run = 1u; run < threadCount; run++) workers.emplace_back(decodeRun, run);
+	decodeRun(0u);
+	for (std::thread& worker : workers) worker.join();
+
+	for (const size_t& index : failedIndex)
+	{
+		if (index < AreaCount) {
+			#ifndef NDEBUG
+			std::clog << "NavFile::ReadAreaDataParallel(index "<<std::to_string(index)<<"): failed to read area data.\n";
+			#endif
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Swap the byte order of a whole NAV file in memory, in place: to the host's if toHost is true, from it otherwise.
+Pre-area and trailing data are left as they are.
+Returns true on success, false if the data is cut short. */
+bool NavFile::SwapByteOrder(std::span<std::byte> data, const bool& toHost) {
+	size_t pos = 0u;
+	// Swap the next field, and get it in the host's order.
+	auto swapField = [&data, &pos, &toHost](auto& value) -> bool {
+		if (sizeof(value) > data.size() - pos) return false;
+		std::span<std::byte> field = data.subspan(pos, sizeof(value));
+		if (toHost) SwapNavBytes(field, sizeof(value));
+		std::memcpy(&value, field.data(), sizeof(value));
+		if (!toHost) SwapNavBytes(field, sizeof(value));
+		pos += sizeof(value);
+		return true;
+	};
+	unsigned int magicNumber, majorVersion, value;
+	if (!swapField(magicNumber) || !swapField(majorVersion)) return false;
+	std::optional<unsigned int> minorVersion;
+	if (majorVersion >= 10) {
+		if (!swapField(value)) return false;
+		minorVersion = value;
+	}
+	// BSP size and analyzed boolean.
+	if (majorVersion >= 4 && (!swapField(value) || ++pos > data.size())) return false;
+	if (majorVersion >= 5) {
+		unsigned short placeCount, placeNameLength;
+		if (!swapField(placeCount)) return false;
+		for (unsigned short i = 0u; i < placeCount; i++)
+		{
+			if (!swapField(placeNameLength) || placeNameLength > data.size() - pos) return false;
+			pos += placeNameLength;
+		}
+		// Has unnamed areas boolean.
+		if (majorVersion > 11 && ++pos > data.size()) return false;
+	}
+	// Pre-area data is left as it is.
+	const size_t preAreaSize = GetCustomDataCodec(majorVersion, minorVersion).PreAreaSize;
+	if (preAreaSize > data.size() - pos) return false;
+	pos += preAreaSize;
+	unsigned int areaCount, ladderCount;
+	if (!swapField(areaCount)) return false;
+	for (unsigned int i = 0u; i < areaCount; i++)
+	{
+		std::optional<size_t> areaSize = NavArea::SwapByteOrder(data.subspan(pos), toHost, majorVersion, minorVersion);
+		if (!areaSize.has_value()) {
+			#ifndef NDEBUG
+			std::clog << "NavFile::SwapByteOrder(index "<<std::to_string(i)<<"): Area data is cut short.\n";
+			#endif
+			return false;
+		}
+		pos += areaSize.value();
+	}
+	if (!swapField(ladderCount) || static_cast<size_t>(ladderCount) * LADDER_SIZE > data.size() - pos) return false;
+	SwapRecordRun<NavLadder>(data.subspan(pos, static_cast<size_t>(ladderCount) * LADDER_SIZE));
+	return true;
+}
+
+/* Swap data (a whole file) to the host's byte order, then pass it to read as a NavBufferReader.
+Returns what read returns, or false if the data is cut short. */
+template<typename Read>
+bool NavFile::ReadSwapped(std::vector<std::byte>& data, Read&& read) {
+	ByteOrder = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+	if (!SwapByteOrder(data, true)) {
+		#ifndef NDEBUG
+		std::clog << "NavFile::ReadSwapped(): Could not swap the byte order of NAV data.\n";
+		#endif
+		return false;
+	}
+	NavBufferReader reader(data);
+	return read(reader);
+}
+
+/* Pass the data of inBuf to read, as it is decompressed. Data in the other byte order than the host's is read into memory and swapped first.
+Sets the compression and byte order to the data's.
+Returns what read returns, or false if inBuf fails. */
+template<typename Read>
+bool NavFile::ReadStream(NavReadBuf& inBuf, Read&& read) {
+	bool success;
+	std::array<std::byte, VALVE_INT_SIZE> magic;
+	if (inBuf.Peek(magic.data(), magic.size()) && DetectNavByteOrder(magic).value_or(std::endian::native) != std::endian::native) {
+		// Swapping needs the whole file, so read it all.
+		std::vector<std::byte> data;
+		std::streamsize count;
+		do {
+			data.resize(data.size() + NAV_READ_BUF_SIZE);
+			count = inBuf.sgetn(reinterpret_cast<char*>(data.data() + data.size() - NAV_READ_BUF_SIZE), NAV_READ_BUF_SIZE);
+			data.resize(data.size() - NAV_READ_BUF_SIZE + count);
+		} while (count == NAV_READ_BUF_SIZE);
+		success = !inBuf.Failed() && ReadSwapped(data, read);
+	}
+	else {
+		ByteOrder = std::endian::native;
+		success = read(inBuf) && !inBuf.Failed();
+	}
+	Compression = inBuf.GetCompression();
+	return success;
+}
+
+/* Pass NAV data in memory (a whole file) to read: as a NavBufferReader, or as a forward-only stream buffer if it is compressed.
+Data in the other byte order than the host's is copied and swapped first. Sets the compression and byte order to the data's.
+Returns what read returns. */
+template<typename Read>
+bool NavFile::ReadMemory(std::span<const std::byte> data, Read&& read) {
+	if (DetectNavCompression(data) != NavCompression::NONE) {
+		NavReadBuf inBuf(data);
+		return ReadStream(inBuf, read);
+	}
+	Compression = NavCompression::NONE;
+	if (DetectNavByteOrder(data).value_or(std::endian::native) != std::endian::native) {
+		std::vector<std::byte> swapped(data.begin(), data.end());
+		return ReadSwapped(swapped, read);
+	}
+	ByteOrder = std::endian::native;
+	NavBufferReader reader(data);
+	return read(reader);
+}
+
+/* Pass the data of the file at FilePath to read: as a NavBufferReader when the file is mapped into memory,
+or as a forward-only stream buffer when it is compressed, can't be mapped, or is standard input.
+Data in the other byte order than the host's is read into memory and swapped first. Sets the compression and byte order to the file's.
+Returns what read returns, or false if the file can't be opened. */
+template<typename Read>
+bool NavFile::ReadSource(Read&& read) {
+	const bool standardInput = FilePath == NAV_STDIO_PATH;
+	if (!standardInput) {
+		NavMappedFile mappedFile;
+		if (mappedFile.Open(FilePath)) return ReadMemory(mappedFile.GetData(), read);
+	}
+	// Fallback and pipes.
+	int fd = standardInput ? STDIN_FILENO : open(FilePath.c_str(), O_RDONLY);
+	if (fd == -1) {
+		#ifndef NDEBUG
+		std::cerr << "fatal: Failed to open file buffer.\n";
+		#endif
+		return false;
+	}
+	NavReadBuf inBuf(fd);
+	const bool success = ReadStream(inBuf, read);
+	if (!standardInput) close(fd);
+	return success;
+}
+
+/* Read NAV data in memory, such as the contents of a whole file.
+Compressed data is decompressed as it is read, and data in the other byte order than the host's is swapped first.
+Sets the compression and byte order to the data's.
+Returns true on success, false on failure. */
+bool NavFile::ReadBuffer(std::span<const std::byte> data) {
+	return ReadMemory(data, [this](auto& buf) -> bool {
+		return ReadData(buf);
+	});
+}
+
+// Read the NAV file at FilePath.
+// Maps the file into memory and decodes it from there. Compressed files, standard input (NAV_STDIO_PATH) and files that can't be mapped are decoded as they are read.
+// Returns true on success, false on failure.
+bool NavFile::ReadFile() {
+	// Nothing can be copied from standard input later.
+	std::optional<NavFileState> state;
+	if (FilePath != NAV_STDIO_PATH) state = GetNavFileState(FilePath);
+	const bool success = ReadSource([this](auto& buf) -> bool {
+		return ReadData(buf);
+	});
+	// Remember what the file was like, so unchanged areas can be copied from it when saving.
+	if (success) {
+		SourceState = state;
+		SourceMajorVersion = MajorVersion;
+		SourceMinorVersion = MinorVersion;
+		SourceCompression = Compression;
+		SourceByteOrder = ByteOrder;
+	}
+	return success;
+}
+
+/* Read only the header of the file at FilePath, without going through any areas.
+If ladderCount is true, the ladder count is taken from the sidecar index when it is current. Otherwise it stays unknown.
+Returns true on success, false on failure. */
+bool NavFile::ReadFileHeader(const bool& ladderCount) {
+	areas.reset();
+	IndexAreas();
+	SourceState.reset();
+	return ReadSource([this, &ladderCount](auto& buf) -> bool {
+		if (!ReadHeader(buf)) return false;
+		LadderCount = 0u;
+		LadderDataLoc = -1;
+		LadderCountKnown = false;
+		if (!ladderCount) return true;
+		// Only the index knows the ladder count without going through every area.
+		NavIndexFile index;
+		std::filebuf indexBuf;
+		if (indexBuf.open(NavIndexFile::GetIndexPath(FilePath), std::ios_base::in | std::ios_base::binary) && index.ReadData(indexBuf)
+		&& index.IsCurrent(FilePath) && index.AreaDataLoc == static_cast<std::uint64_t>(static_cast<std::streamoff>(AreaDataLoc)) && index.AreaCount == AreaCount) {
+			LadderCount = index.LadderCount;
+			LadderDataLoc = index.LadderDataLoc;
+			LadderCountKnown = true;
+		}
+		return true;
+	});
+}
+
+/* Stream the file at FilePath without keeping its areas.
+Reads the header, then passes each area and its index to visit, one at a time.
+Ladders are read once every area has been visited; stop early by returning false from visit.
+Returns true on success, false on failure. */
+bool NavFile::StreamFile(const std::function<bool(NavArea&, const size_t&)>& visit) {
+	auto streamData = [this, &visit](auto& buf) -> bool {
+		if (!ReadHeader(buf)) return false;
+		NavAreaStream areaStream(buf, MajorVersion, MinorVersion, AreaCount);
+		NavArea area;
+		size_t areaDataSize = 0u;
+		while (areaStream.Next(area))
+		{
+			areaDataSize += area.size;
+			if (!visit(area, areaStream.GetIndex() - 1u)) return true;
+		}
+		if (areaStream.Failed()) return false;
+		// Read ladder count.
+		if constexpr (std::is_same_v<std::decay_t<decltype(buf)>, NavBufferReader>) {
+			if (!buf.Read(LadderCount)) return false;
+			LadderDataLoc = buf.Tell();
+		}
+		else {
+			if (buf.sgetn(reinterpret_cast<char*>(&LadderCount), VALVE_INT_SIZE) != VALVE_INT_SIZE) return false;
+			LadderDataLoc = static_cast<std::streamoff>(AreaDataLoc) + static_cast<std::streamoff>(areaDataSize) + VALVE_INT_SIZE;
+		}
+		// Store ladder data.
+		if (!ReadRecordRun<NavLadder>(buf, LadderCount, ladders)) {
+			#ifndef NDEBUG
+			std::clog << "NavFile::StreamFile(): Could not read ladder data.\n";
+			#endif
+			return false;
+		}
+		return true;
+	};
+	return ReadSource(streamData);
+}
+
+// Read only the area with ID through the sidecar index.
+// Returns false if the index is missing or out of date, or if the area is not in it.
+bool NavFile::ReadFileArea(const IntID& ID) {
+	if (FilePath == NAV_STDIO_PATH) return false;
+	NavIndexFile index;
+	{
+		std::filebuf indexBuf;
+		if (!indexBuf.open(NavIndexFile::GetIndexPath(FilePath), std::ios_base::in | std::ios_base::binary)) return false;
+		if (!index.ReadData(indexBuf)) return false;
+	}
+	if (!index.IsCurrent(FilePath)) return false;
+	std::optional<NavIndexEntry> entry = index.Find(ID);
+	// The index is current, so its file size is the NAV file's.
+	if (!entry.has_value() || entry.value().Offset > index.NavSize || entry.value().Length > index.NavSize - entry.value().Offset) return false;
+	// Read the area data.
+	std::vector<std::byte> areaData(entry.value().Length);
+	{
+		std::filebuf inBuf;
+		if (!inBuf.open(FilePath, std::ios_base::in | std::ios_base::binary)) return false;
+		if (inBuf.pubseekpos(entry.value().Offset, std::ios_base::in) == -1) return false;
+		if (inBuf.sgetn(reinterpret_cast<char*>(areaData.data()), areaData.size()) != static_cast<std::streamsize>(areaData.size())) return false;
+	}
+	MajorVersion = index.MajorVersion;
+	MinorVersion = index.MinorVersion;
+	AreaCount = index.AreaCount;
+	LadderCount = index.LadderCount;
+	LadderCountKnown = true;
+	AreaDataLoc = index.AreaDataLoc;
+	LadderDataLoc = index.LadderDataLoc;
+	// Decode the area.
+	NavBufferReader reader(areaData);
+	areas = std::vector<NavArea>(1u);
+	if (!areas.value().front().ReadData(reader, MajorVersion, MinorVersion) || areas.value().front().ID != ID || reader.Remaining() != 0u) {
+		#ifndef NDEBUG
+		std::clog << "NavFile::ReadFileArea(): Indexed area data does not match area #" << ID << ".\n";
+		#endif
+		areas.reset();
+		return false;
+	}
+	areas.value().front().SourceOffset = entry.value().Offset;
+	IndexAreas();
+	return true;
+}
+
+// Write all of data to fd.
+// Returns true on success, false on failure.
+static bool WriteAll(const int& fd, const char* data, size_t len) {
+	while (len > 0u)
+	{
+		ssize_t ret = write(fd, data, len);
+		if (ret == -1) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+		data += ret;
+		len -= ret;
+	}
+	return true;
+}
+
+// Copy len bytes at offset in srcFd to the current position of dstFd.
+// The copy stays in the kernel when the filesystem allows it.
+// Returns true on success, false on failure.
+static bool CopyRange(const int& srcFd, off_t offset, size_t len, const int& dstFd) {
+	while (len > 0u)
+	{
+		ssize_t ret = copy_file_range(srcFd, &offset, dstFd, nullptr, len, 0u);
+		if (ret > 0) {
+			len -= ret;
+			continue;
+		}
+		if (ret == 0) return false; // Source is cut short.
+		if (errno == EINTR) continue;
+		if (errno != ENOSYS && errno != EXDEV && errno != EINVAL && errno != EOPNOTSUPP) return false;
+		// Not supported here, so copy through a buffer.
+		std::vector<char> copyBuf(std::min<size_t>(len, 1u << 20));
+		while (len > 0u)
+		{
+			ssize_t readLen = pread(srcFd, copyBuf.data(), std::min(len, copyBuf.size()), offset);
+			if (readLen == -1 && errno == EINTR) continue;
+			if (readLen <= 0 || !WriteAll(dstFd, copyBuf.data(), readLen)) return false;
+			offset += readLen;
+			len -= readLen;
+		}
+	}
+	return true;
+}
+
+// Get the size and modification time of the file at path.
+// Returns nothing if the file can't be accessed.
+std::optional<NavFileState> GetNavFileState(const std::filesystem::path& path) {
+	std::error_code ec;
+	NavFileState state;
+	state.Size = std::filesystem::file_size(path, ec);
+	if (ec) return {};
+	state.ModifiedTime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+	if (ec) return {};
+	return state;
+}
+
+// Note where each area's data is, starting at AreaDataLoc.
+void NavFile::SetAreaSources() {
+	if (!areas.has_value()) return;
+	size_t offset = static_cast<std::streamoff>(AreaDataLoc);
+	for (NavArea& area : areas.value())
+	{
+		area.SourceOffset = offset;
+		offset += area.size;
+	}
+}
+
+// Is the file at the file path still the one the areas were read from (or last saved to)?
+bool NavFile::IsSourceCurrent() {
+	if (!SourceState.has_value() || SourceMajorVersion != MajorVersion || SourceMinorVersion != MinorVersion) return false;
+	std::optional<NavFileState> state = GetNavFileState(FilePath);
+	return state.has_value() && state.value().Size == SourceState.value().Size && state.value().ModifiedTime == SourceState.value().ModifiedTime;
+}
+
+/* Write the file to fd, copying the data of areas that aren't dirty from the file at the file path.
+Only the header, dirty areas and ladders are encoded.
+Returns the number of bytes written on success, nothing on failure. */
+std::optional<size_t> NavFile::WriteIncremental(const int& fd) {
+	int srcFd = open(FilePath.c_str(), O_RDONLY);
+	if (srcFd == -1) return {};
+	std::stringbuf dataBuf(std::ios_base::out);
+	if (!WriteHeader(dataBuf)) {
+		close(srcFd);
+		return {};
+	}
+	size_t written = 0u;
+	// Encoded data waiting to be written.
+	auto flushData = [&fd, &dataBuf, &written]() -> bool {
+		const std::string data = std::move(dataBuf).str();
+		dataBuf.str(std::string());
+		written += data.size();
+		return WriteAll(fd, data.data(), data.size());
+	};
+	// Run of unchanged area data waiting to be copied.
+	size_t copyOffset = 0u, copyLength = 0u;
+	auto flushCopy = [&fd, &srcFd, &copyOffset, &copyLength, &written]() -> bool {
+		if (copyLength == 0u) return true;
+		written += copyLength;
+		bool copied = CopyRange(srcFd, copyOffset, copyLength, fd);
+		copyLength = 0u;
+		return copied;
+	};
+	bool success = true;
+	if (AreaCount > 0u && areas.has_value()) for (NavArea& area : areas.value())
+	{
+		if (!area.IsDirty() && area.GetDataSize(MajorVersion, MinorVersion) == area.size) {
+			// Extend the copy run if the area follows it in the file.
+			if (copyLength > 0u && copyOffset + copyLength == area.SourceOffset.value()) {
+				copyLength += area.size;
+				continue;
+			}
+			if (!flushCopy() || !flushData()) {
+				success = false;
+				break;
+			}
+			copyOffset = area.SourceOffset.value();
+			copyLength = area.size;
+		}
+		else {
+			if (!flushCopy() || !area.WriteData(dataBuf, MajorVersion, MinorVersion)) {
+				success = false;
+				break;
+			}
+		}
+	}
+	success = success && flushCopy()
+		&& dataBuf.sputn(reinterpret_cast<char*>(&LadderCount), VALVE_INT_SIZE) == VALVE_INT_SIZE
+		&& WriteRecordRun<NavLadder>(dataBuf, LadderCount, ladders)
+		&& dataBuf.sputn(reinterpret_cast<const char*>(TrailingData.data()), TrailingData.size()) == static_cast<std::streamsize>(TrailingData.size())
+		&& flushData();
+	close(srcFd);
+	if (!success) return {};
+	return written;
+}
+
+/* Save to the file at FilePath.
+The data is written to a uniquely named temporary file in the same directory, synced, and renamed over the file.
+The file is either fully replaced or left as it was.
+By default the data is serialized once. If incremental is true, and the file is still the one the areas were read from,
+the data of areas that aren't dirty is copied from it instead of encoded again.
+If verify is true, the temporary file is checked against a checksum of the data (or just its size, for incremental saves) before the rename.
+The data is compressed if the compression is set, and swapped if the byte order isn't the host's. Nothing is copied in either case.
+If the file path is NAV_STDIO_PATH, the data is just written to standard output.
+Returns true on success, false on failure. */
+bool NavFile::SaveFile(const bool& verify, const bool& incremental) {
+	// Area data can only be copied between uncompressed files in the host's byte order.
+	const bool copyAreas = incremental && Compression == NavCompression::NONE && SourceCompression == NavCompression::NONE
+	&& ByteOrder == std::endian::native && SourceByteOrder == std::endian::native && IsSourceCurrent();
+	std::string data;
+	if (!copyAreas && !SerializeData(data)) {
+		#ifndef NDEBUG
+		std::cerr << "NavFile::SaveFile(): Failed to serialize NAV data!\n";
+		#endif
+		return false;
+	}
+	if (!copyAreas && ByteOrder != std::endian::native && !SwapByteOrder(std::as_writable_bytes(std::span(data)), false)) {
+		#ifndef NDEBUG
+		std::cerr << "NavFile::SaveFile(): Failed to swap the byte order of NAV data!\n";
+		#endif
+		return false;
+	}
+	if (!copyAreas && Compression != NavCompression::NONE) {
+		std::string compressed;
+		if (!CompressNavData(std::as_bytes(std::span(data)), Compression, compressed)) {
+			#ifndef NDEBUG
+			std::cerr << "NavFile::SaveFile(): Failed to compress NAV data!\n";
+			#endif
+			return false;
+		}
+		data = std::move(compressed);
+	}
+	if (FilePath == NAV_STDIO_PATH) {
+		// Keep anything already printed in front of the data.
+		std::cout.flush();
+		if (!WriteAll(STDOUT_FILENO, data.data(), data.size())) {
+			#ifndef NDEBUG
+			std::cerr << "NavFile::SaveFile(): Failed to write NAV data to standard output!\n";
+			#endif
+			return false;
+		}
+		return true;
+	}
+	// Keep the temporary file next to the original, so the rename doesn't cross filesystems.
+	const std::filesystem::path directory = FilePath.has_parent_path() ? FilePath.parent_path() : std::filesystem::path(".");
+	std::string tempPath = (directory / ("." + FilePath.filename().string() + ".XXXXXX")).string();
+	int fd = mkstemp(tempPath.data());
+	if (fd == -1) {
+		#ifndef NDEBUG
+		std::cerr << "Could not create temporary file.\n";
+		#endif
+		return false;
+	}
+	auto fail = [&fd, &tempPath](const char* message) -> bool {
+		#ifndef NDEBUG
+		std::cerr << message;
+		#endif
+		if (fd != -1) close(fd);
+		unlink(tempPath.c_str());
+		return false;
+	};
+	// Keep the permissions of the original file.
+	{
+		struct stat st;
+		if (stat(FilePath.c_str(), &st) == 0) fchmod(fd, st.st_mode & 07777);
+	}
+	if (copyAreas) {
+		std::optional<size_t> written = WriteIncremental(fd);
+		if (!written.has_value()) return fail("Failed to write NAV data to temporary file!\n");
+		// Header and ladders were encoded, so the expected size is known.
+		size_t expectedSize = static_cast<std::streamoff>(AreaDataLoc) + VALVE_INT_SIZE + static_cast<size_t>(LadderCount) * LADDER_SIZE + TrailingData.size();
+		if (AreaCount > 0u && areas.has_value()) for (const NavArea& area : areas.value()) expectedSize += area.GetDataSize(MajorVersion, MinorVersion);
+		if (verify && written.value() != expectedSize) return fail("Temporary file does not match NAV data!\n");
+	}
+	else if (!WriteAll(fd, data.data(), data.size())) return fail("Failed to write NAV data to temporary file!\n");
+	if (fsync(fd) == -1) return fail("Failed to sync temporary file!\n");
+	// Check what was written against what was serialized.
+	if (verify && !copyAreas) {
+		NavMappedFile writtenFile;
+		if (!writtenFile.Open(tempPath) || writtenFile.GetData().size() != data.size() || HashNavData(writtenFile.GetData()) != HashNavData(std::as_bytes(std::span(data)))) return fail("Temporary file does not match NAV data!\n");
+	}
+	if (close(fd) == -1) {
+		fd = -1;
+		return fail("Failed to close temporary file!\n");
+	}
+	fd = -1;
+	if (rename(tempPath.c_str(), FilePath.c_str()) == -1) return fail("Failed to replace NAV file!\n");
+	// Make the rename itself durable.
+	int dirFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if (dirFd != -1) {
+		fsync(dirFd);
+		close(dirFd);
+	}
+	// The file now holds the areas as they are.
+	if (areas.has_value()) {
+		for (NavArea& area : areas.value()) area.size = area.GetDataSize(MajorVersion, MinorVersion);
+		SetAreaSources();
+		IndexAreas();
+	}
+	LadderDataLoc = static_cast<std::streamoff>(AreaDataLoc) + static_cast<std::streamoff>(areas.has_value() && AreaCount > 0u ? std::accumulate(areas.value().begin(), areas.value().end(), size_t(0u), [](const size_t& sum, const NavArea& area) { return sum + area.size; }) : 0u) + VALVE_INT_SIZE;
+	SourceState = GetNavFileState(FilePath);
+	SourceMajorVersion = MajorVersion;
+	SourceMinorVersion = MinorVersion;
+	SourceCompression = Compression;
+	SourceByteOrder = ByteOrder;
+	return true;
+}
+
+/* Patch the data of an area in the file at FilePath, in place.
+location is where the area was when the file was read; the edited area is areas[location.Index].
+Only works if the area still encodes to the same length, and the file isn't compressed or in the other byte order than the host's. Only the bytes that changed are written.
+Returns true if the file was patched, false if it needs a full rewrite. */
+bool NavFile::PatchAreaData(const NavAreaLocation& location) {
+	if (!areas.has_value() || location.Index >= areas.value().size()) return false;
+	// Offsets are into the decompressed data, so compressed files are rewritten instead.
+	if (Compression != NavCompression::NONE || SourceCompression != NavCompression::NONE || FilePath == NAV_STDIO_PATH) return false;
+	if (ByteOrder != std::endian::native || SourceByteOrder != std::endian::native) return false;
+	// Encode the edited area.
+	std::stringstream areaBuf;
+	if (!areas.value()[location.Index].WriteData(*areaBuf.rdbuf(), MajorVersion, MinorVersion)) return false;
+	const std::string areaData = areaBuf.str();
+	// Size changed, so everything after the area moves.
+	if (areaData.size() != location.Length) return false;
+	// The file changed since it was read, so the area may not be at location any more.
+	if (!IsSourceCurrent()) return false;
+
+	int fd = open(FilePath.c_str(), O_RDWR);
+	if (fd == -1) {
+		#ifndef NDEBUG
+		std::cerr << "NavFile::PatchAreaData(): Could not open \'" << FilePath << "\'!\n";
+		#endif
+		return false;
+	}
+	const off_t offset = static_cast<std::streamoff>(location.Offset);
+	std::string oldData(location.Length, '\0');
+	if (pread(fd, oldData.data(), oldData.size(), offset) != static_cast<ssize_t>(oldData.size())) {
+		close(fd);
+		return false;
+	}
+	// Write each run of changed bytes.
+	for (size_t pos = 0u; pos < areaData.size();)
+	{
+		if (areaData[pos] == oldData[pos]) {
+			pos++;
+			continue;
+		}
+		size_t end = pos + 1u;
+		while (end < areaData.size() && areaData[end] != oldData[end]) end++;
+		if (pwrite(fd, areaData.data() + pos, end - pos, offset + pos) != static_cast<ssize_t>(end - pos)) {
+			#ifndef NDEBUG
+			std::cerr << "NavFile::PatchAreaData(): Failed to write area data!\n";
+			#endif
+			close(fd);
+			return false;
+		}
+		pos = end;
+	}
+	if (close(fd) != 0) return false;
+	// The area's data in the file is current again.
+	NavArea& area = areas.value()[location.Index];
+	area.SourceOffset = offset;
+	area.size = location.Length;
+	SourceState = GetNavFileState(FilePath);
+	return true;
+}
+
+// Write the sidecar index for the file at the file path, if it is missing or out of date.
+// Returns true on success, false on failure.
+bool NavFile::UpdateIndexFile() {
+	// Offsets into compressed files can't be read directly, so they aren't indexed. Neither are swapped files or standard input.
+	if (SourceCompression != NavCompression::NONE || SourceByteOrder != std::endian::native || FilePath == NAV_STDIO_PATH) return true;
+	const std::filesystem::path indexPath = NavIndexFile::GetIndexPath(FilePath);
+	// Keep a current index.
+	{
+		NavIndexFile index;
+		std::filebuf indexBuf;
+		if (indexBuf.open(indexPath, std::ios_base::in | std::ios_base::binary) && index.ReadData(indexBuf) && index.IsCurrent(FilePath)) return true;
+	}
+	if (!areas.has_value()) return false;
+	NavIndexFile index;
+	{
+		NavMappedFile mappedFile;
+		if (!mappedFile.Open(FilePath)) return false;
+		index.NavHash = HashNavData(mappedFile.GetData());
+		index.NavSize = mappedFile.GetData().size();
+	}
+	std::error_code ec;
+	index.NavModifiedTime = std::filesystem::last_write_time(FilePath, ec).time_since_epoch().count();
+	if (ec) return false;
+	index.MajorVersion = MajorVersion;
+	index.MinorVersion = MinorVersion;
+	index.AreaDataLoc = AreaDataLoc;
+	index.LadderDataLoc = LadderDataLoc;
+	index.AreaCount = AreaCount;
+	index.LadderCount = LadderCount;
+	index.entries.reserve(areaIDs.size());
+	for (size_t i = 0u; i < areas.value().size(); i++)
+	{
+		std::optional<NavAreaLocation> location = FindAreaLocation(areas.value()[i].ID);
+		// Skip duplicated IDs and changed areas.
+		if (!location.has_value() || location.value().Index != i) continue;
+		index.entries.push_back(NavIndexEntry{areas.value()[i].ID, static_cast<std::uint64_t>(static_cast<std::streamoff>(location.value().Offset)), static_cast<unsigned int>(location.value().Length)});
+	}
+	std::sort(index.entries.begin(), index.entries.end(), [](const NavIndexEntry& lhs, const NavIndexEntry& rhs) {
+		return lhs.ID < rhs.ID;
+	});
+	// Write to a temporary file first so a half-written index is never picked up.
+	std::filesystem::path tempPath = indexPath;
+	tempPath += ".tmp";
+	{
+		std::filebuf indexBuf;
+		if (!indexBuf.open(tempPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary)) return false;
+		if (!index.WriteData(indexBuf)) {
+			indexBuf.close();
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+	}
+	std::filesystem::rename(tempPath, indexPath, ec);
+	return !ec;
+}
+
 // Validate the NAV File.
 bool NavFile::IsValidFile() {
 	if (MagicNumber != 0xFEEDFACE) {
+		#ifndef NDEBUG
 		std::cerr << "Mismatching magic number ("<<std::to_string(MagicNumber)<<"); not a Source Engine NAV file.\n";
+		#endif
 		return false;
 	}
 	return true;
@@ -375,82 +1330,164 @@ std::optional<size_t> NavFile::TraverseNavAreaData(const std::streampos& pos) {
 		#endif
 		return {};
 	}
-	std::streampos startPos = inFileBuf.pubseekpos(pos);
-	if (inFileBuf.pubseekoff(VALVE_INT_SIZE, std::ios_base::cur) == -1) return {}; // ID
+	return TraverseNavAreaData(inFileBuf, pos);
+}
+
+// Travel through data of an area in a buffer.
+// Returns data length of an area (at specified position).
+std::optional<size_t> NavFile::TraverseNavAreaData(std::streambuf& inFileBuf, const std::streampos& pos) {
+	if (inFileBuf.pubseekpos(pos) == -1) return {};
+	return NavArea::SkipData(inFileBuf, MajorVersion, MinorVersion);
+}
+
+// Skip over the data of an area in memory, starting at the current position of buf.
+// Returns data length of the area, nothing if the data is cut short.
+std::optional<size_t> NavFile::TraverseNavAreaData(NavBufferReader& buf) {
+	return NavArea::SkipData(buf, MajorVersion, MinorVersion);
+}
+
+// Rebuild the area ID index from the area container.
+void NavFile::IndexAreas() {
+	// Keeps the first area if IDs are duplicated.
+	if (areas.has_value()) areaIDs.Build(areas.value(), [](const NavArea& area) { return area.ID; });
+	else areaIDs.Clear();
+	ladderIDsValid = false;
+	hideSpotIDsValid = false;
+}
+
+/* Decode every area's lazy sections and index all area, ladder and hide spot IDs up front.
+Until the file is changed again, lookups then only read it, so they can run on several threads at once. */
+void NavFile::PrepareSharedReads() {
+	if (areas.has_value()) for (NavArea& area : areas.value()) area.DecodeSections();
+	IndexAreas();
+	FindLadderIndex(0u);
+	FindHideSpot(0u);
+}
+
+// Ladders were changed directly, so index their IDs again on the next lookup.
+void NavFile::InvalidateLadderIndex() {
+	ladderIDsValid = false;
+}
+
+// Hide spots were changed directly, so index their IDs again on the next lookup.
+void NavFile::InvalidateHideSpotIndex() {
+	hideSpotIDsValid = false;
+}
+
+// Find the location of the data of an area with ID in the file.
+// Returns the location if found (and the area is unchanged since it was read), nothing otherwise.
+std::optional<NavAreaLocation> NavFile::FindAreaLocation(const IntID& ID) {
+	std::optional<size_t> index = FindAreaIndex(ID);
+	if (!index.has_value()) return {};
+	const NavArea& area = areas.value()[index.value()];
+	if (area.IsDirty()) return {};
+	return NavAreaLocation{static_cast<std::streamoff>(area.SourceOffset.value()), area.size, index.value()};
+}
+
+// Find the container index of an area with ID.
+// Returns the index if found, nothing otherwise.
+std::optional<size_t> NavFile::FindAreaIndex(const IntID& ID) {
+	std::optional<size_t> index = areaIDs.Find(ID);
+	if (!index.has_value() || !areas.has_value() || index.value() >= areas.value().size()) return {};
+	// The container was changed without going through InsertArea()/EraseArea().
+	if (areas.value()[index.value()].ID != ID) {
+		IndexAreas();
+		index = areaIDs.Find(ID);
+	}
+	return index;
+}
+
+// Find the container index of a ladder with ID.
+// Returns the index if found, nothing otherwise.
+std::optional<size_t> NavFile::FindLadderIndex(const IntID& ID) {
+	for (unsigned char attempt = 0u; attempt < 2u; attempt++)
 	{
-		std::optional<unsigned char> size = getAreaAttributeFlagSize(MajorVersion, MinorVersion);
-		if (!size.has_value())
-		{
-			#ifndef NDEBUG
-			std::cerr << "NavFile::TraverseNavAreaData(): Could not get attribute flag size!\n";
-			#endif
-			return {};
+		if (!ladderIDsValid) {
+			ladderIDs.Build(ladders, [](const NavLadder& ladder) { return ladder.ID; });
+			ladderIDsValid = true;
 		}
-		else if(!inFileBuf.pubseekoff(size.value(), std::ios_base::cur)) return {};
+		std::optional<size_t> index = ladderIDs.Find(ID);
+		if (!index.has_value()) return {};
+		if (index.value() < ladders.size() && ladders[index.value()].ID == ID) return index;
+		// Stale, try again.
+		ladderIDsValid = false;
 	}
-	// Skip over nwCorner[3], seCorner[3], NorthEastZ, and SouthWestZ.
-	if (!inFileBuf.pubseekoff(VALVE_FLOAT_SIZE * 8, std::ios_base::cur)) return {};
-	// Traverse connection data.
-	for (unsigned char currDirection = (char)Direction::North; currDirection < (char)Direction::Count; currDirection++)
-	{
-		unsigned int connectionCount = 0u;
-		if (inFileBuf.sgetn(reinterpret_cast<char*>(&connectionCount), VALVE_INT_SIZE) != VALVE_INT_SIZE) return {};
-		if (!inFileBuf.pubseekoff(connectionCount * VALVE_INT_SIZE, std::ios_base::cur)) return {};
-	}
-	// Hiding spots
-	unsigned char hideSpotCount = inFileBuf.sbumpc();
-	if (!inFileBuf.pubseekoff((VALVE_INT_SIZE + (VALVE_FLOAT_SIZE * 3) + VALVE_CHAR_SIZE) * hideSpotCount, std::ios_base::cur)) return {};
-
-	// Approach spots which are not in newer NAV versions.
-	if (MajorVersion < 15) {
-		unsigned char approachAreaCount;
-		inFileBuf.sgetn(reinterpret_cast<char*>(&approachAreaCount), sizeof(approachAreaCount));
-		if (!inFileBuf.pubseekoff(APPROACH_SPOT_SIZE * approachAreaCount, std::ios_base::cur)) return {};
-	}
-
-	// Encounter Paths.
-	unsigned int encounterPathCount;
-	inFileBuf.sgetn(reinterpret_cast<char*>(&encounterPathCount), VALVE_INT_SIZE);
-	for (unsigned int pathIndex=0; pathIndex < encounterPathCount; pathIndex++) {
-		inFileBuf.pubseekoff(ENCOUNTER_PATH_SIZE, std::ios_base::cur);
-		unsigned char spotCount = inFileBuf.sbumpc();
-		if (!inFileBuf.pubseekoff(ENCOUNTER_SPOT_SIZE * spotCount, std::ios_base::cur)) return {};
-	}
-	// Skip over place ID.
-	if (!inFileBuf.pubseekoff(VALVE_SHORT_SIZE, std::ios_base::cur)) return {};
-	// Handle ladders
-	for (char i = 0; i < 2; i++)
+	return {};
+}
+
+// Find a hide spot with ID.
+// Returns the index of its area and its index in that area if found, nothing otherwise.
+std::optional<std::pair<size_t, size_t> > NavFile::FindHideSpot(const IntID& ID) {
+	if (!areas.has_value()) return {};
+	std::vector<NavArea>& areaData = areas.value();
+	for (unsigned char attempt = 0u; attempt < 2u; attempt++)
 	{
-		unsigned int ladderConnectionCount;
-		inFileBuf.sgetn(reinterpret_cast<char*>(&ladderConnectionCount), VALVE_INT_SIZE);
-		if (!inFileBuf.pubseekoff(VALVE_INT_SIZE * ladderConnectionCount, std::ios_base::cur)) return {}; // Skip over ladder IDs.
+		if (!hideSpotIDsValid) {
+			hideSpotIDs.Clear();
+			for (size_t i = 0u; i < areaData.size(); i++)
+				for (const NavHideSpot& hideSpot : areaData[i].GetHideSpotData().second) hideSpotIDs.Insert(hideSpot.ID, i);
+			hideSpotIDsValid = true;
+		}
+		std::optional<size_t> areaIndex = hideSpotIDs.Find(ID);
+		if (!areaIndex.has_value()) return {};
+		if (areaIndex.value() < areaData.size()) {
+			const auto& hideSpots = areaData[areaIndex.value()].GetHideSpotData().second;
+			for (size_t i = 0u; i < hideSpots.size(); i++) if (hideSpots[i].ID == ID) return std::make_pair(areaIndex.value(), i);
+		}
+		// Stale, try again.
+		hideSpotIDsValid = false;
 	}
-	// Occupy times
-	if (!inFileBuf.pubseekoff(VALVE_FLOAT_SIZE * 2, std::ios_base::cur)) return {};
-
-	// Light intensity
-	if (MajorVersion >= 11 && !inFileBuf.pubseekoff(VALVE_FLOAT_SIZE * 4, std::ios_base::cur)) return {};
+	return {};
+}
 
-	// Visible areas
-	if (MajorVersion >= 16) {
-		unsigned int visibleAreaCount;
-		inFileBuf.sgetn(reinterpret_cast<char*>(&visibleAreaCount), sizeof(visibleAreaCount));
-		if (!inFileBuf.pubseekoff(VISIBLE_AREA_SIZE * visibleAreaCount, std::ios_base::cur)) return {};
+/* Insert area before pos, keeping the area count and ID index up to date.
+Returns an iterator to the inserted area. */
+std::vector<NavArea>::iterator NavFile::InsertArea(std::vector<NavArea>::const_iterator pos, NavArea area) {
+	if (!areas.has_value()) areas.emplace();
+	const size_t index = pos - areas.value().cbegin();
+	const IntID ID = area.ID;
+	auto areaIt = areas.value().insert(pos, std::move(area));
+	AreaCount++;
+	if (index + 1u < areas.value().size()) {
+		areaIDs.Shift(index, 1);
+		if (hideSpotIDsValid) hideSpotIDs.Shift(index, 1);
 	}
+	areaIDs.Insert(ID, index);
+	if (hideSpotIDsValid) for (const NavHideSpot& hideSpot : areaIt->GetHideSpotData().second) hideSpotIDs.Insert(hideSpot.ID, index);
+	return areaIt;
+}
 
-	// Skip over InheritVisibilityFromAreaID.
-	if (!inFileBuf.pubseekoff(VALVE_INT_SIZE, std::ios_base::cur)) return {};
-
-	// Skip over custom data.
-	if (!inFileBuf.pubseekoff(getCustomDataSize(inFileBuf, MajorVersion, MinorVersion), std::ios_base::cur)) return {};
+/* Erase the area at pos, keeping the area count and ID index up to date.
+Returns an iterator to the area after it. */
+std::vector<NavArea>::iterator NavFile::EraseArea(std::vector<NavArea>::const_iterator pos) {
+	const size_t index = pos - areas.value().cbegin();
+	if (areaIDs.Find(pos->ID) == index) areaIDs.Erase(pos->ID);
+	if (hideSpotIDsValid) {
+		for (const NavHideSpot& hideSpot : areas.value()[index].GetHideSpotData().second)
+			if (hideSpotIDs.Find(hideSpot.ID) == index) hideSpotIDs.Erase(hideSpot.ID);
+	}
+	auto areaIt = areas.value().erase(pos);
+	if (AreaCount > 0u) AreaCount--;
+	areaIDs.Shift(index + 1u, -1);
+	if (hideSpotIDsValid) hideSpotIDs.Shift(index + 1u, -1);
+	return areaIt;
+}
 
-	return (inFileBuf.pubseekoff(0, std::ios_base::cur) - startPos);
+// Get an area ID no area uses yet.
+IntID NavFile::GetNextAreaID() {
+	return std::max<IntID>(areaIDs.GetMaxID(), AreaCount) + 1u;
 }
 
 // Find an area with ID.
 // Return position to the area's data if found, nothing otherwise.
 std::optional<std::streampos> NavFile::FindArea(const unsigned int& ID) {
-	// Setup temporary file buffer.
+	// Use the index when areas have been read.
+	if (areas.has_value()) {
+		std::optional<NavAreaLocation> location = FindAreaLocation(ID);
+		if (!location.has_value()) return {};
+		return location.value().Offset;
+	}
+	// Otherwise, walk the file once.
 	std::filebuf inFileBuf;
 	inFileBuf.open(FilePath, std::ios_base::in | std::ios_base::binary);
 	if (!inFileBuf.is_open()) {
@@ -459,36 +1496,34 @@ std::optional<std::streampos> NavFile::FindArea(const unsigned int& ID) {
 		#endif
 		return {};
 	}
-	if (!inFileBuf.pubseekpos(AreaDataLoc)) return {};
+	std::streampos areaPos = AreaDataLoc;
 	for (size_t i = 0; i < AreaCount; i++)
 	{
 		IntID areaID;
-		inFileBuf.sgetn(reinterpret_cast<char*>(&areaID), VALVE_INT_SIZE) << '\n';
-		std::streampos resultPos = inFileBuf.pubseekoff(-VALVE_INT_SIZE, std::ios_base::cur);
-		if (areaID == ID) return resultPos;
-		else {
-			std::optional<size_t> DataLength = TraverseNavAreaData(resultPos);
-			if (DataLength.has_value()) {
-				if (!inFileBuf.pubseekoff(DataLength.value(), std::ios_base::cur)) return {};
-			}
-			else {
-				std::cerr << "FATAL: Cannot retrive area data size!\n";
-				return {};
-;			}
+		if (inFileBuf.pubseekpos(areaPos) == -1 || inFileBuf.sgetn(reinterpret_cast<char*>(&areaID), VALVE_INT_SIZE) != VALVE_INT_SIZE) return {};
+		if (areaID == ID) return areaPos;
+		std::optional<size_t> DataLength = TraverseNavAreaData(inFileBuf, areaPos);
+		if (!DataLength.has_value()) {
+			#ifndef NDEBUG
+			std::cerr << "FATAL: Cannot retrive area data size!\n";
+			#endif
+			return {};
 		}
+		areaPos += DataLength.value();
 	}
 	return {};
 }
 
 void NavFile::OutputData(std::ostream& ostream) {
-	std::cout << FilePath << ":\n"
+	ostream << FilePath << ":\n"
 	<< "\tMagic Number: 0x" << std::hex << MagicNumber << '\n'
 	<< "\tMajor Version: " <<std::dec<< std::to_string(MajorVersion) << '\n';
 	if (MinorVersion.has_value()) ostream << "\tMinor Version: " << std::to_string(MinorVersion.value()) << '\n';
+	ostream << "\tByte Order: " << (ByteOrder == std::endian::big ? "big" : "little") << '\n';
 	if (BSPSize.has_value()) ostream << "\tReference BSP size: " << std::to_string(BSPSize.value()) << '\n';
 	if (isAnalyzed.has_value()) ostream << "\tAnalyzed? " << std::boolalpha << isAnalyzed.value() << '\n';
 	ostream << "\tPlace Count: " << std::dec << PlaceCount << '\n';
 	if (hasUnnamedAreas.has_value()) ostream << "\tHas unnamed areas? " << std::boolalpha << hasUnnamedAreas.value() << '\n';
 	ostream << "\tArea Count: " << std::dec << std::to_string(AreaCount) << '\n'
-	<< "\tLadder Count: " << std::to_string(LadderCount) << '\n';
+	<< "\tLadder Count: " << (LadderCountKnown ? std::to_string(LadderCount) : "(unknown)") << '\n';
 }
\ No newline at end of file
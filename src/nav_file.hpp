@@ -5,9 +5,49 @@
 #include <deque>
 #include <filesystem>
 #include <span>
+#include <functional>
+#include <cstdint>
+#include <optional>
+#include <memory>
+#include <memory_resource>
 #include "nav_base.hpp"
 #include "nav_place.hpp"
 #include "nav_area.hpp"
+#include "nav_index.hpp"
+#include "nav_stream.hpp"
+#include "nav_id_map.hpp"
+#include "nav_compress.hpp"
+#include "nav_byte_order.hpp"
+// File path that reads from standard input and saves to standard output.
+#define NAV_STDIO_PATH "-"
+// Fewest areas each decoding thread should get. Smaller meshes are decoded serially.
+#define NAV_PARALLEL_MIN_AREAS 1024u
+// Where an area's data is.
+struct NavAreaLocation {
+	std::streampos Offset; // Byte offset of the area data in the file.
+	size_t Length = 0u; // Length of the area data (in bytes).
+	size_t Index = 0u; // Index of the area in the area container.
+};
+// What a file on disk was like when it was read.
+struct NavFileState {
+	std::uintmax_t Size = 0u; // File size (in bytes).
+	std::int64_t ModifiedTime = 0; // Last modification time.
+};
+// Get the size and modification time of the file at path.
+// Returns nothing if the file can't be accessed.
+std::optional<NavFileState> GetNavFileState(const std::filesystem::path& path);
+
+/*
+	Arenas that area containers allocate from.
+	Assigning over a set keeps the arenas it holds: areas assigned over keep allocating from them.
+*/
+struct NavArenaSet {
+	std::vector<std::shared_ptr<std::pmr::monotonic_buffer_resource> > resources;
+	NavArenaSet() = default;
+	NavArenaSet(const NavArenaSet&) = default;
+	NavArenaSet& operator=(const NavArenaSet&) { return *this; }
+};
+
 class NavFile {
 	private:
 		// Header info
@@ -17,11 +57,80 @@ class NavFile {
 		unsigned short PlaceCount;
 		std::optional<bool> hasUnnamedAreas; // Doesn't exist prior to version 14.
 		unsigned int AreaCount = 0u, LadderCount = 0u;
+		// False after reading only the header, unless the ladder count came from the sidecar index.
+		bool LadderCountKnown = true;
 		
 		std::filesystem::path FilePath; // File path.
 		std::streampos AreaDataLoc = -1; // The starting location of area data.
 		std::streampos LadderDataLoc = -1; // Ladder Data location.
 		std::deque<std::string> PlaceNames;
+		// Custom data of the game before the area count (pre-area data), and after the ladders (trailing data). Kept as it is.
+		std::vector<std::byte> PreAreaData, TrailingData;
+		// Maps area IDs to their index in the area container.
+		NavIDMap areaIDs;
+		// Maps ladder IDs to their index in the ladder container. Built on the first lookup.
+		NavIDMap ladderIDs;
+		bool ladderIDsValid = false;
+		// Maps hide spot IDs to the index of the area they are in. Built on the first lookup.
+		NavIDMap hideSpotIDs;
+		bool hideSpotIDsValid = false;
+		// How the file is compressed when saved. Reading a file sets it to how that file is compressed.
+		NavCompression Compression = NavCompression::NONE;
+		// Byte order the file is saved in. Reading a file sets it to the byte order of that file.
+		std::endian ByteOrder = std::endian::little;
+		// Threads used to decode and encode area data in memory (0 = one per hardware thread).
+		unsigned int ThreadCount = 0u;
+
+		/* Read the header from a stream (counting what is read) or from NAV data in memory, up to and including the area count.
+		   Returns true on success, false on failure. */
+		template<typename Buffer>
+		bool ReadHeaderData(Buffer& buf);
+
+		// Number of threads to split count areas over. 1 if they should be handled serially.
+		unsigned int GetAreaThreadCount(const size_t& count);
+
+		/* Decode AreaCount areas from buf on threadCount threads.
+		   Area boundaries are found with a serial scan first, then each thread decodes a run of areas.
+		   Returns true on success, false on failure. */
+		bool ReadAreaDataParallel(NavBufferReader& buf, const unsigned int& threadCount);
+
+		// Arenas the containers of read areas allocate from. Released together once the areas are gone.
+		// Declared before the area container, so they outlive it.
+		NavArenaSet arenas;
+		/* Replace the area container with count empty areas.
+		   The areas are split into runCount runs (as ReadAreaDataParallel() splits them), each drawing from its own arena,
+		   so runs can be decoded on separate threads. dataSize is the size of the area data, used to size the arenas. */
+		void AllocateAreas(const unsigned int& runCount, const size_t& dataSize, const size_t& count);
+
+		// State of the file at the file path when the areas were read from (or last saved to) it.
+		std::optional<NavFileState> SourceState;
+		unsigned int SourceMajorVersion = 0u;
+		std::optional<unsigned int> SourceMinorVersion;
+		// How the file at the file path is compressed. Area data in a compressed file can't be copied or patched.
+		NavCompression SourceCompression = NavCompression::NONE;
+		// Byte order of the file at the file path. Area data in the other byte order than the host's can't be copied or patched.
+		std::endian SourceByteOrder = std::endian::little;
+		/* Pass the data of the file at the file path to read: as a NavBufferReader when the file is mapped into memory,
+		   or as a forward-only stream buffer when it is compressed, can't be mapped, or is standard input.
+		   Data in the other byte order than the host's is read into memory and swapped first. Sets the compression and byte order to the file's.
+		   Returns what read returns, or false if the file can't be opened. */
+		template<typename Read>
+		bool ReadSource(Read&& read);
+		// Parts of ReadSource(): reading swapped data, a stream buffer, and data in memory.
+		template<typename Read>
+		bool ReadSwapped(std::vector<std::byte>& data, Read&& read);
+		template<typename Read>
+		bool ReadStream(NavReadBuf& inBuf, Read&& read);
+		template<typename Read>
+		bool ReadMemory(std::span<const std::byte> data, Read&& read);
+		// Note where each area's data is, starting at the area data location.
+		void SetAreaSources();
+		// Is the file at the file path still the one the areas were read from (or last saved to)?
+		bool IsSourceCurrent();
+		/* Write the file to fd, copying the data of areas that aren't dirty from the file at the file path.
+		   Only the header, dirty areas and ladders are encoded.
+		   Returns the number of bytes written on success, nothing on failure. */
+		std::optional<size_t> WriteIncremental(const int& fd);
 	public:
 		std::optional<std::vector<NavArea> > areas; // Area container.
 		std::deque<NavLadder> ladders;
@@ -39,16 +148,85 @@ class NavFile {
 		std::optional<bool> IsAnalyzed(), GetHasUnnamedAreas();
 		unsigned int& GetAreaCount();
 		unsigned int GetLadderCount();
+		bool IsLadderCountKnown();
+		std::vector<std::byte>& GetPreAreaData();
+		std::vector<std::byte>& GetTrailingData();
 		const std::streampos& GetAreaDataLoc();
 		const std::streampos& GetLadderDataLoc();
+		unsigned int GetThreadCount();
+		void SetThreadCount(const unsigned int& threadCount);
+		NavCompression GetCompression();
+		// Set how the file is compressed when saved.
+		void SetCompression(const NavCompression& compression);
+		std::endian GetByteOrder();
+		// Set the byte order the file is saved in.
+		void SetByteOrder(const std::endian& byteOrder);
+		/* Swap the byte order of a whole NAV file in memory, in place: to the host's if toHost is true, from it otherwise.
+		   Returns true on success, false if the data is cut short. */
+		static bool SwapByteOrder(std::span<std::byte> data, const bool& toHost);
 
+		/* Write the header, up to and including the area count.
+		   Returns true on success, false on failure. */
+		bool WriteHeader(std::streambuf& buf);
 		/* Write header info.
 		   Returns true on success, false on failure. */
 		bool WriteData(std::streambuf& buf);
+		/* Serialize the whole file into out, which is sized exactly once.
+		   Area sizes are computed up front, so large meshes are encoded on several threads, each into its own slice of out.
+		   Returns true on success, false on failure. */
+		bool SerializeData(std::string& out);
+		/* Read the header, up to and including the area count.
+		   Leaves buf at the first area. A stream must be at the start of the file, and is only read forward.
+		   Returns true on success, false on failure. */
+		bool ReadHeader(std::streambuf& buf);
+		bool ReadHeader(NavBufferReader& buf);
 		/* Read header info.
-		   Writes data to areaContainer.
+		   Writes data to areaContainer. buf is only read forward, so it can be a pipe.
 		   Returns true on success, false on failure. */
 		bool ReadData(std::streambuf& buf);
+		/* Read header info from NAV data in memory.
+		   Returns true on success, false on failure. */
+		bool ReadData(NavBufferReader& buf);
+		/* Read NAV data in memory, such as the contents of a whole file.
+		   Compressed data is decompressed as it is read, and data in the other byte order than the host's is swapped first.
+		   Sets the compression and byte order to the data's.
+		   Returns true on success, false on failure. */
+		bool ReadBuffer(std::span<const std::byte> data);
+		/* Read the file at the file path.
+		   Maps the file into memory when possible. Compressed files are decompressed as they are read.
+		   Returns true on success, false on failure. */
+		bool ReadFile();
+		/* Read only the header of the file at the file path, without going through any areas.
+		   If ladderCount is true, the ladder count is taken from the sidecar index when that is current.
+		   Otherwise it stays unknown (see IsLadderCountKnown()).
+		   Returns true on success, false on failure. */
+		bool ReadFileHeader(const bool& ladderCount = false);
+		/* Stream the file at the file path without keeping its areas.
+		   Reads the header, then passes each area and its index to visit, one at a time.
+		   Ladders are read once every area has been visited; stop early by returning false from visit.
+		   Returns true on success, false on failure. */
+		bool StreamFile(const std::function<bool(NavArea&, const size_t&)>& visit);
+		/* Read only the area with ID (and the header info needed to decode it) through the sidecar index.
+		   Returns false if the index is missing or out of date, or if the area is not in it. */
+		bool ReadFileArea(const IntID& ID);
+		/* Save to the file at the file path.
+		   The data is written to a uniquely named temporary file in the same directory, synced, and renamed over the file.
+		   By default the data is serialized once. If incremental is true and the file hasn't changed since it was read,
+		   the data of areas that aren't dirty is copied from it (in the kernel where possible), and only the rest is encoded.
+		   If verify is true, the temporary file is checked against a checksum of the data (or its expected size, for incremental saves) before the rename.
+		   The data is compressed if the compression is set, and swapped if the byte order isn't the host's. Nothing is copied in either case.
+		   If the file path is NAV_STDIO_PATH, the data is just written to standard output.
+		   Returns true on success, false on failure. */
+		bool SaveFile(const bool& verify = false, const bool& incremental = false);
+		/* Patch the data of an area in the file at the file path, in place.
+		   location is where the area was when the file was read; the edited area is areas[location.Index].
+		   Only works if the area still encodes to the same length, the file isn't compressed, and it hasn't changed since it was read. Only the bytes that changed are written.
+		   Returns true if the file was patched, false if it needs a full rewrite. */
+		bool PatchAreaData(const NavAreaLocation& location);
+		/* Write the sidecar index for the file at the file path, if it is missing or out of date.
+		   Area data must have been read from that file. Compressed files aren't indexed.
+		   Returns true on success, false on failure. */
+		bool UpdateIndexFile();
 		// Output data.
 		void OutputData(std::ostream& ostream);
 		// Get game version.
@@ -62,6 +240,41 @@ class NavFile {
 		// Returns data length of an area (at current file position).
 		std::optional<size_t> GetAreaCustomDataSize();
 
+		// Travel through data of an area in buf.
+		// Returns data length of an area (at specified position).
+		std::optional<size_t> TraverseNavAreaData(std::streambuf& buf, const std::streampos& pos);
+		// Skip over the data of an area in memory, starting at the current position of buf.
+		// Returns data length of the area, nothing if the data is cut short.
+		std::optional<size_t> TraverseNavAreaData(NavBufferReader& buf);
+
+		// Rebuild the area ID index from the area container.
+		void IndexAreas();
+		/* Decode every area's lazy sections and index all area, ladder and hide spot IDs up front.
+		   Until the file is changed again, lookups then only read it, so they can run on several threads at once. */
+		void PrepareSharedReads();
+		// Ladders or hide spots were changed directly, so index their IDs again on the next lookup.
+		void InvalidateLadderIndex();
+		void InvalidateHideSpotIndex();
+		// Find the location of the data of an area with ID in the file.
+		// Returns the location if found (and the area is unchanged since it was read), nothing otherwise.
+		std::optional<NavAreaLocation> FindAreaLocation(const IntID& ID);
+		// Find the container index of an area with ID.
+		// Returns the index if found, nothing otherwise.
+		std::optional<size_t> FindAreaIndex(const IntID& ID);
+		// Find the container index of a ladder with ID.
+		// Returns the index if found, nothing otherwise.
+		std::optional<size_t> FindLadderIndex(const IntID& ID);
+		// Find a hide spot with ID.
+		// Returns the index of its area and its index in that area if found, nothing otherwise.
+		std::optional<std::pair<size_t, size_t> > FindHideSpot(const IntID& ID);
+		/* Insert area before pos, keeping the area count and ID index up to date.
+		   Returns an iterator to the inserted area. */
+		std::vector<NavArea>::iterator InsertArea(std::vector<NavArea>::const_iterator pos, NavArea area = NavArea());
+		/* Erase the area at pos, keeping the area count and ID index up to date.
+		   Returns an iterator to the area after it. */
+		std::vector<NavArea>::iterator EraseArea(std::vector<NavArea>::const_iterator pos);
+		// Get an area ID no area uses yet.
+		IntID GetNextAreaID();
 		// Find an area with ID.
 		// Retunrs the stream position if successful.
 		std::optional<std::streampos> FindArea(const unsigned int& ID);
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <iostream>
+#include "nav_graph.hpp"
+
+/* Build the graph from areas and ladders, replacing its contents.
+Edge costs are computed if withCosts is true.
+Returns true on success, false if there are more edges than can be indexed. */
+bool NavGraph::Build(const std::vector<NavArea>& areas, const std::deque<NavLadder>& ladders, const bool& withCosts) {
+	const size_t areaCount = areas.size();
+	areaIDs.resize(areaCount);
+	sortedIDs.resize(areaCount);
+	for (size_t i = 0u; i < areaCount; i++)
+	{
+		areaIDs[i] = areas[i].ID;
+		sortedIDs[i] = {areas[i].ID, static_cast<unsigned int>(i)};
+	}
+	std::sort(sortedIDs.begin(), sortedIDs.end());
+	danglingEdgeCount = 0u;
+
+	// Edges a ladder adds, as (source area ID, target area ID, type).
+	struct LadderEdge {
+		IntID SourceID, TargetID;
+		NavEdgeType Type;
+	};
+	std::vector<LadderEdge> ladderEdges;
+	for (const NavLadder& ladder : ladders)
+	{
+		if (ladder.BottomAreaID == 0u) continue;
+		for (const IntID& topID : {ladder.TopForwardAreaID, ladder.TopLeftAreaID, ladder.TopRightAreaID, ladder.TopBehindAreaID})
+		{
+			if (topID == 0u) continue;
+			ladderEdges.push_back({ladder.BottomAreaID, topID, NavEdgeType::LadderUp});
+			ladderEdges.push_back({topID, ladder.BottomAreaID, NavEdgeType::LadderDown});
+		}
+	}
+	// Resolve ladder area IDs once.
+	std::vector<std::pair<unsigned int, unsigned int> > ladderIndices;
+	ladderIndices.reserve(ladderEdges.size());
+	for (const LadderEdge& edge : ladderEdges)
+	{
+		std::optional<unsigned int> source = FindIndex(edge.SourceID), target = FindIndex(edge.TargetID);
+		if (!source.has_value() || !target.has_value()) {
+			ladderIndices.emplace_back(std::numeric_limits<unsigned int>::max(), 0u);
+			danglingEdgeCount++;
+			continue;
+		}
+		ladderIndices.emplace_back(source.value(), target.value());
+	}
+
+	// Count outgoing edges per area.
+	edgeOffsets.assign(areaCount + 1u, 0u);
+	size_t edgeCount = 0u;
+	for (size_t i = 0u; i < areaCount; i++)
+	{
+		for (const auto& connections : areas[i].connectionData) edgeOffsets[i + 1u] += connections.second.size();
+		edgeCount += edgeOffsets[i + 1u];
+	}
+	for (const auto& indices : ladderIndices)
+	{
+		if (indices.first == std::numeric_limits<unsigned int>::max()) continue;
+		edgeOffsets[indices.first + 1u]++;
+		edgeCount++;
+	}
+	if (edgeCount >= std::numeric_limits<unsigned int>::max()) {
+		#ifndef NDEBUG
+		std::clog << "NavGraph::Build(): Too many edges!\n";
+		#endif
+		return false;
+	}
+	for (size_t i = 0u; i < areaCount; i++) edgeOffsets[i + 1u] += edgeOffsets[i];
+
+	// Fill outgoing edges.
+	edgeTargets.resize(edgeCount);
+	edgeTypes.resize(edgeCount);
+	std::vector<unsigned int> fill(edgeOffsets.begin(), edgeOffsets.end() - 1);
+	for (size_t i = 0u; i < areaCount; i++)
+	{
+		for (unsigned char direction = 0u; direction < static_cast<unsigned char>(Direction::Count); direction++)
+		{
+			for (const NavConnection& connection : areas[i].connectionData[direction].second)
+			{
+				std::optional<unsigned int> target = FindIndex(connection.TargetAreaID);
+				if (!target.has_value()) {
+					danglingEdgeCount++;
+					continue;
+				}
+				edgeTargets[fill[i]] = target.value();
+				edgeTypes[fill[i]++] = static_cast<NavEdgeType>(direction);
+			}
+		}
+	}
+	for (size_t i = 0u; i < ladderEdges.size(); i++)
+	{
+		const unsigned int source = ladderIndices[i].first;
+		if (source == std::numeric_limits<unsigned int>::max()) continue;
+		edgeTargets[fill[source]] = ladderIndices[i].second;
+		edgeTypes[fill[source]++] = ladderEdges[i].Type;
+	}
+	// Dangling connections leave gaps, so pack the edges.
+	if (danglingEdgeCount > 0u) {
+		size_t packed = 0u;
+		for (size_t i = 0u; i < areaCount; i++)
+		{
+			const unsigned int first = edgeOffsets[i];
+			edgeOffsets[i] = packed;
+			for (unsigned int edge = first; edge < fill[i]; edge++, packed++)
+			{
+				edgeTargets[packed] = edgeTargets[edge];
+				edgeTypes[packed] = edgeTypes[edge];
+			}
+		}
+		edgeOffsets[areaCount] = packed;
+		edgeTargets.resize(packed);
+		edgeTypes.resize(packed);
+	}
+
+	// Costs.
+	edgeCosts.clear();
+	if (withCosts) {
+		std::vector<std::array<float, 3> > centers(areaCount);
+		for (size_t i = 0u; i < areaCount; i++)
+			for (unsigned char axis = 0u; axis < 3u; axis++) centers[i][axis] = (areas[i].nwCorner[axis] + areas[i].seCorner[axis]) / 2.0f;
+		edgeCosts.resize(edgeTargets.size());
+		for (size_t i = 0u; i < areaCount; i++)
+		{
+			for (unsigned int edge = edgeOffsets[i]; edge < edgeOffsets[i + 1u]; edge++)
+			{
+				const std::array<float, 3>& from = centers[i], & to = centers[edgeTargets[edge]];
+				edgeCosts[edge] = std::hypot(to[0] - from[0], to[1] - from[1], to[2] - from[2]);
+			}
+		}
+	}
+
+	// Incoming edges.
+	reverseOffsets.assign(areaCount + 1u, 0u);
+	for (const unsigned int& target : edgeTargets) reverseOffsets[target + 1u]++;
+	for (size_t i = 0u; i < areaCount; i++) reverseOffsets[i + 1u] += reverseOffsets[i];
+	reverseSources.resize(edgeTargets.size());
+	reverseEdges.resize(edgeTargets.size());
+	fill.assign(reverseOffsets.begin(), reverseOffsets.end() - 1);
+	for (size_t i = 0u; i < areaCount; i++)
+	{
+		for (unsigned int edge = edgeOffsets[i]; edge < edgeOffsets[i + 1u]; edge++)
+		{
+			const unsigned int slot = fill[edgeTargets[edge]]++;
+			reverseSources[slot] = i;
+			reverseEdges[slot] = edge;
+		}
+	}
+	return true;
+}
+
+// Number of areas.
+size_t NavGraph::GetAreaCount() const {
+	return areaIDs.size();
+}
+
+// Number of edges.
+size_t NavGraph::GetEdgeCount() const {
+	return edgeTargets.size();
+}
+
+// Find the dense index of an area ID.
+// Returns the index if found, nothing otherwise.
+std::optional<unsigned int> NavGraph::FindIndex(const IntID& ID) const {
+	auto it = std::lower_bound(sortedIDs.begin(), sortedIDs.end(), ID, [](const std::pair<IntID, unsigned int>& entry, const IntID& ID) {
+		return entry.first < ID;
+	});
+	if (it == sortedIDs.end() || it->first != ID) return {};
+	return it->second;
+}
+
+// Target areas of the outgoing edges of area index.
+std::span<const unsigned int> NavGraph::GetOutgoing(const unsigned int& index) const {
+	return std::span<const unsigned int>(edgeTargets).subspan(edgeOffsets[index], edgeOffsets[index + 1u] - edgeOffsets[index]);
+}
+
+// Source areas of the incoming edges of area index.
+std::span<const unsigned int> NavGraph::GetIncoming(const unsigned int& index) const {
+	return std::span<const unsigned int>(reverseSources).subspan(reverseOffsets[index], reverseOffsets[index + 1u] - reverseOffsets[index]);
+}
@@ -0,0 +1,63 @@
+#ifndef NAV_GRAPH_HPP
+#define NAV_GRAPH_HPP
+#include <vector>
+#include <deque>
+#include <span>
+#include <optional>
+#include "nav_base.hpp"
+#include "nav_area.hpp"
+
+// How an edge leaves its area.
+// The first four match Direction.
+enum class NavEdgeType : unsigned char {
+	North = 0,
+	East,
+	South,
+	West,
+	LadderUp, // From the bottom of a ladder to an area at its top.
+	LadderDown, // From an area at the top of a ladder to its bottom.
+	Count
+};
+
+/*
+	Compressed sparse row graph of a mesh.
+	Areas are numbered densely by their position in the area container.
+	Edges come from area connections and from ladders' top and bottom area IDs.
+	The outgoing edges of area i are [edgeOffsets[i], edgeOffsets[i + 1]) in the edge arrays.
+	Incoming edges are kept the same way, pointing back into the outgoing edge arrays.
+*/
+class NavGraph {
+	public:
+		// Area ID of every dense index.
+		std::vector<IntID> areaIDs;
+		// Outgoing edges.
+		std::vector<unsigned int> edgeOffsets, edgeTargets;
+		std::vector<NavEdgeType> edgeTypes;
+		// Cost of each outgoing edge (distance between area centers). Empty unless built with costs.
+		std::vector<float> edgeCosts;
+		// Incoming edges. reverseSources holds the source area, reverseEdges the outgoing edge it is.
+		std::vector<unsigned int> reverseOffsets, reverseSources, reverseEdges;
+		// Edges that point to IDs not in the mesh. They are left out.
+		size_t danglingEdgeCount = 0u;
+
+		/* Build the graph from areas and ladders, replacing its contents.
+		   Edge costs are computed if withCosts is true.
+		   Returns true on success, false if there are more edges than can be indexed. */
+		bool Build(const std::vector<NavArea>& areas, const std::deque<NavLadder>& ladders, const bool& withCosts = false);
+
+		// Number of areas.
+		size_t GetAreaCount() const;
+		// Number of edges.
+		size_t GetEdgeCount() const;
+		// Find the dense index of an area ID.
+		// Returns the index if found, nothing otherwise.
+		std::optional<unsigned int> FindIndex(const IntID& ID) const;
+		// Target areas of the outgoing edges of area index.
+		std::span<const unsigned int> GetOutgoing(const unsigned int& index) const;
+		// Source areas of the incoming edges of area index.
+		std::span<const unsigned int> GetIncoming(const unsigned int& index) const;
+	private:
+		// Area IDs with their dense index, sorted by ID.
+		std::vector<std::pair<IntID, unsigned int> > sortedIDs;
+};
+#endif
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <bit>
+#include "nav_id_map.hpp"
+
+// Remove all IDs.
+void NavIDMap::Clear() {
+	isDirect = true;
+	direct.clear();
+	slots.clear();
+	count = 0u;
+	maxID = 0u;
+}
+
+// Does an ID this large still fit a direct table?
+bool NavIDMap::FitsDirect(const IntID& ID, const size_t& idCount) const {
+	return static_cast<size_t>(ID) <= idCount * NAV_ID_MAP_DENSITY + NAV_ID_MAP_SLACK;
+}
+
+size_t NavIDMap::GetSlot(const IntID& ID) const {
+	// Fibonacci hashing spreads consecutive IDs apart.
+	return static_cast<size_t>((static_cast<std::uint64_t>(ID) * 0x9E3779B97F4A7C15ull) >> 32) & (slots.size() - 1u);
+}
+
+// Switch to a hash table with room for capacity IDs.
+void NavIDMap::Rehash(const size_t& capacity) {
+	std::vector<std::pair<IntID, size_t> > entries;
+	entries.reserve(count);
+	if (isDirect) {
+		for (size_t ID = 0u; ID < direct.size(); ID++) if (direct[ID] != NoIndex) entries.emplace_back(static_cast<IntID>(ID), direct[ID]);
+	}
+	else for (const auto& slot : slots) if (slot.second != NoIndex) entries.push_back(slot);
+	isDirect = false;
+	direct = std::vector<size_t>();
+	// Keep the load at most one half.
+	slots.assign(std::bit_ceil(std::max<size_t>(capacity, 8u) * 2u), {0u, NoIndex});
+	for (const auto& entry : entries)
+	{
+		size_t slot = GetSlot(entry.first);
+		while (slots[slot].second != NoIndex) slot = (slot + 1u) & (slots.size() - 1u);
+		slots[slot] = entry;
+	}
+}
+
+// Find the index of ID.
+// Returns the index if found, nothing otherwise.
+std::optional<size_t> NavIDMap::Find(const IntID& ID) const {
+	if (isDirect) {
+		if (ID >= direct.size() || direct[ID] == NoIndex) return {};
+		return direct[ID];
+	}
+	if (slots.empty()) return {};
+	for (size_t slot = GetSlot(ID); slots[slot].second != NoIndex; slot = (slot + 1u) & (slots.size() - 1u))
+	{
+		if (slots[slot].first == ID) return slots[slot].second;
+	}
+	return {};
+}
+
+// Add ID at index.
+// Returns false (and changes nothing) if ID is already mapped.
+bool NavIDMap::Insert(const IntID& ID, const size_t& index) {
+	if (Find(ID).has_value()) return false;
+	if (isDirect) {
+		if (ID >= direct.size()) {
+			// Grow the table while it stays dense, otherwise hash.
+			if (FitsDirect(ID, count + 1u)) direct.resize(std::max<size_t>(static_cast<size_t>(ID) + 1u, direct.size() * 2u), NoIndex);
+			else Rehash(count + 1u);
+		}
+	}
+	if (isDirect) direct[ID] = index;
+	else {
+		if ((count + 1u) * 2u > slots.size()) Rehash(count + 1u);
+		size_t slot = GetSlot(ID);
+		while (slots[slot].second != NoIndex) slot = (slot + 1u) & (slots.size() - 1u);
+		slots[slot] = {ID, index};
+	}
+	count++;
+	maxID = std::max(maxID, ID);
+	return true;
+}
+
+// Remove ID.
+// Returns true if it was mapped.
+bool NavIDMap::Erase(const IntID& ID) {
+	if (isDirect) {
+		if (ID >= direct.size() || direct[ID] == NoIndex) return false;
+		direct[ID] = NoIndex;
+		count--;
+		return true;
+	}
+	if (slots.empty()) return false;
+	const size_t mask = slots.size() - 1u;
+	size_t slot = GetSlot(ID);
+	while (slots[slot].second != NoIndex && slots[slot].first != ID) slot = (slot + 1u) & mask;
+	if (slots[slot].second == NoIndex) return false;
+	// Move later entries of the probe run back, so lookups don't stop at the hole.
+	size_t hole = slot;
+	for (size_t next = (hole + 1u) & mask; slots[next].second != NoIndex; next = (next + 1u) & mask)
+	{
+		const size_t home = GetSlot(slots[next].first);
+		// Entries whose home is cyclically in (hole, next] stay put.
+		if (hole <= next ? (hole < home && home <= next) : (hole < home || home <= next)) continue;
+		slots[hole] = slots[next];
+		hole = next;
+	}
+	slots[hole] = {0u, NoIndex};
+	count--;
+	return true;
+}
+
+// Move every index at or after first by delta, after an insertion or removal in the container.
+void NavIDMap::Shift(const size_t& first, const std::ptrdiff_t& delta) {
+	auto shift = [&first, &delta](size_t& index) {
+		if (index != NoIndex && index >= first) index += delta;
+	};
+	if (isDirect) for (size_t& index : direct) shift(index);
+	else for (auto& slot : slots) shift(slot.second);
+}
+
+// Number of IDs.
+size_t NavIDMap::size() const {
+	return count;
+}
+
+// Largest ID ever added (since the last rebuild).
+IntID NavIDMap::GetMaxID() const {
+	return maxID;
+}
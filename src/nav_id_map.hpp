@@ -0,0 +1,64 @@
+#ifndef NAV_ID_MAP_HPP
+#define NAV_ID_MAP_HPP
+#include <vector>
+#include <optional>
+#include <utility>
+#include <cstddef>
+#include "nav_base.hpp"
+// Direct tables are used while the largest ID is at most this many times the ID count (plus some slack).
+#define NAV_ID_MAP_DENSITY 2u
+#define NAV_ID_MAP_SLACK 64u
+
+/*
+	Maps IDs to container indices.
+	Dense IDs (most meshes number things 1..N) go in a direct table indexed by ID.
+	Sparse IDs go in an open-addressing hash table with linear probing.
+	If an ID is in a container more than once, the first index is kept.
+*/
+class NavIDMap {
+	private:
+		static constexpr size_t NoIndex = static_cast<size_t>(-1);
+		bool isDirect = true;
+		// Direct table: index of ID at [ID], NoIndex if absent.
+		std::vector<size_t> direct;
+		// Hash table slots, NoIndex index for free slots. Capacity is a power of 2.
+		std::vector<std::pair<IntID, size_t> > slots;
+		size_t count = 0u;
+		IntID maxID = 0u;
+
+		size_t GetSlot(const IntID& ID) const;
+		// Switch to a hash table with room for capacity IDs.
+		void Rehash(const size_t& capacity);
+		// Does an ID this large still fit a direct table?
+		bool FitsDirect(const IntID& ID, const size_t& idCount) const;
+	public:
+		// Remove all IDs.
+		void Clear();
+		// Rebuild from the IDs of items, using their positions as indices.
+		template<typename Container, typename GetID>
+		void Build(const Container& items, GetID getID) {
+			Clear();
+			IntID largest = 0u;
+			for (const auto& item : items) largest = std::max<IntID>(largest, getID(item));
+			if (FitsDirect(largest, items.size())) direct.assign(static_cast<size_t>(largest) + 1u, NoIndex);
+			else Rehash(items.size());
+			size_t index = 0u;
+			for (const auto& item : items) Insert(getID(item), index++);
+		}
+		// Find the index of ID.
+		// Returns the index if found, nothing otherwise.
+		std::optional<size_t> Find(const IntID& ID) const;
+		// Add ID at index.
+		// Returns false (and changes nothing) if ID is already mapped.
+		bool Insert(const IntID& ID, const size_t& index);
+		// Remove ID.
+		// Returns true if it was mapped.
+		bool Erase(const IntID& ID);
+		// Move every index at or after first by delta, after an insertion or removal in the container.
+		void Shift(const size_t& first, const std::ptrdiff_t& delta);
+		// Number of IDs.
+		size_t size() const;
+		// Largest ID ever added (since the last rebuild).
+		IntID GetMaxID() const;
+};
+#endif
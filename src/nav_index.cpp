@@ -0,0 +1,154 @@
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include "nav_index.hpp"
+
+// Hash NAV file contents (64-bit FNV-1a).
+std::uint64_t HashNavData(std::span<const std::byte> data) {
+	std::uint64_t hash = 0xcbf29ce484222325ull;
+	for (const std::byte& b : data)
+	{
+		hash ^= static_cast<std::uint64_t>(b);
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+// Get the index path of a NAV file.
+std::filesystem::path NavIndexFile::GetIndexPath(const std::filesystem::path& navPath) {
+	return std::filesystem::path(navPath).replace_extension(NAV_INDEX_EXTENSION);
+}
+
+/* Write index data.
+Returns true on success, false on failure. */
+bool NavIndexFile::WriteData(std::streambuf& out) {
+	const unsigned int magic = NAV_INDEX_MAGIC_NUMBER, version = NAV_INDEX_VERSION;
+	const unsigned char hasMinorVersion = MinorVersion.has_value();
+	const unsigned int minorVersion = MinorVersion.value_or(0u);
+	const unsigned int entryCount = entries.size();
+	// Header.
+	if (out.sputn(reinterpret_cast<const char*>(&magic), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| out.sputn(reinterpret_cast<const char*>(&version), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| out.sputn(reinterpret_cast<const char*>(&NavSize), sizeof(NavSize)) != sizeof(NavSize)
+	|| out.sputn(reinterpret_cast<const char*>(&NavModifiedTime), sizeof(NavModifiedTime)) != sizeof(NavModifiedTime)
+	|| out.sputn(reinterpret_cast<const char*>(&NavHash), sizeof(NavHash)) != sizeof(NavHash)
+	|| out.sputn(reinterpret_cast<const char*>(&MajorVersion), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| out.sputc(hasMinorVersion) == EOF
+	|| out.sputn(reinterpret_cast<const char*>(&minorVersion), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| out.sputn(reinterpret_cast<const char*>(&AreaDataLoc), sizeof(AreaDataLoc)) != sizeof(AreaDataLoc)
+	|| out.sputn(reinterpret_cast<const char*>(&LadderDataLoc), sizeof(LadderDataLoc)) != sizeof(LadderDataLoc)
+	|| out.sputn(reinterpret_cast<const char*>(&AreaCount), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| out.sputn(reinterpret_cast<const char*>(&LadderCount), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| out.sputn(reinterpret_cast<const char*>(&entryCount), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
+		std::cerr << "NavIndexFile::WriteData(): Failed to write index header!\n";
+		#endif
+		return false;
+	}
+	// Area table.
+	std::vector<char> table(entries.size() * NAV_INDEX_ENTRY_SIZE);
+	char* dst = table.data();
+	for (const NavIndexEntry& entry : entries)
+	{
+		std::memcpy(dst, &entry.ID, VALVE_INT_SIZE);
+		std::memcpy(dst + VALVE_INT_SIZE, &entry.Offset, sizeof(entry.Offset));
+		std::memcpy(dst + VALVE_INT_SIZE + sizeof(entry.Offset), &entry.Length, VALVE_INT_SIZE);
+		dst += NAV_INDEX_ENTRY_SIZE;
+	}
+	if (out.sputn(table.data(), table.size()) != static_cast<std::streamsize>(table.size())) {
+		#ifndef NDEBUG
+		std::cerr << "NavIndexFile::WriteData(): Failed to write area table!\n";
+		#endif
+		return false;
+	}
+	return true;
+}
+
+/* Read index data.
+Returns true on success, false on failure. */
+bool NavIndexFile::ReadData(std::streambuf& in) {
+	unsigned int magic, version, minorVersion, entryCount;
+	unsigned char hasMinorVersion;
+	if (in.sgetn(reinterpret_cast<char*>(&magic), VALVE_INT_SIZE) != VALVE_INT_SIZE || magic != NAV_INDEX_MAGIC_NUMBER
+	|| in.sgetn(reinterpret_cast<char*>(&version), VALVE_INT_SIZE) != VALVE_INT_SIZE || version != NAV_INDEX_VERSION) {
+		#ifndef NDEBUG
+		std::cerr << "NavIndexFile::ReadData(): Not a NAV index, or an unsupported version!\n";
+		#endif
+		return false;
+	}
+	if (in.sgetn(reinterpret_cast<char*>(&NavSize), sizeof(NavSize)) != sizeof(NavSize)
+	|| in.sgetn(reinterpret_cast<char*>(&NavModifiedTime), sizeof(NavModifiedTime)) != sizeof(NavModifiedTime)
+	|| in.sgetn(reinterpret_cast<char*>(&NavHash), sizeof(NavHash)) != sizeof(NavHash)
+	|| in.sgetn(reinterpret_cast<char*>(&MajorVersion), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| in.sgetn(reinterpret_cast<char*>(&hasMinorVersion), VALVE_CHAR_SIZE) != VALVE_CHAR_SIZE
+	|| in.sgetn(reinterpret_cast<char*>(&minorVersion), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| in.sgetn(reinterpret_cast<char*>(&AreaDataLoc), sizeof(AreaDataLoc)) != sizeof(AreaDataLoc)
+	|| in.sgetn(reinterpret_cast<char*>(&LadderDataLoc), sizeof(LadderDataLoc)) != sizeof(LadderDataLoc)
+	|| in.sgetn(reinterpret_cast<char*>(&AreaCount), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| in.sgetn(reinterpret_cast<char*>(&LadderCount), VALVE_INT_SIZE) != VALVE_INT_SIZE
+	|| in.sgetn(reinterpret_cast<char*>(&entryCount), VALVE_INT_SIZE) != VALVE_INT_SIZE) {
+		#ifndef NDEBUG
+		std::cerr << "NavIndexFile::ReadData(): Failed to read index header!\n";
+		#endif
+		return false;
+	}
+	if (hasMinorVersion) MinorVersion = minorVersion;
+	else MinorVersion.reset();
+	// There can't be more entries than areas.
+	if (entryCount > AreaCount) {
+		#ifndef NDEBUG
+		std::cerr << "NavIndexFile::ReadData(): Entry count is larger than the area count!\n";
+		#endif
+		return false;
+	}
+	// Read a chunk at a time, so a corrupt count fails at the end of the data instead of allocating for it.
+	constexpr size_t ChunkCount = NAV_STREAM_RESERVE_SIZE / NAV_INDEX_ENTRY_SIZE;
+	std::vector<char> table(std::min<size_t>(entryCount, ChunkCount) * NAV_INDEX_ENTRY_SIZE);
+	entries.clear();
+	entries.reserve(std::min<size_t>(entryCount, ChunkCount));
+	for (size_t done = 0u; done < entryCount;)
+	{
+		const size_t chunk = std::min<size_t>(entryCount - done, ChunkCount);
+		if (in.sgetn(table.data(), chunk * NAV_INDEX_ENTRY_SIZE) != static_cast<std::streamsize>(chunk * NAV_INDEX_ENTRY_SIZE)) {
+			#ifndef NDEBUG
+			std::cerr << "NavIndexFile::ReadData(): Failed to read area table!\n";
+			#endif
+			return false;
+		}
+		const char* src = table.data();
+		for (size_t i = 0u; i < chunk; i++)
+		{
+			NavIndexEntry& entry = entries.emplace_back();
+			std::memcpy(&entry.ID, src, VALVE_INT_SIZE);
+			std::memcpy(&entry.Offset, src + VALVE_INT_SIZE, sizeof(entry.Offset));
+			std::memcpy(&entry.Length, src + VALVE_INT_SIZE + sizeof(entry.Offset), VALVE_INT_SIZE);
+			src += NAV_INDEX_ENTRY_SIZE;
+		}
+		done += chunk;
+	}
+	return true;
+}
+
+// Does the index describe the NAV file at navPath as it is now?
+bool NavIndexFile::IsCurrent(const std::filesystem::path& navPath) const {
+	std::error_code ec;
+	std::uintmax_t size = std::filesystem::file_size(navPath, ec);
+	if (ec || size != NavSize) return false;
+	std::filesystem::file_time_type modifiedTime = std::filesystem::last_write_time(navPath, ec);
+	if (ec) return false;
+	if (modifiedTime.time_since_epoch().count() == NavModifiedTime) return true;
+	// Modification time changed; the contents may not have.
+	NavMappedFile mappedFile;
+	if (!mappedFile.Open(navPath)) return false;
+	return HashNavData(mappedFile.GetData()) == NavHash;
+}
+
+// Find an area entry with ID.
+// Returns the entry if found, nothing otherwise.
+std::optional<NavIndexEntry> NavIndexFile::Find(const IntID& ID) const {
+	auto it = std::lower_bound(entries.begin(), entries.end(), ID, [](const NavIndexEntry& entry, const IntID& ID) {
+		return entry.ID < ID;
+	});
+	if (it == entries.end() || it->ID != ID) return {};
+	return *it;
+}
@@ -0,0 +1,63 @@
+#ifndef NAV_INDEX_HPP
+#define NAV_INDEX_HPP
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <filesystem>
+#include <streambuf>
+#include <span>
+#include "nav_base.hpp"
+
+#define NAV_INDEX_MAGIC_NUMBER 0x5844494E // "NIDX"
+#define NAV_INDEX_VERSION 1u
+#define NAV_INDEX_EXTENSION ".navidx"
+#define NAV_INDEX_ENTRY_SIZE (VALVE_INT_SIZE + sizeof(std::uint64_t) + VALVE_INT_SIZE)
+
+// Hash NAV file contents (64-bit FNV-1a).
+std::uint64_t HashNavData(std::span<const std::byte> data);
+
+// An area in the sidecar index.
+struct NavIndexEntry {
+	IntID ID = 0u; // Area ID.
+	std::uint64_t Offset = 0u; // Byte offset of the area data in the NAV.
+	unsigned int Length = 0u; // Length of the area data (in bytes).
+};
+
+/*
+	Sidecar area index written next to a NAV file (map.nav -> map.navidx).
+	Stores enough about the NAV to tell whether it is still current,
+	and where every area's data is, so single areas can be decoded without a full parse.
+*/
+class NavIndexFile {
+	public:
+		// State of the NAV the index was built from.
+		std::uint64_t NavSize = 0u;
+		std::int64_t NavModifiedTime = 0;
+		std::uint64_t NavHash = 0u;
+		// NAV header info needed to decode areas.
+		unsigned int MajorVersion = 0u;
+		std::optional<unsigned int> MinorVersion;
+		std::uint64_t AreaDataLoc = 0u, LadderDataLoc = 0u;
+		unsigned int AreaCount = 0u, LadderCount = 0u;
+		// Areas, sorted by ID.
+		std::vector<NavIndexEntry> entries;
+
+		// Get the index path of a NAV file.
+		static std::filesystem::path GetIndexPath(const std::filesystem::path& navPath);
+
+		/* Write index data.
+		   Returns true on success, false on failure. */
+		bool WriteData(std::streambuf& out);
+		/* Read index data.
+		   Returns true on success, false on failure. */
+		bool ReadData(std::streambuf& in);
+
+		// Does the index describe the NAV file at navPath as it is now?
+		// Size and modification time are checked first; the content hash is only checked if the time differs.
+		bool IsCurrent(const std::filesystem::path& navPath) const;
+
+		// Find an area entry with ID.
+		// Returns the entry if found, nothing otherwise.
+		std::optional<NavIndexEntry> Find(const IntID& ID) const;
+};
+#endif
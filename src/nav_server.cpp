@@ -0,0 +1,285 @@
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "nav_server.hpp"
+#include "nav_tool.hpp"
+// How often (in milliseconds) the accept loop checks whether it was stopped.
+#define NAV_SERVER_POLL_INTERVAL 200
+
+NavServer::ResidentFile::ResidentFile(const std::filesystem::path& path)
+: file(path) {
+
+}
+
+NavServer::NavServer(const toml::parse_result& config)
+: config(config) {
+
+}
+
+NavServer::~NavServer() {
+	if (listenFd != -1) close(listenFd);
+}
+
+// Send all of data to fd.
+// Returns true on success, false on failure.
+static bool SendAll(const int& fd, const std::string& data) {
+	size_t sent = 0u;
+	while (sent < data.size())
+	{
+		ssize_t ret = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+		if (ret == -1) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+		sent += ret;
+	}
+	return true;
+}
+
+// Key files are loaded under.
+static std::filesystem::path GetFileKey(const std::filesystem::path& path) {
+	std::error_code ec;
+	std::filesystem::path key = std::filesystem::weakly_canonical(path, ec);
+	return ec ? path : key;
+}
+
+/* Listen on a socket at path. A socket file left behind by a server that is gone is replaced.
+Returns true on success, false on failure. */
+bool NavServer::Listen(const std::filesystem::path& path) {
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (path.native().size() >= sizeof(address.sun_path)) {
+		std::clog << "NavServer::Listen(): Socket path is too long.\n";
+		return false;
+	}
+	std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1u);
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd == -1) return false;
+	if (std::filesystem::is_socket(path)) {
+		// Leave it alone if a server is still answering on it.
+		if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+			std::clog << "NavServer::Listen(): A server is already listening on " << path << ".\n";
+			close(fd);
+			return false;
+		}
+		unlink(path.c_str());
+		close(fd);
+		fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd == -1) return false;
+	}
+	if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 || listen(fd, SOMAXCONN) == -1) {
+		std::clog << "NavServer::Listen(): Could not listen on " << path << ": " << std::strerror(errno) << "\n";
+		close(fd);
+		return false;
+	}
+	listenFd = fd;
+	socketPath = path;
+	running = true;
+	return true;
+}
+
+// Accept clients until Stop() is called, then disconnect them.
+void NavServer::Run() {
+	while (running)
+	{
+		pollfd pending{listenFd, POLLIN, 0};
+		if (poll(&pending, 1, NAV_SERVER_POLL_INTERVAL) <= 0) continue;
+		int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+		if (fd == -1) continue;
+		{
+			std::lock_guard<std::mutex> lock(clientsMutex);
+			clientFds.insert(fd);
+		}
+		std::thread(&NavServer::ServeClient, this, fd).detach();
+	}
+	// Disconnect clients, and wait for their threads to finish.
+	{
+		std::unique_lock<std::mutex> lock(clientsMutex);
+		for (const int& fd : clientFds) shutdown(fd, SHUT_RDWR);
+		clientsDone.wait(lock, [this]() { return clientFds.empty(); });
+	}
+	close(listenFd);
+	listenFd = -1;
+	unlink(socketPath.c_str());
+}
+
+// Stop serving. Run() returns shortly after.
+void NavServer::Stop() {
+	running = false;
+}
+
+// Answer the requests of a client until it disconnects.
+void NavServer::ServeClient(const int fd) {
+	std::string received;
+	char buffer[4096];
+	bool connected = true;
+	while (connected)
+	{
+		// Wait for a whole line.
+		size_t lineEnd;
+		while ((lineEnd = received.find('\n')) == std::string::npos)
+		{
+			ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+			if (count == -1 && errno == EINTR) continue;
+			if (count <= 0) {
+				connected = false;
+				break;
+			}
+			received.append(buffer, count);
+		}
+		if (!connected) break;
+		std::string request = received.substr(0u, lineEnd);
+		received.erase(0u, lineEnd + 1u);
+		if (!request.empty() && request.back() == '\r') request.pop_back();
+
+		std::ostringstream response;
+		const bool success = HandleRequest(request, response);
+		response << (success ? NAV_SERVER_OK : NAV_SERVER_ERROR) << '\n';
+		connected = SendAll(fd, response.str());
+	}
+	close(fd);
+	std::lock_guard<std::mutex> lock(clientsMutex);
+	clientFds.erase(fd);
+	if (clientFds.empty()) clientsDone.notify_all();
+}
+
+// Get the loaded file at path, loading it first if needed.
+// Returns nothing if it can't be read.
+std::shared_ptr<NavServer::ResidentFile> NavServer::GetFile(const std::filesystem::path& path, std::ostream& log) {
+	const std::filesystem::path key = GetFileKey(path);
+	std::shared_ptr<ResidentFile> resident;
+	{
+		std::lock_guard<std::mutex> lock(filesMutex);
+		std::shared_ptr<ResidentFile>& entry = files[key];
+		if (!entry) entry = std::make_shared<ResidentFile>(key);
+		resident = entry;
+	}
+	// Loading only locks the file, so other files stay available.
+	std::unique_lock<std::shared_mutex> lock(resident->mutex);
+	if (!resident->loaded) {
+		if (!resident->file.ReadFile()) {
+			log << "Failed to parse input file. Input file could potentially be corrupt!\n";
+			std::lock_guard<std::mutex> filesLock(filesMutex);
+			auto it = files.find(key);
+			if (it != files.end() && it->second == resident) files.erase(it);
+			return {};
+		}
+		resident->file.PrepareSharedReads();
+		resident->loaded = true;
+	}
+	return resident;
+}
+
+// Find a loaded file. Returns nothing if it isn't loaded.
+std::shared_ptr<NavServer::ResidentFile> NavServer::FindFile(const std::filesystem::path& path) {
+	std::lock_guard<std::mutex> lock(filesMutex);
+	auto it = files.find(GetFileKey(path));
+	if (it == files.end()) return {};
+	return it->second;
+}
+
+/* Save a file, if it changed. The caller holds its lock exclusively.
+Returns true on success, false on failure. */
+bool NavServer::SaveFile(ResidentFile& resident, std::ostream& log) {
+	if (!resident.loaded || !resident.modified) return true;
+	if (!resident.file.SaveFile(true, true)) {
+		log << "fatal: Failed to save NAV file " << resident.file.GetFilePath() << ".\n";
+		return false;
+	}
+	resident.modified = false;
+	// Saving re-indexes the file.
+	resident.file.PrepareSharedReads();
+	return true;
+}
+
+/* Run one request, writing its output to out.
+Returns true on success, false on failure. */
+bool NavServer::HandleRequest(const std::string& request, std::ostream& out) {
+	std::vector<std::string> args = {"nav"};
+	{
+		std::istringstream requestStream(request);
+		for (std::string arg; requestStream >> arg;) args.push_back(arg);
+	}
+	if (args.size() < 2u) return true;
+	const std::string& verb = args.at(1);
+	if (verb == "shutdown") {
+		Stop();
+		return true;
+	}
+	if (verb == "flush") {
+		std::vector<std::shared_ptr<ResidentFile> > loaded;
+		{
+			std::lock_guard<std::mutex> lock(filesMutex);
+			for (const auto& entry : files) loaded.push_back(entry.second);
+		}
+		bool success = true;
+		for (const std::shared_ptr<ResidentFile>& resident : loaded)
+		{
+			std::unique_lock<std::shared_mutex> lock(resident->mutex);
+			success = SaveFile(*resident, out) && success;
+		}
+		return success;
+	}
+	if (verb == "save" || verb == "close") {
+		const bool discard = verb == "close" && args.size() == 4u && args.at(3) == "--discard";
+		if (args.size() != (discard ? 4u : 3u)) {
+			out << "Expected a file path.\n";
+			return false;
+		}
+		std::shared_ptr<ResidentFile> resident = FindFile(args.at(2));
+		if (!resident) {
+			out << "File is not loaded.\n";
+			return false;
+		}
+		std::unique_lock<std::shared_mutex> lock(resident->mutex);
+		if (verb == "save") return SaveFile(*resident, out);
+		// Unsaved changes are only dropped when asked to.
+		if (resident->modified && !discard) {
+			out << "File has unsaved changes. Save it first, or close it with --discard.\n";
+			return false;
+		}
+		std::lock_guard<std::mutex> filesLock(filesMutex);
+		auto it = files.find(GetFileKey(args.at(2)));
+		if (it != files.end() && it->second == resident) files.erase(it);
+		return true;
+	}
+
+	// A command for a file.
+	std::vector<char*> argv;
+	for (std::string& arg : args) argv.push_back(arg.data());
+	int argc = argv.size();
+	std::optional<ToolCmd> cmd;
+	{
+		NavFile unused;
+		cmd = NavTool(unused, config, out, out).ParseCommandLine(argc, argv.data());
+	}
+	if (!cmd.has_value()) return false;
+	if (!cmd.value().file.has_value()) {
+		out << "Expected 'file' argument.\n";
+		return false;
+	}
+	if (cmd.value().file.value().GetFilePath() == NAV_STDIO_PATH) {
+		out << "Can't serve stdin.\n";
+		return false;
+	}
+	std::shared_ptr<ResidentFile> resident = GetFile(cmd.value().file.value().GetFilePath(), out);
+	if (!resident) return false;
+	if (cmd.value().cmdType == ActionType::INFO) {
+		std::shared_lock<std::shared_mutex> lock(resident->mutex);
+		return NavTool(resident->file, config, out, out).RunAction(cmd.value());
+	}
+	std::unique_lock<std::shared_mutex> lock(resident->mutex);
+	const bool success = NavTool(resident->file, config, out, out).RunAction(cmd.value());
+	// A failed command only counts as a change if it got far enough to dirty an area.
+	if (success || (resident->file.areas.has_value() && std::any_of(resident->file.areas.value().begin(), resident->file.areas.value().end(), [](const NavArea& area) { return area.IsDirty(); })))
+		resident->modified = true;
+	resident->file.PrepareSharedReads();
+	return success;
+}
@@ -0,0 +1,77 @@
+#ifndef NAV_SERVER_HPP
+#define NAV_SERVER_HPP
+#include <string>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include <filesystem>
+#include <ostream>
+#include "toml++/toml.hpp"
+#include "nav_file.hpp"
+// Last line of a response to a request that succeeded.
+#define NAV_SERVER_OK "OK"
+// Last line of a response to a request that failed.
+#define NAV_SERVER_ERROR "ERROR"
+
+/*
+	Keeps NAV files loaded and runs commands on them for clients of a Unix domain socket.
+	Each request is one line: a command as it would follow `nav` (such as `file <path> area #5 info`), or one of
+		save <path> - Save the file, if it changed.
+		flush - Save every file that changed.
+		close <path> [--discard] - Unload the file. Refused if it has unsaved changes, unless they are discarded.
+		shutdown - Stop the server, without saving.
+	Files are loaded on first use, and changes are only saved when asked to.
+	Info commands on a file run at the same time; other commands on it run one at a time.
+	Each response is the output of the request, then a line that is OK or ERROR.
+*/
+class NavServer {
+	private:
+		// A loaded file.
+		struct ResidentFile {
+			NavFile file;
+			// Shared by info commands, exclusive for everything else.
+			std::shared_mutex mutex;
+			bool loaded = false, modified = false;
+			ResidentFile(const std::filesystem::path& path);
+		};
+		toml::parse_result config;
+		std::mutex filesMutex;
+		std::map<std::filesystem::path, std::shared_ptr<ResidentFile> > files;
+
+		std::filesystem::path socketPath;
+		int listenFd = -1;
+		std::atomic<bool> running = false;
+		// Connected clients, each served on its own thread.
+		std::mutex clientsMutex;
+		std::condition_variable clientsDone;
+		std::set<int> clientFds;
+
+		// Get the loaded file at path, loading it first if needed.
+		// Returns nothing if it can't be read.
+		std::shared_ptr<ResidentFile> GetFile(const std::filesystem::path& path, std::ostream& log);
+		// Find a loaded file. Returns nothing if it isn't loaded.
+		std::shared_ptr<ResidentFile> FindFile(const std::filesystem::path& path);
+		/* Save a file, if it changed. The caller holds its lock exclusively.
+		   Returns true on success, false on failure. */
+		bool SaveFile(ResidentFile& resident, std::ostream& log);
+		// Answer the requests of a client until it disconnects.
+		void ServeClient(const int fd);
+	public:
+		NavServer(const toml::parse_result& config);
+		~NavServer();
+		/* Listen on a socket at path. A socket file left behind by a server that is gone is replaced.
+		   Returns true on success, false on failure. */
+		bool Listen(const std::filesystem::path& path);
+		// Accept clients until Stop() is called, then disconnect them.
+		void Run();
+		// Stop serving. Run() returns shortly after.
+		void Stop();
+		/* Run one request, writing its output to out.
+		   Returns true on success, false on failure. */
+		bool HandleRequest(const std::string& request, std::ostream& out);
+};
+#endif
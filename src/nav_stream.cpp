@@ -0,0 +1,37 @@
+#include <iostream>
+#include "nav_stream.hpp"
+
+NavAreaStream::NavAreaStream(NavBufferReader& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion, const size_t& AreaCount)
+: reader(&buf), MajorVersion(MajorVersion), MinorVersion(MinorVersion), AreaCount(AreaCount) {
+}
+
+NavAreaStream::NavAreaStream(std::streambuf& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion, const size_t& AreaCount)
+: stream(&buf), MajorVersion(MajorVersion), MinorVersion(MinorVersion), AreaCount(AreaCount) {
+}
+
+/* Decode the next area into area, replacing its contents.
+Returns false once all areas have been read, or on failure (see Failed()). */
+bool NavAreaStream::Next(NavArea& area) {
+	if (failed || index >= AreaCount) return false;
+	// Start from a blank area, as NavArea::ReadData() keeps some optional containers around.
+	area = NavArea();
+	if (!(reader ? area.ReadData(*reader, MajorVersion, MinorVersion) : area.ReadData(*stream, MajorVersion, MinorVersion))) {
+		#ifndef NDEBUG
+		std::clog << "NavAreaStream::Next(index "<<std::to_string(index)<<"): failed to read area data.\n";
+		#endif
+		failed = true;
+		return false;
+	}
+	index++;
+	return true;
+}
+
+// Index of the next area.
+size_t NavAreaStream::GetIndex() const {
+	return index;
+}
+
+// Did decoding fail?
+bool NavAreaStream::Failed() const {
+	return failed;
+}
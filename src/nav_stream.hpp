@@ -0,0 +1,35 @@
+#ifndef NAV_STREAM_HPP
+#define NAV_STREAM_HPP
+#include <optional>
+#include <streambuf>
+#include "nav_buffer.hpp"
+#include "nav_area.hpp"
+
+/*
+	Forward-only reader of area data.
+	Decodes one area at a time from a stream or from NAV data in memory,
+	so read-only work over a mesh doesn't need the whole area container.
+	The source must be positioned at the first area (NavFile::ReadHeader() leaves it there).
+*/
+class NavAreaStream {
+	private:
+		// Exactly one source is set.
+		NavBufferReader* reader = nullptr;
+		std::streambuf* stream = nullptr;
+		unsigned int MajorVersion;
+		std::optional<unsigned int> MinorVersion;
+		size_t AreaCount, index = 0u;
+		bool failed = false;
+	public:
+		NavAreaStream(NavBufferReader& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion, const size_t& AreaCount);
+		NavAreaStream(std::streambuf& buf, const unsigned int& MajorVersion, const std::optional<unsigned int>& MinorVersion, const size_t& AreaCount);
+
+		/* Decode the next area into area, replacing its contents.
+		   Returns false once all areas have been read, or on failure (see Failed()). */
+		bool Next(NavArea& area);
+		// Index of the next area.
+		size_t GetIndex() const;
+		// Did decoding fail?
+		bool Failed() const;
+};
+#endif
@@ -7,16 +7,19 @@
 #include <cstring>
 #include <functional>
 #include <getopt.h>
-#include <random>
 #include <filesystem>
 #include <regex>
 #include <iterator>
 #include <cassert>
+#include <fstream>
+#include <sstream>
 #include "toml++/toml.hpp"
 #include "utils.hpp"
 #include "property_func_map.hpp"
 #include "nav_tool.hpp"
 #include "test_automation.hpp"
+#include "nav_server.hpp"
+#include "nav_custom_data.hpp"
 
 #define NDEBUG
 // Default TOML config.
@@ -84,14 +87,14 @@ NavTool::NavTool(int& argc, char** argv) {
 				std::filesystem::path path_to_config = std::string(getenv("CONFIG"));
 				// Does it exist?
 				if (!std::filesystem::exists(path_to_config)) {
-					std::clog << "CONFIG file does not exist.\n";
+					(*logStream) << "CONFIG file does not exist.\n";
 					exit(EXIT_FAILURE);
 				}
 				// Validate path.
 				std::filesystem::file_status stats = std::filesystem::status(path_to_config);
 				// Needs to be able to read file.
 				if (!((bool)(stats.permissions() & std::filesystem::perms::owner_read))) {
-					std::clog << "warning: Can't read CONFIG file. Ignoring." << std::endl;
+					(*logStream) << "warning: Can't read CONFIG file. Ignoring." << std::endl;
 				}
 
 				// Attempt to load toml config.
@@ -109,6 +112,13 @@ NavTool::NavTool(int& argc, char** argv) {
 	else exit(EXIT_FAILURE);
 }
 
+/* Tool that runs commands on file, which it doesn't own, using config.
+Output goes to out and messages to log. Actions leave saving to the caller. */
+NavTool::NavTool(NavFile& file, const toml::parse_result& config, std::ostream& out, std::ostream& log)
+: inFile(file), outStream(&out), logStream(&log), programConfig(config), deferSave(true) {
+	
+}
+
 NavTool::~NavTool() {
 	
 }
@@ -119,7 +129,8 @@ const std::map<std::string, ActionType> cmdStrToCmdType = {
 	{"edit", ActionType::EDIT},
 	{"delete",  ActionType::DELETE},
 	{"info", ActionType::INFO},
-	{"test", ActionType::TEST}
+	{"test", ActionType::TEST},
+	{"batch", ActionType::BATCH}
 };
 
 // Map to `TargetType` from string.
@@ -133,6 +144,19 @@ const std::map<std::string, TargetType> strToTargetType = {
 	{"ladder", TargetType::LADDER}
 };
 
+// Map to `NavCompression` from string.
+const std::map<std::string, NavCompression> strToCompression = {
+	{"none", NavCompression::NONE},
+	{"gzip", NavCompression::GZIP},
+	{"zstd", NavCompression::ZSTD}
+};
+
+// Map to byte order from string.
+const std::map<std::string, std::endian> strToByteOrder = {
+	{"little", std::endian::little},
+	{"big", std::endian::big}
+};
+
 // Map between string and data offset. Used for the edit command.
 const std::map<std::string, size_t> strToOffset;
 
@@ -141,10 +165,62 @@ const std::map<std::string, size_t> strToOffset;
 std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 	ToolCmd cmd;
 	if (argc < 2) {
-		std::cerr << "Usage: nav file <filepath>…. Use '--help' for info.\n";
+		(*logStream) << "Usage: nav file <filepath>…. Use '--help' for info.\n";
 		return {};
 	}
+	// Serving takes a socket path instead of a file.
+	if (std::string(argv[1]) == "serve") {
+		if (argc != 3) {
+			(*logStream) << "Usage: nav serve <socket path>\n";
+			return {};
+		}
+		cmd.cmdType = ActionType::SERVE;
+		cmd.actionParams.emplace_back(argv[2]);
+		return cmd;
+	}
 	unsigned int argit = 1u;
+	// Options.
+	while (argit < argc && std::string(argv[argit]).starts_with("--"))
+	{
+		if (std::string(argv[argit]) == "--compress") {
+			if (argit + 1 >= argc) {
+				(*logStream) << "Missing compression (none, gzip or zstd).\n";
+				return {};
+			}
+			auto compressionIt = strToCompression.find(argv[argit + 1]);
+			if (compressionIt == strToCompression.cend()) {
+				(*logStream) << "Invalid compression \'"<<argv[argit + 1]<<"\'!\n";
+				return {};
+			}
+			if (!IsNavCompressionSupported(compressionIt->second)) {
+				(*logStream) << "This build can't write \'"<<argv[argit + 1]<<"\' compressed files.\n";
+				return {};
+			}
+			cmd.compression = compressionIt->second;
+			argit += 2u;
+		}
+		else if (std::string(argv[argit]) == "--byte-order") {
+			if (argit + 1 >= argc) {
+				(*logStream) << "Missing byte order (little or big).\n";
+				return {};
+			}
+			auto byteOrderIt = strToByteOrder.find(argv[argit + 1]);
+			if (byteOrderIt == strToByteOrder.cend()) {
+				(*logStream) << "Invalid byte order \'"<<argv[argit + 1]<<"\'!\n";
+				return {};
+			}
+			cmd.byteOrder = byteOrderIt->second;
+			argit += 2u;
+		}
+		else {
+			(*logStream) << "Invalid option \'"<<argv[argit]<<"\'!\n";
+			return {};
+		}
+	}
+	if (argit >= argc) {
+		(*logStream) << "Expected 'file' argument.\n";
+		return {};
+	}
 	// Process the target data.
 	auto strTargetMapIt = strToTargetType.find(std::string(argv[argit]));
 	std::string argbuf = argv[argit];
@@ -161,16 +237,17 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 		case TargetType::FILE:
 			{
 				if (argit + 1 >= argc) {
-					std::clog << "Missing file path.\n";
+					(*logStream) << "Missing file path.\n";
 					return {};
 				}
-				// Validate path.
-				if (!std::filesystem::exists(argv[argit + 1])) {
-					std::clog << "File \'"<<argv[argit + 1] <<"\' does not exist.\n";
+				// Validate path. Standard input doesn't have one.
+				if (argv[argit + 1] == std::string(NAV_STDIO_PATH)) {}
+				else if (!std::filesystem::exists(argv[argit + 1])) {
+					(*logStream) << "File \'"<<argv[argit + 1] <<"\' does not exist.\n";
 					return {};
 				}
 				else if (std::filesystem::is_directory(argv[argit + 1])) {
-					std::clog << "Path to file is a directory.\n";
+					(*logStream) << "Path to file is a directory.\n";
 					return {};
 				}
 				// Store path.
@@ -184,19 +261,19 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 			if (cmd.file.has_value())
 			{
 				if (argit + 1 >= argc) {
-					std::clog << "Missing area ID or Index.\n";
+					(*logStream) << "Missing area ID or Index.\n";
 					return {};
 				}
 				auto ret = StrToIndex(argv[argit + 1]);
 				// It's invalid.
 				if (!ret.has_value()) {
-					std::clog << "Invalid value \'"<<argv[argit + 1]<<"\'!\n";
+					(*logStream) << "Invalid value \'"<<argv[argit + 1]<<"\'!\n";
 					return {};
 				}
 				cmd.areaLocParam = ret;
 			}
 			else {
-				std::clog << "Missing file path to NAV.\n";
+				(*logStream) << "Missing file path to NAV.\n";
 				return {};
 			}
 			argit += 2u;
@@ -205,7 +282,7 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 		case TargetType::HIDE_SPOT:
 			if (cmd.areaLocParam.has_value()) {
 				if (argit + 1 >= argc) {
-					std::cerr << "Missing hide spot index.\n";
+					(*logStream) << "Missing hide spot index.\n";
 					return {};
 				}
 				cmd.hideSpotID = std::stoul(argv[argit + 1]);
@@ -214,7 +291,7 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 			break;
 		case TargetType::ENCOUNTER_PATH:
 			if (argit + 1 >= argc) {
-				std::clog << "Missing encounter path index.\n";
+				(*logStream) << "Missing encounter path index.\n";
 				return {};
 			}
 			cmd.encounterPathIndex = std::stoul(argv[argit + 1]);
@@ -224,13 +301,13 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 			// Ensure encounter path is specified
 			if (cmd.target == TargetType::ENCOUNTER_PATH) {
 				if (argit + 1 >= argc) {
-					std::clog << "Missing encounter spot Index.\n";
+					(*logStream) << "Missing encounter spot Index.\n";
 					return {};
 				}
 				cmd.encounterSpotID = std::stoul(argv[argit + 1]);
 			}
 			else {
-				std::clog << "Encounter path must be specified!\n";
+				(*logStream) << "Encounter path must be specified!\n";
 				return {};
 			}
 			argit += 2u;
@@ -238,11 +315,11 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 		// Connection
 		case TargetType::CONNECTION:
 			if (argit + 1 >= argc) {
-				std::clog << "Missing direction parameter.\n";
+				(*logStream) << "Missing direction parameter.\n";
 				return {};
 			}
 			else if (argit + 2 >= argc) {
-				std::clog << "Missing connection index.\n";
+				(*logStream) << "Missing connection index.\n";
 				return {};
 			}
 			{
@@ -252,14 +329,14 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 					// Clamp value.
 					direc = static_cast<Direction>(std::stoi(argv[argit + 1]));
 					if (std::clamp(direc, Direction::North, Direction::West) != direc) {
-						std::clog << "warning: Direction value out of range. Clamping direction value!\n";
+						(*logStream) << "warning: Direction value out of range. Clamping direction value!\n";
 						direc = std::clamp(direc, Direction::North, Direction::West);
 					}
 				}
 				else {
 					auto strDirecIt = strToDirection.find(argv[argit + 1]);
 					if (strDirecIt == strToDirection.cend()) {
-						std::clog << "Invalid direction specified!\n";
+						(*logStream) << "Invalid direction specified!\n";
 						return {};
 					}
 					else direc = strDirecIt->second;
@@ -267,7 +344,7 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 				// Check connection index.
 				std::string buf = argv[argit + 2];
 				if (!std::all_of(buf.cbegin(), buf.cend(), isxdigit)) {
-					std::clog << "Invalid connection index.\n";
+					(*logStream) << "Invalid connection index.\n";
 					return {};
 				}
 				cmd.connectionIndex = std::make_pair(direc, std::stoul(buf));
@@ -279,7 +356,7 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 			break;
 		case TargetType::INVALID:
 		default:
-			std::clog << "Invalid target \'"<<argv[argit]<<"\'!\n";
+			(*logStream) << "Invalid target \'"<<argv[argit]<<"\'!\n";
 			return {};
 			break;
 		}
@@ -289,7 +366,7 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 	// Area is unspecified.
 	if (!cmd.areaLocParam.has_value() && cmd.target != TargetType::FILE)
 	{
-		std::clog << "Area not specified!\n";
+		(*logStream) << "Area not specified!\n";
 		return {};
 	}
 	// Try to process action.
@@ -306,13 +383,13 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 		}
 	}
 	else {
-		std::clog << "Expected command!\n";
+		(*logStream) << "Expected command!\n";
 		return {};
 	}
 	// We need a file unless if were running test command.
 	if (!cmd.file.has_value() && cmd.cmdType != ActionType::TEST) {
 		
-		std::clog << "Expected 'file' argument. Got '" << argv[1] << "'\n";
+		(*logStream) << "Expected 'file' argument. Got '" << argv[1] << "'\n";
 		return {};
 	}
 	// Successfully parsed command line.
@@ -322,17 +399,45 @@ std::optional<ToolCmd> NavTool::ParseCommandLine(int& argc, char* argv[]) {
 // Actually executed the command.
 bool NavTool::DispatchCommand(ToolCmd& cmd) {
 	if (cmd.file.has_value()) inFile = cmd.file.value();
-	if (cmd.cmdType != ActionType::TEST) {
-		std::filebuf inBuf;
-		if (!inBuf.open(inFile.GetFilePath(), std::ios_base::in)) {
-			std::cerr << "fatal: Failed to open file buffer.\n";
-			return false;
+	if (cmd.cmdType != ActionType::TEST && cmd.cmdType != ActionType::SERVE) {
+		// Getting info of a single area by ID only needs that area, if the sidecar index is current.
+		bool singleArea = cmd.cmdType == ActionType::INFO && cmd.target != TargetType::FILE && cmd.target != TargetType::LADDER
+			&& cmd.areaLocParam.has_value() && cmd.areaLocParam.value().first == true;
+		// File info only needs the header. The ladder count is only shown if the sidecar index knows it.
+		if (cmd.cmdType == ActionType::INFO && cmd.target == TargetType::FILE && inFile.ReadFileHeader(true)) {}
+		// Other info only needs one area at an index, so stream the areas instead of keeping them.
+		else if (cmd.cmdType == ActionType::INFO && !singleArea && cmd.target != TargetType::LADDER) {
+			std::optional<NavArea> foundArea;
+			const bool byIndex = cmd.target != TargetType::FILE && cmd.areaLocParam.has_value();
+			if (!inFile.StreamFile([&cmd, &foundArea, &byIndex](NavArea& area, const size_t& index) -> bool {
+				if (!byIndex || index != cmd.areaLocParam.value().second) return true;
+				foundArea = area;
+				return false;
+			})) {
+				(*logStream) << "Failed to parse input file. Input file could potentially be corrupt!\n";
+				return false;
+			}
+			if (byIndex) {
+				if (!foundArea.has_value()) {
+					(*logStream) << "Area index parameter is out of range.\n";
+					return false;
+				}
+				// The area is the only one loaded.
+				inFile.areas = std::vector<NavArea>{foundArea.value()};
+				cmd.areaLocParam.value().second = 0u;
+			}
 		}
-		// Try to fill in file data.
-		if (!inFile.ReadData(inBuf)) {
-			std::clog << "Failed to parse input file. Input file could potentially be corrupt!\n";
-			return false;
+		else if (!singleArea || !inFile.ReadFileArea(cmd.areaLocParam.value().second)) {
+			// Try to fill in file data.
+			if (!inFile.ReadFile()) {
+				(*logStream) << "Failed to parse input file. Input file could potentially be corrupt!\n";
+				return false;
+			}
+			// Refresh the sidecar index so later lookups can skip the full parse.
+			if (singleArea && !inFile.UpdateIndexFile()) (*logStream) << "warning: Could not write area index.\n";
 		}
+		if (cmd.compression.has_value()) inFile.SetCompression(cmd.compression.value());
+		if (cmd.byteOrder.has_value()) inFile.SetByteOrder(cmd.byteOrder.value());
 	}
 	switch (cmd.cmdType)
 	{
@@ -352,18 +457,30 @@ bool NavTool::DispatchCommand(ToolCmd& cmd) {
 	case ActionType::DELETE:
 		return ActionDelete(cmd);
 		break;
+	// Run a script of commands.
+	case ActionType::BATCH:
+		return ActionBatch(cmd);
+		break;
+	// Keep files loaded for clients of a socket.
+	case ActionType::SERVE:
+		{
+			NavServer server(programConfig);
+			if (!server.Listen(cmd.actionParams.front())) return false;
+			server.Run();
+		}
+		break;
 	// Test
 	case ActionType::TEST:
 		{
-			std::deque<std::function<std::pair<bool, std::string>() > > funcs = {TestNavConnectionDataIO, TestEncounterSpotIO, TestEncounterPathIO, TestNavAreaDataIO, TestNAVFileIO};
+			std::deque<std::function<std::pair<bool, std::string>() > > funcs = {TestNavConnectionDataIO, TestEncounterSpotIO, TestEncounterPathIO, TestNavAreaDataIO, TestNAVFileIO, TestNavBufferIO, TestParallelAreaDecode, TestNavAreaStream, TestNavAreaPatch, TestNavFileSave, TestNavIncrementalSave, TestNavFileHeader, TestNavAreaLazySections, TestNavAreaSchema, TestNavAreaTable, TestNavFileArena, TestNavGraph, TestNavIDMap, TestNavServer, TestLibNav, TestNavCompressedIO, TestNavPipeIO, TestNavByteOrder, TestNavCorruptCounts, TestNavCustomData};
 			for (size_t i = 0; i < funcs.size(); i++)
 			{
-				std::cout << funcs.at(i)().second << '\n';
+				(*outStream) << funcs.at(i)().second << '\n';
 			}
 		}
 		break;
 	case ActionType::INVALID:
-		std::clog << "Invalid command!\n";
+		(*logStream) << "Invalid command!\n";
 		return false;
 
 	default:
@@ -378,31 +495,8 @@ bool NavTool::DispatchCommand(ToolCmd& cmd) {
 bool NavTool::ActionCreate(ToolCmd& cmd) {
 	std::filesystem::file_status inFileStatus = std::filesystem::status(inFile.GetFilePath());
 	// Read only, can't edit.
-	if (!(bool)(inFileStatus.permissions() & std::filesystem::perms::owner_write)) {
-		std::cerr << "Input file is read only.\n";
-		return false;
-	}
-	// Generate temporary file path.
-	std::filesystem::path TempPath = std::filesystem::temp_directory_path();
-	{
-		std::mt19937 mt_gen;
-		std::string tempFileName = std::to_string(mt_gen());
-		TempPath.append("nav/");
-		// Create directories
-		if (!std::filesystem::exists(TempPath)) std::filesystem::create_directories(TempPath);
-		TempPath.append(tempFileName);
-	}
-	// Setup temp file buffer.
-	std::filebuf tmpfile;
-	if (!tmpfile.open(TempPath, std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary)) {
-		std::cerr << "Could not create temporary file.\n";
-		return false;
-	}
-	// 
-	std::filebuf inBuf;
-	if (!inBuf.open(inFile.GetFilePath(), std::ios_base::in | std::ios_base::out | std::ios_base::binary)) {
-		std::cerr << "fatal: Failed to open buffer.\n";
-		std::filesystem::remove(TempPath);
+	if (inFile.GetFilePath() != NAV_STDIO_PATH && !(bool)(inFileStatus.permissions() & std::filesystem::perms::owner_write)) {
+		(*logStream) << "Input file is read only.\n";
 		return false;
 	}
 	switch (cmd.target)
@@ -429,26 +523,24 @@ bool NavTool::ActionCreate(ToolCmd& cmd) {
 	if (!inFile.areas.has_value()) inFile.areas = std::vector<NavArea>(inFile.GetAreaCount());
 	
 	auto areaIt = inFile.areas.value().end();
-	std::optional<std::streampos> areaLoc;
 	// Find the area, unless if we're creating an area.
 	if (cmd.target != TargetType::AREA) {
 		// Processing areas.
 		if (!cmd.areaLocParam.has_value()) {
-			std::cerr << "fatal: area index not defined.\n";
-			std::filesystem::remove(TempPath);
+			(*logStream) << "fatal: area index not defined.\n";
 			return false;
 		}
 		// It's an ID.
 		if (cmd.areaLocParam.value().first == true) {
-			areaLoc = inFile.FindArea(cmd.areaLocParam.value().second);
+			std::optional<size_t> areaIndex = inFile.FindAreaIndex(cmd.areaLocParam.value().second);
+			if (areaIndex.has_value()) areaIt = inFile.areas.value().begin() + areaIndex.value();
 		}
 		// It's an index
 		else
 		{
 			// Out of bounds.
 			if (std::clamp(cmd.areaLocParam.value().second, 0u, inFile.GetAreaCount()) != cmd.areaLocParam.value().second) {
-				std::cerr << "Specified area index is out of range.\n";
-				std::filesystem::remove(TempPath);
+				(*logStream) << "Specified area index is out of range.\n";
 				return false;
 			}
 			// Set area iterator to the located area at index.
@@ -458,27 +550,34 @@ bool NavTool::ActionCreate(ToolCmd& cmd) {
 		// Could not find area iterator.
 		if (areaIt == inFile.areas.value().end())
 		{
-			std::clog << "Could not find area.\n";
+			(*logStream) << "Could not find area.\n";
 			return false;
 		}
 	}
 	// Now we edit the target data.
 	switch (cmd.target) {
 		case TargetType::AREA:
-			// Add area.
-			areaIt = inFile.areas.value().emplace(areaIt);
-			// Set new area ID.
-			if (cmd.areaLocParam.value().first == true) {
-				areaIt->ID = cmd.areaLocParam.value().second;
+			{
+				NavArea area{};
+				// Set new area ID.
+				if (cmd.areaLocParam.value().first == true) {
+					area.ID = cmd.areaLocParam.value().second;
+					if (inFile.FindAreaIndex(area.ID).has_value()) {
+						(*logStream) << "Area #" << area.ID << " already exists.\n";
+						return false;
+					}
+				}
+				// It's an index. Use an unused ID.
+				else area.ID = inFile.GetNextAreaID();
+				// Set blank coords.
+				area.nwCorner = {0.0f, 0.0f, 0.0f};
+				area.seCorner = {0.0f, 0.0f, 0.0f};
+				// Fill custom data.
+				area.customDataSize = getCustomDataSize(inFile.GetMajorVersion(), inFile.GetMinorVersion());
+				area.customData.resize(area.customDataSize, 0);
+				// Add area.
+				areaIt = inFile.InsertArea(areaIt, std::move(area));
 			}
-			// It's an index. Just use the area count.
-			else areaIt->ID = ++inFile.GetAreaCount();
-			// Set blank coords.
-			areaIt->nwCorner = {0.0f, 0.0f, 0.0f};
-			areaIt->seCorner = {0.0f, 0.0f, 0.0f};
-			// Fill custom data.
-			areaIt->customDataSize = getCustomDataSize(inFile.GetMajorVersion(), inFile.GetMinorVersion());
-			areaIt->customData.resize(areaIt->customDataSize, 0);
 			break;
 		// creating hide spot.
 		case TargetType::HIDE_SPOT:
@@ -487,19 +586,19 @@ bool NavTool::ActionCreate(ToolCmd& cmd) {
 			assert(cmd.hideSpotID.has_value());
 			// Clamp index.
 			if (std::clamp<unsigned char>(cmd.hideSpotID.value(), 0, areaIt->hideSpotData.first) != cmd.hideSpotID.value()) {
-				std::cerr << "Hide spot index parameter is out of range.\n";
-				std::filesystem::remove(TempPath);
+				(*logStream) << "Hide spot index parameter is out of range.\n";
 				return false;
 			}
 			// Create hide spot.
-			areaIt->hideSpotData.second.emplace_back();
+			areaIt->GetHideSpotData().second.emplace_back();
 			areaIt->hideSpotData.first++;
+			inFile.InvalidateHideSpotIndex();
 		}
 		// Create connection.
 		case TargetType::CONNECTION:
 			{
 				if (!cmd.connectionIndex.has_value()) {
-					std::clog << "Connection index not defined.\n";
+					(*logStream) << "Connection index not defined.\n";
 					return false;
 				}
 				
@@ -513,15 +612,15 @@ bool NavTool::ActionCreate(ToolCmd& cmd) {
 		case TargetType::ENCOUNTER_PATH:
 		{
 			if (!cmd.encounterPathIndex.has_value()) {
-				std::clog << "Encounter path index is undefined.\n";
+				(*logStream) << "Encounter path index is undefined.\n";
 				return false;
 			}
-			if (!areaIt->encounterPaths.has_value()) {
-				std::clog << "Area has no encounter paths.\n";
+			if (!areaIt->GetEncounterPaths().has_value()) {
+				(*logStream) << "Area has no encounter paths.\n";
 				return false;
 			}
 			// Create encounter path.
-			areaIt->encounterPaths.value().emplace(areaIt->encounterPaths.value().begin() + cmd.encounterPathIndex.value());
+			areaIt->GetEncounterPaths().value().emplace(areaIt->GetEncounterPaths().value().begin() + cmd.encounterPathIndex.value());
 			// Increment count.
 			areaIt->encounterPathCount++;
 		}
@@ -530,19 +629,19 @@ bool NavTool::ActionCreate(ToolCmd& cmd) {
 		case TargetType::ENCOUNTER_SPOT:
 		{
 			if (!cmd.encounterSpotID.has_value()) {
-				std::clog << "fatal: Encounter spot index not set.\n";
+				(*logStream) << "fatal: Encounter spot index not set.\n";
 				return false;
 			}
 			else if (!cmd.encounterPathIndex.has_value()) {
-				std::clog << "fatal: Encounter path index not set.\n";
+				(*logStream) << "fatal: Encounter path index not set.\n";
 				return false;
 			}
 			// Encounter path has to BE there.
 			if (areaIt->encounterPathCount < 1) {
-				std::clog << "There are no encounter paths\n";
+				(*logStream) << "There are no encounter paths\n";
 				return false;
 			}
-			auto ePathIt = areaIt->encounterPaths.value().begin() + cmd.encounterPathIndex.value();
+			auto ePathIt = areaIt->GetEncounterPaths().value().begin() + cmd.encounterPathIndex.value();
 			// Increment counter.
 			ePathIt->spotCount++;
 			// Create encounter spot.
@@ -551,33 +650,21 @@ bool NavTool::ActionCreate(ToolCmd& cmd) {
 		break;
 	}
 	
-	// Ensure the data will be properly written and read.
-	if (!inFile.WriteData(tmpfile)) {
-		std::clog << "fatal: Failed to write NAV data to temp buffer.\n";
-		std::filesystem::remove(TempPath);
-		return false;
-	}
-	tmpfile.pubseekpos(0u);
-	if (!inFile.ReadData(tmpfile)) {
-		std::clog << "fatal: Failed to read NAV data to temp buffer.\n";
-		std::filesystem::remove(TempPath);
-		return false;
-	}
-	inBuf.pubseekpos(0u);
-	// Clear. Write data to inFile.
-	if (!inFile.WriteData(inBuf)) {
-		std::clog << "Failed to write NAV data to input file!\n";
-		std::filesystem::remove(TempPath);
+	if (areaIt != inFile.areas.value().end()) areaIt->MarkDirty();
+	// A batch saves once at the end.
+	if (deferSave) return true;
+	// Save the NAV data, copying the areas that didn't change.
+	if (!inFile.SaveFile(true, true)) {
+		(*logStream) << "fatal: Failed to save NAV file.\n";
 		return false;
 	}
-	std::filesystem::remove(TempPath);
 	return true;
 }
 
 bool NavTool::ActionEdit(ToolCmd& cmd)
 {
 	// Check mappings to ensure they actually exist.
-	if (!std::all_of(cmd.actionParams.cbegin(), cmd.actionParams.cend(), [&file = inFile, &conf = programConfig](std::string_view view) -> bool {
+	if (!std::all_of(cmd.actionParams.cbegin(), cmd.actionParams.cend(), [&file = inFile, &conf = programConfig, &log = *logStream](std::string_view view) -> bool {
 		// Ensure it is a number.
 		if (std::all_of(view.begin(), view.end(), [](unsigned char c) -> bool {
 				return std::isxdigit(c) || c == '.';
@@ -588,12 +675,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 		else if (conf["map"]["nav_version"][std::to_string(file.GetMajorVersion())] || conf["map"]) {	
 			if (conf["map"]["nav_version"][std::to_string(file.GetMajorVersion())][view] || conf["map"][view]) return true;
 			else {
-				std::clog << "Property alias not found. Exiting.\n";
+				log << "Property alias not found. Exiting.\n";
 				return false;
 			}
 		}
 		else {
-			std::clog << "'map' table missing, but still attempted to parse string. Exiting\n";
+			log << "'map' table missing, but still attempted to parse string. Exiting\n";
 			return false;
 		}
 	})) {
@@ -602,31 +689,8 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 	
 	std::filesystem::file_status inFileStatus = std::filesystem::status(inFile.GetFilePath());
 	// No write permissions, so can't edit.
-	if (!(bool)(inFileStatus.permissions() & std::filesystem::perms::owner_write)) {
-		std::cerr << "Input file is read only.\n";
-		return false;
-	}
-	// Generate temporary file path.
-	std::filesystem::path TempPath = std::filesystem::temp_directory_path();
-	{
-		std::mt19937 mt_gen;
-		std::string tempFileName = std::to_string(mt_gen());
-		TempPath.append("nav/");
-		// Create directories
-		if (!std::filesystem::exists(TempPath)) std::filesystem::create_directories(TempPath);
-		TempPath.append(tempFileName);
-	}
-	// Setup temp file buffer.
-	std::filebuf tmpfile;
-	if (!tmpfile.open(TempPath, std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary)) {
-		std::cerr << "Could not create temporary file.\n";
-		return false;
-	}
-	// 
-	std::filebuf inBuf;
-	if (!inBuf.open(inFile.GetFilePath(), std::ios_base::in | std::ios_base::out | std::ios_base::binary)) {
-		std::cerr << "fatal: Failed to open buffer.\n";
-		std::filesystem::remove(TempPath);
+	if (inFile.GetFilePath() != NAV_STDIO_PATH && !(bool)(inFileStatus.permissions() & std::filesystem::perms::owner_write)) {
+		(*logStream) << "Input file is read only.\n";
 		return false;
 	}
 	
@@ -634,7 +698,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 	{
 	case TargetType::FILE:
 		{
-			
+			// Nothing to edit, but saving applies a new compression or byte order.
+			if (deferSave || (!cmd.compression.has_value() && !cmd.byteOrder.has_value())) return true;
+			if (!inFile.SaveFile(true, true)) {
+				(*logStream) << "fatal: Failed to save NAV file.\n";
+				return false;
+			}
 			return true;
 		}
 		break;
@@ -649,43 +718,21 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 	auto areaIt = inFile.areas.value().end();
 	// Processing areas.
 	assert(cmd.areaLocParam.has_value());
-	// Area locator parameter an ID. Need to verify the Area with the ID actually exists.
+	// Area locator parameter an ID. Look it up in the area index.
 	if (cmd.areaLocParam.value().first == true) {
-		// NavFile areas are sorted, so simply use that.
-		if (std::is_sorted(inFile.areas.value().begin(), inFile.areas.value().end(), [](const NavArea& lhs, const NavArea& rhs) {
-			return lhs.ID < rhs.ID;
-		})) {
-			if (std::clamp(cmd.areaLocParam.value().second, inFile.areas.value().front().ID, inFile.areas.value().back().ID) != cmd.areaLocParam.value().second) {
-				std::clog << "Area ID not found.\n";
-				return false;
-			}
-		}
-		// Sort areas.
-		else {
-			// Copy area IDs.
-			std::vector<IntID> AreaIDContainer;
-			std::transform(inFile.areas.value().begin(), inFile.areas.value().end(), AreaIDContainer.begin(), [](const NavArea& area) {
-				return area.ID;
-			});
-			// Sort the area IDs.
-			std::sort(AreaIDContainer.begin(), AreaIDContainer.end());
-			if (std::clamp(cmd.areaLocParam.value().second, inFile.areas.value().front().ID, inFile.areas.value().back().ID) != cmd.areaLocParam.value().second) {
-				std::clog << "Area ID not found.\n";
-				return false;
-			}
+		std::optional<size_t> areaIndex = inFile.FindAreaIndex(cmd.areaLocParam.value().second);
+		if (!areaIndex.has_value()) {
+			(*logStream) << "Area ID not found.\n";
+			return false;
 		}
-		// Validated the area ID is within the area ID range. Search for it.
-		areaIt = std::find_if(inFile.areas.value().begin(), inFile.areas.value().end(), [&cmd](const NavArea& area) {
-			return cmd.areaLocParam.value().second == area.ID;
-		});
+		areaIt = inFile.areas.value().begin() + areaIndex.value();
 	}
 	// Area locator parameter is an index. Simply set the iterator to the areas[index].
 	else
 	{
 		// Out of bounds.
 		if (std::clamp(cmd.areaLocParam.value().second, 0u, inFile.GetAreaCount()) != cmd.areaLocParam.value().second) {
-			std::clog << "Specified area index is out of range." << std::endl;
-			std::filesystem::remove(TempPath);
+			(*logStream) << "Specified area index is out of range." << std::endl;
 			return false;
 		}
 		areaIt = inFile.areas.value().begin() + cmd.areaLocParam.value().second;
@@ -693,9 +740,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 	// Verify that the area iterator is actually valid.
 	if (areaIt >= inFile.areas.value().end())
 	{
-		std::clog << "Could not find area.\n";
+		(*logStream) << "Could not find area.\n";
 		return false;
 	}
+	// Where the area data is in the file, so edits that keep its size can be patched in place.
+	std::optional<NavAreaLocation> areaLocation = inFile.FindAreaLocation(areaIt->ID);
+	if (areaLocation.has_value() && areaLocation.value().Index != static_cast<size_t>(areaIt - inFile.areas.value().begin())) areaLocation.reset();
 	// Start editing the target data.
 	std::stringstream dataBuf; // To help with setting binary data.
 	switch (cmd.target) {
@@ -709,12 +759,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						// Error checking.
 						if ((cmd.actionParams.begin() + i) >= cmd.actionParams.end())
 						{
-							std::clog << "Expected an integer.\n";
+							(*logStream) << "Expected an integer.\n";
 							return false;
 						}
 						if (!std::all_of(cmd.actionParams.at(i + 1).cbegin(), cmd.actionParams.at(i + 1).cend(), isxdigit))
 						{
-							std::clog << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
+							(*logStream) << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
 							return false;
 						}
 						//
@@ -723,7 +773,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						dataBuf.seekp(0u);
 						// Write data to buffer.
 						if (!areaIt->WriteData(*dataBuf.rdbuf(), inFile.GetMajorVersion(), inFile.GetMinorVersion())) {
-							std::clog << "Failed to store area data. Exiting.\n";
+							(*logStream) << "Failed to store area data. Exiting.\n";
 							return false;
 						}
 						// Make a change.
@@ -732,7 +782,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						dataBuf.put(Val);
 						// Read data from buffer.
 						if (!areaIt->ReadData(*dataBuf.rdbuf(), inFile.GetMajorVersion(), inFile.GetMinorVersion())) {
-							std::clog << "Failed to get edited area data. Exiting.\n";
+							(*logStream) << "Failed to get edited area data. Exiting.\n";
 							return false;
 						}
 						// Iterate.
@@ -760,7 +810,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 					}
 					else
 					{
-						std::clog << "Invalid property. Exiting.\n";
+						(*logStream) << "Invalid property. Exiting.\n";
 						return false;
 					}
 				}
@@ -772,21 +822,20 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 			// Are there hiding spots in the first place?
 			if (areaIt->hideSpotData.first == 0)
 			{
-				std::clog << "Area has no hide spots.\n";
+				(*logStream) << "Area has no hide spots.\n";
 				return false;
 			}
 			// Should not happen.
 			assert(cmd.hideSpotID.has_value());
 			// Is it in range.
 			if (std::clamp<unsigned char>(cmd.hideSpotID.value(), 0, areaIt->hideSpotData.first - 1) != cmd.hideSpotID.value()) {
-				std::clog << "Hide spot index parameter is out of range.\n";
-				std::filesystem::remove(TempPath);
+				(*logStream) << "Hide spot index parameter is out of range.\n";
 				return false;
 			}
 			// New hide spot.
-			auto hSpotIt = areaIt->hideSpotData.second.begin() + cmd.hideSpotID.value();
+			auto hSpotIt = areaIt->GetHideSpotData().second.begin() + cmd.hideSpotID.value();
 			// Validate iterator.
-			assert(hSpotIt < areaIt->hideSpotData.second.end());
+			assert(hSpotIt < areaIt->GetHideSpotData().second.end());
 			
 			for (size_t i = 0; i < cmd.actionParams.size(); i++)
 			{
@@ -795,12 +844,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 					// Error checking.
 					if ((cmd.actionParams.begin() + i) >= cmd.actionParams.end())
 					{
-						std::clog << "Expected an integer.\n";
+						(*logStream) << "Expected an integer.\n";
 						return false;
 					}
 					if (!std::all_of(cmd.actionParams.at(i + 1).cbegin(), cmd.actionParams.at(i + 1).cend(), isxdigit))
 					{
-						std::clog << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
+						(*logStream) << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
 						return false;
 					}
 					//
@@ -809,7 +858,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 					dataBuf.seekp(0u);
 					// Write data to buffer.
 					if (!hSpotIt->WriteData(*dataBuf.rdbuf())) {
-						std::clog << "Failed to store area data. Exiting.\n";
+						(*logStream) << "Failed to store area data. Exiting.\n";
 						return false;
 					}
 					// Make a change.
@@ -818,7 +867,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 					dataBuf.put(Val);
 					// Read data from buffer.
 					if (!hSpotIt->ReadData(*dataBuf.rdbuf())) {
-						std::clog << "Failed to get edited area data. Exiting.\n";
+						(*logStream) << "Failed to get edited area data. Exiting.\n";
 						return false;
 					}
 					// Iterate.
@@ -845,7 +894,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 				}
 				else
 				{
-					std::clog << "Invalid property. Exiting.\n";
+					(*logStream) << "Invalid property. Exiting.\n";
 					return false;
 				}
 			}
@@ -854,7 +903,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 		case TargetType::ENCOUNTER_PATH:
 			{
 				if (areaIt->encounterPathCount == 0) {
-					std::clog << "Area has no encounter paths\n";
+					(*logStream) << "Area has no encounter paths\n";
 					return false;
 				}
 				// encounterPathIndex should already be defined.
@@ -862,12 +911,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 				// Validate encounter path index.
 				if (std::clamp(cmd.encounterPathIndex.value(), 0u, areaIt->encounterPathCount - 1) != cmd.encounterPathIndex.value())
 				{
-					std::clog << "Invalid encounter path index.\n";
+					(*logStream) << "Invalid encounter path index.\n";
 					return false;
 				}
-				auto ePathIt = areaIt->encounterPaths.value().begin() + cmd.encounterPathIndex.value();
+				auto ePathIt = areaIt->GetEncounterPaths().value().begin() + cmd.encounterPathIndex.value();
 				// Iterator should never be invalid since the index will be kept in check.
-				assert(ePathIt < areaIt->encounterPaths.value().end());
+				assert(ePathIt < areaIt->GetEncounterPaths().value().end());
 				// Parse.
 				for (size_t i = 0; i < cmd.actionParams.size(); i++)
 				{
@@ -876,12 +925,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						// Error checking.
 						if ((cmd.actionParams.begin() + i) >= cmd.actionParams.end())
 						{
-							std::clog << "Expected an integer.\n";
+							(*logStream) << "Expected an integer.\n";
 							return false;
 						}
 						if (!std::all_of(cmd.actionParams.at(i + 1).cbegin(), cmd.actionParams.at(i + 1).cend(), isxdigit))
 						{
-							std::clog << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
+							(*logStream) << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
 							return false;
 						}
 						//
@@ -890,7 +939,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						dataBuf.seekp(0u);
 						// Write data to buffer.
 						if (!ePathIt->WriteData(*dataBuf.rdbuf())) {
-							std::clog << "Failed to store area data. Exiting.\n";
+							(*logStream) << "Failed to store area data. Exiting.\n";
 							return false;
 						}
 						// Make a change.
@@ -899,7 +948,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						dataBuf.put(Val);
 						// Read data from buffer.
 						if (!ePathIt->ReadData(*dataBuf.rdbuf())) {
-							std::clog << "Failed to get edited area data. Exiting.\n";
+							(*logStream) << "Failed to get edited area data. Exiting.\n";
 							return false;
 						}
 						// Iterate.
@@ -926,7 +975,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 					}
 					else
 					{
-						std::clog << "Invalid property. Exiting.\n";
+						(*logStream) << "Invalid property. Exiting.\n";
 						return false;
 					}
 				}
@@ -937,31 +986,31 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 			{
 				if (!cmd.encounterPathIndex.has_value())
 				{
-					std::clog << "Encounter path index is undefined." << std::endl;
+					(*logStream) << "Encounter path index is undefined." << std::endl;
 					return false;
 				}
 				if (!cmd.encounterSpotID.has_value())
 				{
-					std::clog << "Encounter spot index is undefined." << std::endl;
+					(*logStream) << "Encounter spot index is undefined." << std::endl;
 					return false;
 				}
 				// Validate encounter path index.
 				if (std::clamp(cmd.encounterPathIndex.value(), 0u, areaIt->encounterPathCount - 1) != cmd.encounterPathIndex.value())
 				{
-					std::clog << "Invalid encounter path index.\n";
+					(*logStream) << "Invalid encounter path index.\n";
 					return false;
 				}
 				// Validate encounter spot index.
-				if (std::clamp(cmd.encounterSpotID.value(), static_cast<unsigned char>(0), static_cast<unsigned char>(areaIt->encounterPaths.value().at(cmd.encounterPathIndex.value()).spotCount - 1)) != cmd.encounterSpotID.value())
+				if (std::clamp(cmd.encounterSpotID.value(), static_cast<unsigned char>(0), static_cast<unsigned char>(areaIt->GetEncounterPaths().value().at(cmd.encounterPathIndex.value()).spotCount - 1)) != cmd.encounterSpotID.value())
 				{
-					std::clog << "Invalid encounter spot index.\n";
+					(*logStream) << "Invalid encounter spot index.\n";
 					return false;
 				}
 				
-				auto eSpotIt = areaIt->encounterPaths.value().at(cmd.encounterPathIndex.value()).spotContainer.begin() + cmd.encounterSpotID.value();
+				auto eSpotIt = areaIt->GetEncounterPaths().value().at(cmd.encounterPathIndex.value()).spotContainer.begin() + cmd.encounterSpotID.value();
 				// Validate iterator.
-				if (eSpotIt >= areaIt->encounterPaths.value().at(cmd.encounterPathIndex.value()).spotContainer.end()) {
-					std::clog << "Bad iterator to encounter spot\n";
+				if (eSpotIt >= areaIt->GetEncounterPaths().value().at(cmd.encounterPathIndex.value()).spotContainer.end()) {
+					(*logStream) << "Bad iterator to encounter spot\n";
 					return false;
 				}
 				// Parse arguments.
@@ -972,12 +1021,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						// Error checking.
 						if ((cmd.actionParams.begin() + i) >= cmd.actionParams.end())
 						{
-							std::clog << "Expected an integer.\n";
+							(*logStream) << "Expected an integer.\n";
 							return false;
 						}
 						if (!std::all_of(cmd.actionParams.at(i + 1).cbegin(), cmd.actionParams.at(i + 1).cend(), isxdigit))
 						{
-							std::clog << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
+							(*logStream) << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
 							return false;
 						}
 						//
@@ -985,7 +1034,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						dataBuf.seekp(0u);
 						// Write data to buffer.
 						if (!eSpotIt->WriteData(*dataBuf.rdbuf())) {
-							std::clog << "Failed to store area data. Exiting.\n";
+							(*logStream) << "Failed to store area data. Exiting.\n";
 							return false;
 						}
 						// Make a change.
@@ -994,7 +1043,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						dataBuf.put(Val);
 						// Read data from buffer.
 						if (!eSpotIt->ReadData(*dataBuf.rdbuf())) {
-							std::clog << "Failed to get edited area data. Exiting.\n";
+							(*logStream) << "Failed to get edited area data. Exiting.\n";
 							return false;
 						}
 						// Clear buffer.
@@ -1024,7 +1073,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 					}
 					else
 					{
-						std::clog << "Invalid property. Exiting.\n";
+						(*logStream) << "Invalid property. Exiting.\n";
 						return false;
 					}
 				}
@@ -1034,12 +1083,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 		case TargetType::CONNECTION:
 			{
 				if (!cmd.connectionIndex.has_value()) {
-					std::clog << "Connection index parameter is undefined." << std::endl;
+					(*logStream) << "Connection index parameter is undefined." << std::endl;
 					return false;
 				}
 				// Clamp connection index.
 				if (std::clamp(cmd.connectionIndex.value().second, 0u, areaIt->connectionData.at((unsigned char)cmd.connectionIndex.value().first).first) != cmd.connectionIndex.value().second) {
-					std::clog << "Connection index is out of range." << std::endl;
+					(*logStream) << "Connection index is out of range." << std::endl;
 					return false;
 				}
 				// Iterator to connection.
@@ -1047,7 +1096,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 				// Validate Iterator.
 				if (connectionIt >= areaIt->connectionData.at(static_cast<unsigned char>(cmd.connectionIndex.value().first)).second.end())
 				{
-					std::clog << "Cannot find connection." << std::endl;
+					(*logStream) << "Cannot find connection." << std::endl;
 					return false;
 				}
 				
@@ -1059,12 +1108,12 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						// Error checking.
 						if ((cmd.actionParams.begin() + i) >= cmd.actionParams.end())
 						{
-							std::clog << "Expected an integer.\n";
+							(*logStream) << "Expected an integer.\n";
 							return false;
 						}
 						if (!std::all_of(cmd.actionParams.at(i + 1).cbegin(), cmd.actionParams.at(i + 1).cend(), isxdigit))
 						{
-							std::clog << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
+							(*logStream) << "Value \'"<<cmd.actionParams.at(i + 1)<<"\' should be an integer.\n";
 							return false;
 						}
 						//
@@ -1072,7 +1121,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						dataBuf.seekp(0u);
 						// Write data to buffer.
 						if (!connectionIt->WriteData(*dataBuf.rdbuf())) {
-							std::clog << "Failed to store area data. Exiting.\n";
+							(*logStream) << "Failed to store area data. Exiting.\n";
 							return false;
 						}
 						// Make a change.
@@ -1081,7 +1130,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 						dataBuf.put(Val);
 						// Read data from buffer.
 						if (!connectionIt->ReadData(*dataBuf.rdbuf())) {
-							std::clog << "Failed to get edited area data. Exiting.\n";
+							(*logStream) << "Failed to get edited area data. Exiting.\n";
 							return false;
 						}
 						// Clear buffer.
@@ -1111,7 +1160,7 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 					}
 					else
 					{
-						std::clog << "Invalid property. Exiting.\n";
+						(*logStream) << "Invalid property. Exiting.\n";
 						return false;
 					}
 				}
@@ -1123,29 +1172,19 @@ bool NavTool::ActionEdit(ToolCmd& cmd)
 			break;
 		//
 		default:
-			std::clog << "Can't handle this type of data yet." << std::endl;
+			(*logStream) << "Can't handle this type of data yet." << std::endl;
 			break;
 	}
-	// Ensure the NAV data will be properly written.
-	if (!inFile.WriteData(tmpfile)) {
-		std::clog << "Failed to write area data to temporary file!\n";
-		std::filesystem::remove(TempPath);
-		return false;
-	}
-	tmpfile.pubseekpos(0u, std::ios_base::in | std::ios_base::out);
-	if (!inFile.ReadData(tmpfile)) {
-		std::clog << "Failed to read area data to temporary file!\n";
-		std::filesystem::remove(TempPath);
-		return false;
-	}
-	// Clear. Write to inFile
-	inBuf.pubseekpos(0);
-	if (!inFile.WriteData(inBuf)) {
-		std::clog << "Failed to read area data to input file!\n";
-		std::filesystem::remove(TempPath);
+	areaIt->MarkDirty();
+	// A batch saves once at the end.
+	if (deferSave) return true;
+	// The area is the same size, so only write the changed bytes.
+	if (areaLocation.has_value() && inFile.PatchAreaData(areaLocation.value())) return true;
+	// Save the NAV data, copying the areas that didn't change.
+	if (!inFile.SaveFile(true, true)) {
+		(*logStream) << "Failed to save NAV file!\n";
 		return false;
 	}
-	std::filesystem::remove(TempPath);
 	return true;
 }
 
@@ -1154,30 +1193,8 @@ bool NavTool::ActionDelete(ToolCmd& cmd)
 {
 	std::filesystem::file_status inFileStatus = std::filesystem::status(inFile.GetFilePath());
 	// Read only, can't edit.
-	if (!(bool)(inFileStatus.permissions() & std::filesystem::perms::owner_write)) {
-		std::cerr << "Input file is read only.\n";
-		return false;
-	}
-	// Generate temporary file path.
-	std::filesystem::path TempPath = std::filesystem::temp_directory_path();
-	{
-		std::mt19937 mt_gen;
-		std::string tempFileName = std::to_string(mt_gen());
-		TempPath.append("nav/");
-		// Create directories
-		if (!std::filesystem::exists(TempPath)) std::filesystem::create_directories(TempPath);
-		TempPath.append(tempFileName);
-	}
-	// Setup temp file buffer.
-	std::filebuf tmpfile;
-	if (!tmpfile.open(TempPath, std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary)) {
-		std::clog << "Could not create temporary file buffer.\n";
-		return false;
-	}
-	std::filebuf inBuf;
-	if (!inBuf.open(inFile.GetFilePath(), std::ios_base::in | std::ios_base::out | std::ios_base::binary)) {
-		std::clog << "fatal: Failed to open buffer.\n";
-		std::filesystem::remove(TempPath);
+	if (inFile.GetFilePath() != NAV_STDIO_PATH && !(bool)(inFileStatus.permissions() & std::filesystem::perms::owner_write)) {
+		(*logStream) << "Input file is read only.\n";
 		return false;
 	}
 	
@@ -1201,32 +1218,22 @@ bool NavTool::ActionDelete(ToolCmd& cmd)
 	auto areaIt = inFile.areas.value().end();
 	// This should be defined.
 	assert(cmd.areaLocParam.has_value());
-	// It's an ID. Do some checking to ensure we can reach it.
+	// It's an ID. Look it up in the area index.
 	if (cmd.areaLocParam.value().first == true) 
 		{
-			// Sort area container so that we can get the mins and maxes.
-			if (!std::is_sorted(inFile.areas.value().begin(), inFile.areas.value().end(), [](const NavArea& lhs, const NavArea& rhs) {return lhs.ID < rhs.ID;})) 
-				std::sort(inFile.areas.value().begin(), inFile.areas.value().end(), [](const NavArea& lhs, const NavArea& rhs) constexpr -> bool {
-				return lhs.ID < rhs.ID;
-			});
-			// Check if the ID is within the minmax ID range.
-			if (std::clamp(cmd.areaLocParam.value().second, inFile.areas.value().front().ID, inFile.areas.value().back().ID) != cmd.areaLocParam.value().second) {
-				std::clog << "Requested ID is outside the found ID range #"<<std::to_string(inFile.areas.value().front().ID)<<" to #"<<std::to_string(inFile.areas.value().back().ID)<<".\n";
-				std::filesystem::remove(TempPath);
+			std::optional<size_t> areaIndex = inFile.FindAreaIndex(cmd.areaLocParam.value().second);
+			if (!areaIndex.has_value()) {
+				(*logStream) << "Could not find area ID #"<<std::to_string(cmd.areaLocParam.value().second)<<".\n";
 				return false;
 			}
-			// Try find the area.
-			areaIt = std::find_if<std::vector<NavArea>::iterator >(inFile.areas.value().begin(), inFile.areas.value().end(), [&cmd](const NavArea& a) constexpr -> bool {
-				return cmd.areaLocParam.value().second == a.ID;
-			});
+			areaIt = inFile.areas.value().begin() + areaIndex.value();
 		}
 	// It's an index
 	else
 	{
 		// Out of bounds.
 		if (std::clamp<unsigned int>(cmd.areaLocParam.value().second, 0u, inFile.areas.value().size()) != cmd.areaLocParam.value().second) {
-			std::clog << "Specified area index is out of range.\n";
-			std::filesystem::remove(TempPath);
+			(*logStream) << "Specified area index is out of range.\n";
 			return false;
 		}
 		// Go to the area where the index points to.
@@ -1234,8 +1241,7 @@ bool NavTool::ActionDelete(ToolCmd& cmd)
 	}
 	// Did we find the specified area.
 	if (areaIt >= inFile.areas.value().end()) {
-		std::clog << "Could not find area.\n";
-		std::filesystem::remove(TempPath);
+		(*logStream) << "Could not find area.\n";
 		return false;
 	}
 	// We got the area. 
@@ -1243,26 +1249,27 @@ bool NavTool::ActionDelete(ToolCmd& cmd)
 	switch (cmd.target) {
 		case TargetType::AREA:
 			// Delete area.
-			--inFile.GetAreaCount();
-			inFile.areas.value().erase(areaIt);
+			inFile.EraseArea(areaIt);
 			break;
 		case TargetType::HIDE_SPOT:
 		{
 			// HideSpotID should hopefully be defined here.
 			// The target wouldn't be a hide spot if the parameters did not target hide spots.
 			assert(cmd.hideSpotID.has_value());
-			// Clamp
-			if (std::clamp<unsigned char>(cmd.hideSpotID.value(), 0, areaIt->hideSpotData.first) != cmd.hideSpotID.value()) {
-				std::clog << "Hide spot index parameter is out of range.\n";
+			if (cmd.hideSpotID.value() >= areaIt->GetHideSpotData().first) {
+				(*logStream) << "Hide spot index parameter is out of range.\n";
 				Valid = false;
 				break;
 			}
 			// Remove hide spot.
-			if (areaIt->hideSpotData.second.erase(areaIt->hideSpotData.second.begin() + cmd.hideSpotID.value()) == areaIt->hideSpotData.second.cend()) {
-				std::clog << "fatal: Could not locate.\n";
+			if (areaIt->GetHideSpotData().second.erase(areaIt->GetHideSpotData().second.begin() + cmd.hideSpotID.value()) == areaIt->GetHideSpotData().second.cend()) {
+				(*logStream) << "fatal: Could not locate.\n";
 				return false;
 			}
 			areaIt->hideSpotData.first--;
+			areaIt->MarkDirty();
+			inFile.InvalidateHideSpotIndex();
+			break;
 		}
 
 		case TargetType::CONNECTION:
@@ -1271,48 +1278,30 @@ bool NavTool::ActionDelete(ToolCmd& cmd)
 			//
 			if (areaIt->connectionData.at(static_cast<unsigned char>(cmd.connectionIndex.value().first)).first < 1)
 			{
-				std::clog << "No connections found for direction \'"<<static_cast<unsigned char>(cmd.connectionIndex.value().first)<<"\'\n";
+				(*logStream) << "No connections found for direction \'"<<static_cast<unsigned char>(cmd.connectionIndex.value().first)<<"\'\n";
 				Valid = false;
 				break;
 			}
 			// Validate.
 			if (std::clamp(cmd.connectionIndex.value().second, 0u, areaIt->connectionData.at(static_cast<unsigned char>(cmd.connectionIndex.value().first)).first) != cmd.connectionIndex.value().second)
 			{
-				std::clog << "Connection index is out of range.\n";
+				(*logStream) << "Connection index is out of range.\n";
 				Valid = false;
 				break;
 			}
 			// Remove connection.
 			areaIt->connectionData.at(static_cast<unsigned char>(cmd.connectionIndex.value().first)).second.erase(areaIt->connectionData[(unsigned char)cmd.connectionIndex.value().first].second.begin() + cmd.connectionIndex.value().second);
 			areaIt->connectionData.at(static_cast<unsigned char>(cmd.connectionIndex.value().first)).first--;
+			areaIt->MarkDirty();
 			break;
 		default:
 		break;
 	}
-	// Ensure the NAV data will be properly written.
-	if (Valid) 
-	{
-		if (!inFile.WriteData(tmpfile)) {
-			std::cerr << "Failed to write area data to temporary file!\n";
-			std::filesystem::remove(TempPath);
-			return false;
-		}
-		tmpfile.pubseekpos(0u, std::ios_base::in | std::ios_base::out);
-		if (!inFile.ReadData(tmpfile)) {
-			std::cerr << "Failed to read area data to temporary file!\n";
-			std::filesystem::remove(TempPath);
-			return false;
-		}
-		// Clear. Write to inFile.
-		inBuf.pubseekpos(0u);
-		if (!inFile.WriteData(inBuf)) {
-			std::cerr << "Failed to read area data to input file!\n";
-			std::filesystem::remove(TempPath);
-			return false;
-		}
-		
+	// Save the NAV data, copying the areas that didn't change.
+	if (Valid && !deferSave && !inFile.SaveFile(true, true)) {
+		(*logStream) << "Failed to save NAV file!\n";
+		return false;
 	}
-	std::filesystem::remove(TempPath);
 	return Valid;
 }
 
@@ -1323,112 +1312,72 @@ bool NavTool::ActionInfo(ToolCmd& cmd)
 
 	if (cmd.target == TargetType::FILE)
 	{
-		inFile.OutputData(std::cout);
+		inFile.OutputData((*outStream));
+		return true;
+	}
+	if (cmd.target == TargetType::LADDER)
+	{
+		if (!cmd.areaLocParam.has_value()) return false;
+		std::optional<size_t> ladderIndex;
+		// Is ID. Look it up in the ladder index.
+		if (cmd.areaLocParam.value().first == true) ladderIndex = inFile.FindLadderIndex(cmd.areaLocParam.value().second);
+		else if (cmd.areaLocParam.value().second < inFile.ladders.size()) ladderIndex = cmd.areaLocParam.value().second;
+		if (!ladderIndex.has_value()) {
+			(*logStream) << "Could not find ladder.\n";
+			return false;
+		}
+		const NavLadder& ladder = inFile.ladders[ladderIndex.value()];
+		(*outStream) << "Ladder #" << std::to_string(ladder.ID) << ":\n\tWidth: " << ladder.Width << "\n\tLength: " << ladder.Length
+		<< "\n\tTop: " << ladder.TopVec[0] << ", " << ladder.TopVec[1] << ", " << ladder.TopVec[2]
+		<< "\n\tBottom: " << ladder.BottomVec[0] << ", " << ladder.BottomVec[1] << ", " << ladder.BottomVec[2]
+		<< "\n\tDirection: " << std::to_string(ladder.direction)
+		<< "\n\tTop Areas (forward, left, right, behind): " << std::to_string(ladder.TopForwardAreaID) << ", " << std::to_string(ladder.TopLeftAreaID)
+		<< ", " << std::to_string(ladder.TopRightAreaID) << ", " << std::to_string(ladder.TopBehindAreaID)
+		<< "\n\tBottom Area: " << std::to_string(ladder.BottomAreaID) << '\n';
 		return true;
 	}
 
 	// Get info of area.
 	if (!cmd.areaLocParam.has_value()) {
 		#ifndef NDEBUG
-		std::clog << "NavTool::DispatchCommand(ToolCmd&): FATAL: Area not specified!\n";
+		(*logStream) << "NavTool::DispatchCommand(ToolCmd&): FATAL: Area not specified!\n";
 		#endif
 		return false;
 	}
 	// No Areas so we can't do anything.
 	if (inFile.GetAreaCount() < 1)
 	{
-		std::clog << "Input file has no areas.\n";
+		(*logStream) << "Input file has no areas.\n";
 		return false;
 	}
 	
-	std::optional<std::streampos> areaLoc;
 	auto areaIt = inFile.areas.value().end();
-	// Is ID. Search for area.
+	// Is ID. Look it up in the area index.
 	if (cmd.areaLocParam.value().first == true) {
-		// Areas are already sorted.
-		if (std::is_sorted(inFile.areas.value().begin(), inFile.areas.value().end(), [](const NavArea& lhs, const NavArea& rhs) {
-			return lhs.ID < rhs.ID;
-		}))
-		{
-			// Parameter Area ID is out of range.
-			if (std::clamp(cmd.areaLocParam.value().second, inFile.areas.value().front().ID, inFile.areas.value().back().ID) != cmd.areaLocParam.value().second) {
-				std::clog << "Could not find area ID #"<<std::to_string(cmd.areaLocParam.value().second)<<".\n";
-				return false;
-			}
-		}
-		// areas container is not already sorted,
-		else
-		{
-			std::vector<IntID> AreaIDContainer;
-			std::transform(inFile.areas.value().begin(), inFile.areas.value().end(), AreaIDContainer.begin(), [](const NavArea& area) {
-				return area.ID;
-			});
-			// Sort with less than.
-			std::sort(AreaIDContainer.begin(), AreaIDContainer.end());
-			// Is ID in range?
-			if (std::clamp(cmd.areaLocParam.value().second, AreaIDContainer.front(), AreaIDContainer.back()) != cmd.areaLocParam.value().second)
-			{
-				std::clog << "Could not find area ID #"<<std::to_string(cmd.areaLocParam.value().second)<<".\n";
-				return false;
-			}
-		}
-		// Area ID parameter is in possible ID range. Find.
-		size_t sum = std::accumulate(inFile.areas.value().begin(), inFile.areas.value().end(), 0u, [](unsigned int lhs, const NavArea& rhs) -> size_t {
-				return static_cast<size_t>(lhs + rhs.ID);
-			});
-		if (cmd.areaLocParam.value().second == sum / inFile.areas.value().size() )
-			areaIt = std::find_if(inFile.areas.value().begin(), inFile.areas.value().end(), [&cmd](const NavArea& area) -> bool {
-				return cmd.areaLocParam.value().second == area.ID;
-			});
-		else if (cmd.areaLocParam.value().second > sum / inFile.areas.value().size())
-		{
-			
-			areaIt = std::find_if(inFile.areas.value().rbegin(), inFile.areas.value().rend(), [&cmd](const NavArea& area) {
-				return cmd.areaLocParam.value().second == area.ID;
-			}).base();
+		std::optional<size_t> areaIndex = inFile.FindAreaIndex(cmd.areaLocParam.value().second);
+		if (!areaIndex.has_value()) {
+			(*logStream) << "Could not find area ID #"<<std::to_string(cmd.areaLocParam.value().second)<<".\n";
+			return false;
 		}
-		else areaIt = std::find_if(inFile.areas.value().begin(), inFile.areas.value().end(), [&cmd](const NavArea& area) {
-			return cmd.areaLocParam.value().second == area.ID;
-		});
+		areaIt = inFile.areas.value().begin() + areaIndex.value();
 	}
 	// Area locator parameter should be interpeted as an index.
 	else {
 		// Clamp index and ensure the area index parameter is within the container range.
 		if (std::clamp(cmd.areaLocParam.value().second, 0u, inFile.GetAreaCount() - 1) != cmd.areaLocParam.value().second) {
-			std::clog << "Area index parameter is out of range.\n";
+			(*logStream) << "Area index parameter is out of range.\n";
 			return false;
 		}
 		areaIt = inFile.areas.value().begin() + cmd.areaLocParam.value().second;
 	}
-	std::filebuf buf;
-	// File path verification is done in command line parsing.
-	assert(buf.open(inFile.GetFilePath(), std::ios_base::in | std::ios_base::binary));
-	
 	// Output
 	switch (cmd.target)
 	{
 	case TargetType::AREA:
 		{
-			areaIt->OutputData(std::cout);
-			// Also output custom data if possible.
-			std::cout << "\tCustom Data: ";
-			switch (GetAsEngineVersion(inFile.GetMajorVersion(), inFile.GetMinorVersion()))
-			{
-			// Get TFAttributes flag.
-			case TEAM_FORTRESS_2:
-				{
-					unsigned int TFAttributes;
-					std::copy(areaIt->customData.begin(), areaIt->customData.begin() + 3, &TFAttributes);
-					std::cout << "(Team Fortress 2)\n\t\tTFAttributes Flag: " << std::hex << TFAttributes << '\n';
-				}
-				break;
-			
-			case EngineVersion::UNKNOWN:
-				std::cout << "(Unkown custom data.)\n";
-				break;
-			default:
-				break;
-			}
+			areaIt->OutputData((*outStream));
+			// Also output custom data, decoded if possible.
+			OutputCustomData((*outStream), std::as_bytes(std::span(areaIt->customData)), inFile.GetMajorVersion(), inFile.GetMinorVersion());
 		}
 		break;
 	// Output hide spot data.
@@ -1438,23 +1387,23 @@ bool NavTool::ActionInfo(ToolCmd& cmd)
 			assert(cmd.hideSpotID.has_value());
 			// Empty hide spot data.
 			if (areaIt->hideSpotData.first < 1) {
-				std::clog << "Area #" << areaIt->ID << " has 0 hide spots.\n";
+				(*logStream) << "Area #" << areaIt->ID << " has 0 hide spots.\n";
 				return false;
 			}
 			// hideSpot ID is higher than hide spot count.
 			if (std::clamp(cmd.hideSpotID.value(), static_cast<unsigned char>(0u), areaIt->hideSpotData.first) != cmd.hideSpotID.value()) {
-				std::clog << "Hide spot index \'" << std::to_string(cmd.hideSpotID.value()) << "\' is out of range.\n";
+				(*logStream) << "Hide spot index \'" << std::to_string(cmd.hideSpotID.value()) << "\' is out of range.\n";
 				return false;
 			}
 			// Get hide spot data.
-			auto hSpotIt = areaIt->hideSpotData.second.begin() + cmd.hideSpotID.value();
+			auto hSpotIt = areaIt->GetHideSpotData().second.begin() + cmd.hideSpotID.value();
 			// Output ID.
-			std::cout << "Hide Spot #"<<std::to_string(cmd.hideSpotID.value())<<" of Area #"<<areaIt->ID << ":\n\tID: " << std::to_string(hSpotIt->ID) << '\n';
-			std::cout << std::setw(4) << "\tPosition: ";
+			(*outStream) << "Hide Spot #"<<std::to_string(cmd.hideSpotID.value())<<" of Area #"<<areaIt->ID << ":\n\tID: " << std::to_string(hSpotIt->ID) << '\n';
+			(*outStream) << std::setw(4) << "\tPosition: ";
 			// Output hide spot position
-			std::copy(hSpotIt->position.cbegin(), hSpotIt->position.cend(), std::ostream_iterator<float>(std::cout, ", "));
+			std::copy(hSpotIt->position.cbegin(), hSpotIt->position.cend(), std::ostream_iterator<float>((*outStream), ", "));
 			// Output hide spot attribute.
-			std::cout << "\n\tAttributes: " << std::hex << std::showbase << hSpotIt->Attributes << '\n';
+			(*outStream) << "\n\tAttributes: " << std::hex << std::showbase << hSpotIt->Attributes << '\n';
 		}
 		break;
 	case TargetType::CONNECTION:
@@ -1466,12 +1415,12 @@ bool NavTool::ActionInfo(ToolCmd& cmd)
 			// Is there a connection to begin with?
 			if (areaIt->connectionData.at(static_cast<unsigned char>(cmd.connectionIndex.value().first)).first < 1)
 			{
-				std::clog << "Area has no direction \'" << static_cast<unsigned char>(cmd.connectionIndex.value().first) << "\' connections.\n";
+				(*logStream) << "Area has no direction \'" << static_cast<unsigned char>(cmd.connectionIndex.value().first) << "\' connections.\n";
 				return false;
 			}
 			// Keep connection index in range.
 			if (std::clamp(cmd.connectionIndex.value().second, 0u, areaIt->connectionData.at(static_cast<unsigned char>(cmd.connectionIndex.value().first)).first - 1) != cmd.connectionIndex.value().second) {
-				std::cout << "Connection index \'"<< cmd.connectionIndex.value().second<< "\' is out of range!\n";
+				(*outStream) << "Connection index \'"<< cmd.connectionIndex.value().second<< "\' is out of range!\n";
 				return false;
 			}
 			// Get iterator.
@@ -1479,7 +1428,7 @@ bool NavTool::ActionInfo(ToolCmd& cmd)
 			// Iterator SHOULD be valid now.
 			assert(connectionIt < areaIt->connectionData.at(static_cast<unsigned char>(cmd.connectionIndex.value().first)).second.end());
 			// Output connection data.
-			std::cout << directionToStr[cmd.connectionIndex.value().first] << " Connection " << cmd.connectionIndex.value().second
+			(*outStream) << directionToStr[cmd.connectionIndex.value().first] << " Connection " << cmd.connectionIndex.value().second
 			<< ":\n\tTarget Area ID: " << connectionIt->TargetAreaID << '\n';
 		}
 		break;
@@ -1489,7 +1438,7 @@ bool NavTool::ActionInfo(ToolCmd& cmd)
 		{
 			// Area has no encounter paths
 			if (areaIt->encounterPathCount < 1) {
-				std::cout << "Area #" << areaIt->ID << " has 0 encounter paths.\n";
+				(*outStream) << "Area #" << areaIt->ID << " has 0 encounter paths.\n";
 				return false;
 			}
 			// encounterPathIndex should already be defined. Checks for lack of the encounter path locator parameter is done in ParseCommandLine()
@@ -1498,12 +1447,12 @@ bool NavTool::ActionInfo(ToolCmd& cmd)
 			if (cmd.target == TargetType::ENCOUNTER_PATH)
 			{
 				if (std::max(cmd.encounterPathIndex.value(), areaIt->encounterPathCount - 1) == cmd.encounterPathIndex.value()) {
-					std::cerr << "Requested encounter path is out of range.\n";
+					(*logStream) << "Requested encounter path is out of range.\n";
 					return false;
 				}
-				std::cout << "Encounter Path #" << cmd.encounterPathIndex.value() << " of area #" << areaIt->ID <<":\n";
-				areaIt->encounterPaths.value().at(cmd.encounterPathIndex.value()).Output(std::cout);
-				std::cout << '\n';
+				(*outStream) << "Encounter Path #" << cmd.encounterPathIndex.value() << " of area #" << areaIt->ID <<":\n";
+				areaIt->GetEncounterPaths().value().at(cmd.encounterPathIndex.value()).Output((*outStream));
+				(*outStream) << '\n';
 			}
 			// Output encounter spot data.
 			else if (cmd.target == TargetType::ENCOUNTER_SPOT) {
@@ -1511,17 +1460,17 @@ bool NavTool::ActionInfo(ToolCmd& cmd)
 				assert(cmd.encounterSpotID.has_value());
 				// Keep in range.
 				if (std::max(areaIt->encounterPathCount - 1, cmd.encounterPathIndex.value()) == cmd.encounterPathIndex.value()) {
-					std::clog << "The encounter path ID of the requested encounter spot is out of range.\n";
+					(*logStream) << "The encounter path ID of the requested encounter spot is out of range.\n";
 					return false;
 				}
 				else {
-					if (areaIt->encounterPaths.value().at(cmd.encounterPathIndex.value()).spotCount <= cmd.encounterSpotID) {
-						std::cerr << "Requested Encounter Spot of Area #"<<areaIt->ID<<":Encounter Path #"<<cmd.encounterPathIndex.value()<<" is out of range.\n";
+					if (areaIt->GetEncounterPaths().value().at(cmd.encounterPathIndex.value()).spotCount <= cmd.encounterSpotID) {
+						(*logStream) << "Requested Encounter Spot of Area #"<<areaIt->ID<<":Encounter Path #"<<cmd.encounterPathIndex.value()<<" is out of range.\n";
 						return false;
 					}
-					std::cout << "Encounter Spot #" << cmd.encounterPathIndex.value();
-					auto eSpotIt = areaIt->encounterPaths.value().at(cmd.encounterPathIndex.value()).spotContainer.begin() + cmd.encounterSpotID.value();
-					std::cout << ":\n\tOrder ID: " << eSpotIt->OrderID
+					(*outStream) << "Encounter Spot #" << cmd.encounterPathIndex.value();
+					auto eSpotIt = areaIt->GetEncounterPaths().value().at(cmd.encounterPathIndex.value()).spotContainer.begin() + cmd.encounterSpotID.value();
+					(*outStream) << ":\n\tOrder ID: " << eSpotIt->OrderID
 					<< "\n\tParametric Distance: " << eSpotIt->ParametricDistance
 					<< '\n';
 				}
@@ -1533,28 +1482,28 @@ bool NavTool::ActionInfo(ToolCmd& cmd)
 		{
 			// Check version.
 			if (inFile.GetMajorVersion() >= 15) {
-				std::clog << "This file is too new to contain approach spots.\n";
+				(*logStream) << "This file is too new to contain approach spots.\n";
 				return false;
 			}
 			// Ensure the area has an approach spot.
 			if (areaIt->approachSpotCount < 1)
 			{
-				std::clog << "Area has no approach spots.\n";
+				(*logStream) << "Area has no approach spots.\n";
 				return false;
 			}
 			// Approach Spot index should be defined.
 			assert(cmd.approachSpotIndex.has_value());
 			// Clamp approach spot.
 			if (std::max(cmd.approachSpotIndex.value(), static_cast<unsigned char>(areaIt->approachSpotCount - 1)) != cmd.approachSpotIndex.value()) {
-				std::clog << "Approach spot index is out of range.\n";
+				(*logStream) << "Approach spot index is out of range.\n";
 				return false;
 			}
 			//
-			auto aSpotIt = areaIt->approachSpotData.value().begin() + cmd.approachSpotIndex.value();
+			auto aSpotIt = areaIt->GetApproachSpotData().value().begin() + cmd.approachSpotIndex.value();
 			// Approach spot iterator should be valid here.
-			assert(aSpotIt < areaIt->approachSpotData.value().end());
+			assert(aSpotIt < areaIt->GetApproachSpotData().value().end());
 			// Output.
-			std::cout << "Approach Spot ["<<std::to_string(cmd.approachSpotIndex.value())
+			(*outStream) << "Approach Spot ["<<std::to_string(cmd.approachSpotIndex.value())
 			<<"]:\n\tApproach Type: " << std::to_string(aSpotIt->approachType)
 			<< "\n\tApproach Method:" << std::to_string(aSpotIt->approachHow)
 			<< "\n\tPrev ID: " << std::to_string(aSpotIt->approachPrevId)
@@ -1562,19 +1511,94 @@ bool NavTool::ActionInfo(ToolCmd& cmd)
 			<< "\n\tNext ID: " << std::to_string(aSpotIt->approachNextId);
 		}
 		break;
-	case TargetType::LADDER:
-		// TODO:
-		break;
 	default:
 		break;
 	}
 	return true;
 }
 
+// Run a create, edit, delete or info command.
+// Returns true if successful, false on failure.
+bool NavTool::RunAction(ToolCmd& cmd) {
+	// Info only reads the file.
+	if (cmd.compression.has_value() && cmd.cmdType != ActionType::INFO) inFile.SetCompression(cmd.compression.value());
+	if (cmd.byteOrder.has_value() && cmd.cmdType != ActionType::INFO) inFile.SetByteOrder(cmd.byteOrder.value());
+	switch (cmd.cmdType)
+	{
+	case ActionType::CREATE:
+		return ActionCreate(cmd);
+	case ActionType::EDIT:
+		return ActionEdit(cmd);
+	case ActionType::DELETE:
+		return ActionDelete(cmd);
+	case ActionType::INFO:
+		return ActionInfo(cmd);
+	default:
+		(*logStream) << "Invalid command!\n";
+		return false;
+	}
+}
+
+// Runs each command in a script (or stdin) against the loaded file, then saves once.
+// Stops at the first command that fails, without saving.
+// Returns true if successful, false on failure.
+bool NavTool::ActionBatch(ToolCmd& cmd) {
+	if (cmd.actionParams.size() != 1u) {
+		(*logStream) << "Expected a script path (or '-' for stdin).\n";
+		return false;
+	}
+	std::ifstream scriptFile;
+	std::istream* script = &std::cin;
+	if (cmd.actionParams.front() == "-" && inFile.GetFilePath() == NAV_STDIO_PATH) {
+		(*logStream) << "Can't read both the NAV file and the script from stdin.\n";
+		return false;
+	}
+	if (cmd.actionParams.front() != "-") {
+		scriptFile.open(cmd.actionParams.front());
+		if (!scriptFile.is_open()) {
+			(*logStream) << "Could not open script \'" << cmd.actionParams.front() << "\'.\n";
+			return false;
+		}
+		script = &scriptFile;
+	}
+	const std::string filePath = inFile.GetFilePath().string();
+	// A new compression or byte order is a change too.
+	bool modified = cmd.compression.has_value() || cmd.byteOrder.has_value();
+	deferSave = true;
+	std::string line;
+	for (size_t lineNumber = 1u; std::getline(*script, line); lineNumber++)
+	{
+		// Each line is a command as it would follow `nav file <filepath>`.
+		std::vector<std::string> args = {"nav", "file", filePath};
+		{
+			std::istringstream lineStream(line);
+			for (std::string arg; lineStream >> arg;) args.push_back(arg);
+		}
+		// Skip blank lines and comments.
+		if (args.size() == 3u || args.at(3).front() == '#') continue;
+		std::vector<char*> argv;
+		for (std::string& arg : args) argv.push_back(arg.data());
+		int argc = argv.size();
+		std::optional<ToolCmd> lineCmd = ParseCommandLine(argc, argv.data());
+		if (lineCmd.has_value()) modified = modified || lineCmd.value().cmdType != ActionType::INFO;
+		if (!lineCmd.has_value() || !RunAction(lineCmd.value())) {
+			(*logStream) << "Command on line " << lineNumber << " failed. Nothing was saved.\n";
+			deferSave = false;
+			return false;
+		}
+	}
+	deferSave = false;
+	if (!modified) return true;
+	// Save the NAV data once, copying the areas that didn't change.
+	if (!inFile.SaveFile(true, true)) {
+		(*logStream) << "fatal: Failed to save NAV file.\n";
+		return false;
+	}
+	return true;
+}
+
 int main(int argc, char **argv) {
 	NavTool navApp(argc, argv);
-	// Remove temporary files.
-	std::filesystem::remove_all(std::filesystem::temp_directory_path().append("nav/"));
 	// Flush.
 	std::clog.flush();
 	std::cout.flush();
@@ -1,6 +1,7 @@
 #ifndef NAV_TOOL_HPP
 #define NAV_TOOL_HPP
 #include <vector>
+#include <iostream>
 #include "toml++/toml.hpp"
 #include "utils.hpp"
 #include "nav_base.hpp"
@@ -12,6 +13,8 @@ enum class ActionType {
 	DELETE, // Delete data.
 	INFO, // Prints info of nav file.
 	TEST, // Test program.
+	BATCH, // Runs a script of commands against one file, saving once.
+	SERVE, // Keeps files loaded and runs commands sent over a socket.
 	// I want to add nav_analyze into the program, but that's too heavy handed for me currently.
 	// ANALYZE, // Analyzes mesh.
 
@@ -53,18 +56,32 @@ struct ToolCmd {
 	// Parameters for the action.
 	std::optional<size_t> RequestedIndex;
 	std::deque<std::string> actionParams;
+	// How to compress the file when it is saved, if not as it was.
+	std::optional<NavCompression> compression;
+	// Byte order to save the file in, if not as it was.
+	std::optional<std::endian> byteOrder;
 };
 
 class NavTool {
 	private:		
 		ToolCmd cmd;
-		NavFile inFile;
+		// File the tool works on. Its own, unless the tool was made for another file.
+		NavFile ownFile;
+		NavFile& inFile = ownFile;
+		// Where output and messages go.
+		std::ostream* outStream = &std::cout;
+		std::ostream* logStream = &std::clog;
 		std::string CommandLine;
 		// Program config file.
 		toml::parse_result programConfig;
+		// Set while a batch runs, so actions leave saving to it.
+		bool deferSave = false;
 	public:
 		NavTool();
 		NavTool(int& argc, char** argv);
+		/* Tool that runs commands on file, which it doesn't own, using config.
+		   Output goes to out and messages to log. Actions leave saving to the caller. */
+		NavTool(NavFile& file, const toml::parse_result& config, std::ostream& out, std::ostream& log);
 		~NavTool();
 
 	std::optional<ToolCmd> ParseCommandLine(int& argc, char **argv);
@@ -79,5 +96,11 @@ class NavTool {
 	bool ActionDelete(ToolCmd& cmd);
 	// Info action.
 	bool ActionInfo(ToolCmd& cmd);
+	// Run a create, edit, delete or info command.
+	// True if successful.
+	bool RunAction(ToolCmd& cmd);
+	// Batch action.
+	// Runs each command in a script (or stdin) against the loaded file, then saves once.
+	bool ActionBatch(ToolCmd& cmd);
 };
 #endif
\ No newline at end of file
@@ -3,11 +3,48 @@
 #include <sstream>
 #include <utility>
 #include <span>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include "nav_connections.hpp"
 #include "nav_area.hpp"
 #include "nav_file.hpp"
+#include "nav_area_table.hpp"
+#include "nav_graph.hpp"
+#include "nav_id_map.hpp"
+#include "nav_custom_data.hpp"
+#include "nav_codec.hpp"
+#include "nav_server.hpp"
+#include "libnav.h"
 #include "test_automation.hpp"
 
+/* Make a NAV file with areaCount areas, for tests. Areas get IDs from 1, no visible areas and blank custom data,
+then fill is called with each area and its index. */
+static NavFile MakeTestNavFile(const size_t& areaCount, const std::function<void(NavArea&, const size_t&)>& fill = {}, const std::optional<unsigned int>& minorVersion = 2u, const std::filesystem::path& path = {}) {
+	NavFile file(path);
+	file.GetMagicNumber() = 0xFEEDFACE;
+	file.GetMajorVersion() = LATEST_NAV_MAJOR_VERSION;
+	file.GetMinorVersion() = minorVersion;
+	file.GetAreaCount() = areaCount;
+	file.areas = std::vector<NavArea>(areaCount);
+	for (size_t i = 0; i < areaCount; i++)
+	{
+		NavArea& area = file.areas.value().at(i);
+		area.ID = i + 1u;
+		area.visAreaCount = 0u;
+		area.customDataSize = getCustomDataSize(file.GetMajorVersion(), file.GetMinorVersion());
+		area.customData.resize(area.customDataSize);
+		if (fill) fill(area, i);
+	}
+	return file;
+}
+
 // Tests the reading and writing of connection data. The data size *should always* be 5 bytes, and the connections should give the same data
 // True on success, false on failure.
 std::pair<bool, std::string > TestNavConnectionDataIO() {
@@ -129,4 +166,986 @@ std::pair<bool, std::string > TestNAVFileIO() {
 		}
 	}
 	return {true, "NAV File I/O: Passed!"};
-}
\ No newline at end of file
+}
+
+// Tests that decoding NAV data from memory matches decoding it from a stream.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavBufferIO() {
+	NavFile init = MakeTestNavFile(3u, [](NavArea& area, const size_t& i) {
+		area.Flags = 0b0110;
+		area.nwCorner = {1.0f * i, 2.0f, 3.0f};
+		area.seCorner = {4.0f, 5.0f * i, 6.0f};
+		area.connectionData[(unsigned char)Direction::East].first = 1u;
+		area.connectionData[(unsigned char)Direction::East].second.emplace_back().TargetAreaID = (i + 1u) % 3u + 1u;
+		area.visAreaCount = 1u;
+		area.visAreas.emplace(1u);
+		area.visAreas.value().front().VisibleAreaID = 2u;
+		area.customData.assign(area.customDataSize, 0x7f);
+	});
+	std::stringstream TestFile;
+	if (!init.WriteData(*TestFile.rdbuf())) return {false, "NAV Buffer I/O: Write Failed!"};
+	const std::string data = TestFile.str();
+
+	NavFile streamSample, bufferSample;
+	if (!streamSample.ReadData(*TestFile.rdbuf())) return {false, "NAV Buffer I/O: Stream Read Failed!"};
+	NavBufferReader reader(std::as_bytes(std::span(data)));
+	if (!bufferSample.ReadData(reader)) return {false, "NAV Buffer I/O: Buffer Read Failed!"};
+	if (reader.Remaining() != 0u) return {false, "NAV Buffer I/O: Failed! (Reason: "+std::to_string(reader.Remaining())+" unread bytes!)"};
+	// Both samples should write back the exact same data.
+	std::stringstream streamOut, bufferOut;
+	if (!streamSample.WriteData(*streamOut.rdbuf()) || !bufferSample.WriteData(*bufferOut.rdbuf())) return {false, "NAV Buffer I/O: Rewrite Failed!"};
+	if (streamOut.str() != data || bufferOut.str() != data) return {false, "NAV Buffer I/O: Failed! Mismatching area data!"};
+	return {true, "NAV Buffer I/O: Passed!"};
+}
+
+// Tests that decoding and encoding areas on several threads matches doing it serially.
+// True on success, false on failure.
+std::pair<bool, std::string > TestParallelAreaDecode() {
+	const size_t areaCount = NAV_PARALLEL_MIN_AREAS * 4u + 3u;
+	NavFile init = MakeTestNavFile(areaCount, [&areaCount](NavArea& area, const size_t& i) {
+		area.nwCorner = {1.0f * i, 2.0f, 3.0f};
+		// Vary the area lengths.
+		area.hideSpotData.first = i % 3u;
+		area.hideSpotData.second.resize(area.hideSpotData.first);
+		area.connectionData[(unsigned char)Direction::North].first = i % 5u;
+		for (size_t c = 0; c < i % 5u; c++) area.connectionData[(unsigned char)Direction::North].second.emplace_back().TargetAreaID = (i + c) % areaCount + 1u;
+		area.customData.assign(area.customDataSize, 0x7f);
+	});
+	std::stringstream TestFile;
+	if (!init.WriteData(*TestFile.rdbuf())) return {false, "Parallel Area Decode: Write Failed!"};
+	const std::string data = TestFile.str();
+
+	NavFile serialSample, parallelSample;
+	serialSample.SetThreadCount(1u);
+	parallelSample.SetThreadCount(4u);
+	NavBufferReader serialReader(std::as_bytes(std::span(data))), parallelReader(std::as_bytes(std::span(data)));
+	if (!serialSample.ReadData(serialReader) || !parallelSample.ReadData(parallelReader)) return {false, "Parallel Area Decode: Read Failed!"};
+	if (parallelReader.Remaining() != 0u) return {false, "Parallel Area Decode: Failed! (Reason: "+std::to_string(parallelReader.Remaining())+" unread bytes!)"};
+	std::stringstream serialOut, parallelOut;
+	if (!serialSample.WriteData(*serialOut.rdbuf()) || !parallelSample.WriteData(*parallelOut.rdbuf())) return {false, "Parallel Area Decode: Rewrite Failed!"};
+	if (serialOut.str() != data || parallelOut.str() != data) return {false, "Parallel Area Decode: Failed! Mismatching area data!"};
+	// Encoding on several threads should give the same data too.
+	std::string serialData, parallelData;
+	if (!serialSample.SerializeData(serialData) || !parallelSample.SerializeData(parallelData)) return {false, "Parallel Area Decode: Serialize Failed!"};
+	if (serialData != data || parallelData != data) return {false, "Parallel Area Decode: Failed! Mismatching serialized data!"};
+	if (parallelSample.FindAreaIndex(init.GetAreaCount()) != init.GetAreaCount() - 1u) return {false, "Parallel Area Decode: Failed! Bad area index!"};
+	return {true, "Parallel Area Decode: Passed!"};
+}
+
+// Tests that streaming areas gives the same areas as reading the whole file.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaStream() {
+	NavFile init = MakeTestNavFile(4u, [](NavArea& area, const size_t& i) {
+		area.hideSpotData.first = i;
+		area.hideSpotData.second.resize(i);
+	});
+	std::stringstream TestFile;
+	if (!init.WriteData(*TestFile.rdbuf())) return {false, "NAV Area Stream: Write Failed!"};
+
+	NavFile sample;
+	if (!sample.ReadHeader(*TestFile.rdbuf())) return {false, "NAV Area Stream: Header Read Failed!"};
+	NavAreaStream areaStream(*TestFile.rdbuf(), sample.GetMajorVersion(), sample.GetMinorVersion(), sample.GetAreaCount());
+	NavArea area;
+	std::stringstream areaOut;
+	while (areaStream.Next(area))
+	{
+		if (!area.WriteData(*areaOut.rdbuf(), sample.GetMajorVersion(), sample.GetMinorVersion())) return {false, "NAV Area Stream: Rewrite Failed!"};
+	}
+	if (areaStream.Failed() || areaStream.GetIndex() != init.GetAreaCount()) return {false, "NAV Area Stream: Read Failed!"};
+	// The streamed areas should write back the same area data.
+	std::stringstream initOut;
+	for (NavArea& initArea : init.areas.value()) initArea.WriteData(*initOut.rdbuf(), init.GetMajorVersion(), init.GetMinorVersion());
+	if (areaOut.str() != initOut.str()) return {false, "NAV Area Stream: Failed! Mismatching area data!"};
+	return {true, "NAV Area Stream: Passed!"};
+}
+
+// Tests patching fixed-width area fields in place.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaPatch() {
+	const std::filesystem::path TestPath = std::filesystem::temp_directory_path() / "nav_patch_test.nav";
+	NavFile init = MakeTestNavFile(3u, {}, 2u, TestPath);
+	{
+		std::filebuf outBuf;
+		if (!outBuf.open(TestPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary) || !init.WriteData(outBuf)) return {false, "NAV Area Patch: Write Failed!"};
+	}
+	NavFile sample(TestPath);
+	if (!sample.ReadFile()) return {false, "NAV Area Patch: Read Failed!"};
+	std::optional<NavAreaLocation> location = sample.FindAreaLocation(2u);
+	if (!location.has_value()) return {false, "NAV Area Patch: Failed! Area not indexed!"};
+	// Same size edit.
+	sample.areas.value().at(location.value().Index).Flags = 0xABCDu;
+	sample.areas.value().at(location.value().Index).PlaceID = 7u;
+	if (!sample.PatchAreaData(location.value())) return {false, "NAV Area Patch: Patch Failed!"};
+	// Size changing edit.
+	sample.areas.value().at(location.value().Index).hideSpotData.first = 1u;
+	sample.areas.value().at(location.value().Index).GetHideSpotData().second.resize(1u);
+	if (sample.PatchAreaData(location.value())) return {false, "NAV Area Patch: Failed! Patched an area that changed size!"};
+
+	NavFile patched(TestPath);
+	if (!patched.ReadFile()) return {false, "NAV Area Patch: Reread Failed!"};
+	const NavArea& area = patched.areas.value().at(1u);
+	if (area.Flags != 0xABCDu || area.PlaceID != 7u || area.hideSpotData.first != 0u) return {false, "NAV Area Patch: Failed! Mismatching area data!"};
+	// The file is replaced on disk after it was read, so the area is somewhere else now.
+	location = patched.FindAreaLocation(2u);
+	if (!location.has_value()) return {false, "NAV Area Patch: Failed! Area not indexed!"};
+	std::string replaced;
+	if (!MakeTestNavFile(5u).SerializeData(replaced)) return {false, "NAV Area Patch: Write Failed!"};
+	{
+		std::ofstream outFile(TestPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+		outFile << replaced;
+	}
+	patched.areas.value().at(location.value().Index).Flags = 0x1234u;
+	if (patched.PatchAreaData(location.value())) return {false, "NAV Area Patch: Failed! Patched a file that changed on disk!"};
+	std::ifstream replacedFile(TestPath, std::ios_base::in | std::ios_base::binary);
+	std::stringstream onDisk;
+	onDisk << replacedFile.rdbuf();
+	std::filesystem::remove(TestPath);
+	if (onDisk.str() != replaced) return {false, "NAV Area Patch: Failed! File that changed on disk was written to!"};
+	return {true, "NAV Area Patch: Passed!"};
+}
+
+// Tests that saving replaces the whole file.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavFileSave() {
+	const std::filesystem::path TestPath = std::filesystem::temp_directory_path() / "nav_save_test.nav";
+	// Start with a larger file, so leftover bytes would show.
+	{
+		std::ofstream oldFile(TestPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+		oldFile << std::string(4096u, '\x7f');
+	}
+	NavFile init = MakeTestNavFile(2u, {}, 2u, TestPath);
+	if (!init.SaveFile(true)) return {false, "NAV File Save: Save Failed!"};
+	std::stringstream expected;
+	if (!init.WriteData(*expected.rdbuf())) return {false, "NAV File Save: Write Failed!"};
+	std::ifstream savedFile(TestPath, std::ios_base::in | std::ios_base::binary);
+	std::stringstream saved;
+	saved << savedFile.rdbuf();
+	std::filesystem::remove(TestPath);
+	if (saved.str() != expected.str()) return {false, "NAV File Save: Failed! Saved file does not match NAV data!"};
+	return {true, "NAV File Save: Passed!"};
+}
+
+// Tests that incremental saves copy clean areas and encode dirty ones correctly.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavIncrementalSave() {
+	const std::filesystem::path TestPath = std::filesystem::temp_directory_path() / "nav_incremental_test.nav";
+	NavFile init = MakeTestNavFile(8u, [](NavArea& area, const size_t& i) {
+		area.hideSpotData.first = i % 3u;
+		area.hideSpotData.second.resize(area.hideSpotData.first);
+	}, 2u, TestPath);
+	if (!init.SaveFile(true)) return {false, "NAV Incremental Save: Save Failed!"};
+
+	NavFile edited(TestPath);
+	if (!edited.ReadFile()) return {false, "NAV Incremental Save: Read Failed!"};
+	// Grow one area, remove another and add a new one in front.
+	NavArea& grown = edited.areas.value().at(2);
+	grown.GetHideSpotData().second.emplace_back();
+	grown.hideSpotData.first++;
+	grown.MarkDirty();
+	edited.areas.value().erase(edited.areas.value().begin() + 5);
+	NavArea& added = *edited.areas.value().emplace(edited.areas.value().begin());
+	added.ID = 9u;
+	added.visAreaCount = 0u;
+	added.customDataSize = getCustomDataSize(edited.GetMajorVersion(), edited.GetMinorVersion());
+	added.customData.resize(added.customDataSize);
+	// Save twice, so the second save copies from the first.
+	for (unsigned char pass = 0u; pass < 2u; pass++)
+	{
+		if (pass == 1u) {
+			edited.areas.value().at(4).GetHideSpotData().second.clear();
+			edited.areas.value().at(4).hideSpotData.first = 0u;
+			edited.areas.value().at(4).MarkDirty();
+		}
+		if (!edited.SaveFile(true, true)) return {false, "NAV Incremental Save: Incremental Save Failed!"};
+		std::stringstream expected;
+		if (!edited.WriteData(*expected.rdbuf())) return {false, "NAV Incremental Save: Write Failed!"};
+		std::ifstream savedFile(TestPath, std::ios_base::in | std::ios_base::binary);
+		std::stringstream saved;
+		saved << savedFile.rdbuf();
+		if (saved.str() != expected.str()) {
+			std::filesystem::remove(TestPath);
+			return {false, "NAV Incremental Save: Failed! Saved file does not match NAV data!"};
+		}
+	}
+	std::filesystem::remove(TestPath);
+	return {true, "NAV Incremental Save: Passed!"};
+}
+
+// Tests that reading only the header gets the same counts as a full read, with the ladder count known only through the sidecar index.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavFileHeader() {
+	const std::filesystem::path TestPath = std::filesystem::temp_directory_path() / "nav_header_test.nav";
+	const unsigned int TestLadderCount = 2u;
+	std::filesystem::remove(NavIndexFile::GetIndexPath(TestPath));
+	{
+		NavFile init = MakeTestNavFile(5u, [](NavArea& area, const size_t& i) {
+			area.hideSpotData.first = i;
+			area.hideSpotData.second.resize(area.hideSpotData.first);
+		}, 2u, TestPath);
+		std::stringstream initData;
+		if (!init.WriteData(*initData.rdbuf())) return {false, "NAV File Header: Write Failed!"};
+		// Replace the (empty) ladder section with blank ladders.
+		std::string data = initData.str();
+		data.resize(data.size() - VALVE_INT_SIZE);
+		data.append(reinterpret_cast<const char*>(&TestLadderCount), VALVE_INT_SIZE);
+		data.append(TestLadderCount * LADDER_SIZE, '\0');
+		std::ofstream outFile(TestPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+		outFile << data;
+	}
+	NavFile full(TestPath);
+	if (!full.ReadFile()) return {false, "NAV File Header: Read Failed!"};
+	for (unsigned char pass = 0u; pass < 2u; pass++)
+	{
+		// Second pass goes through the index.
+		if (pass == 1u && !full.UpdateIndexFile()) return {false, "NAV File Header: Index Write Failed!"};
+		NavFile header(TestPath);
+		if (!header.ReadFileHeader(true) || header.areas.has_value()) return {false, "NAV File Header: Header Read Failed!"};
+		// Without the index, the ladder count is unknown rather than found by going through every area.
+		if (header.GetAreaCount() != full.GetAreaCount() || header.IsLadderCountKnown() != (pass == 1u)
+		|| (pass == 1u && (header.GetLadderCount() != TestLadderCount || header.GetLadderCount() != full.GetLadderCount() || header.GetLadderDataLoc() != full.GetLadderDataLoc()))) {
+			std::filesystem::remove(TestPath);
+			std::filesystem::remove(NavIndexFile::GetIndexPath(TestPath));
+			return {false, "NAV File Header: Failed! Header counts do not match full read!"};
+		}
+	}
+	std::filesystem::remove(TestPath);
+	std::filesystem::remove(NavIndexFile::GetIndexPath(TestPath));
+	return {true, "NAV File Header: Passed!"};
+}
+
+// Tests that heavy area sections are decoded on first access, and written back unchanged until then.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaLazySections() {
+	// Approach spots only exist before version 15, visible areas from version 16.
+	for (const unsigned int MajorVersion : {14u, static_cast<unsigned int>(LATEST_NAV_MAJOR_VERSION)})
+	{
+		const std::optional<unsigned int> MinorVersion = 2u;
+		NavArea area;
+		area.ID = 1u;
+		area.Flags = 0u;
+		area.nwCorner = {0.0f, 0.0f, 0.0f};
+		area.seCorner = {1.0f, 1.0f, 0.0f};
+		area.hideSpotData.first = 2u;
+		area.hideSpotData.second.resize(2u);
+		area.hideSpotData.second.back().ID = 7u;
+		if (MajorVersion < 15) {
+			area.approachSpotCount = 1u;
+			area.approachSpotData.emplace(1u);
+			area.approachSpotData.value().front().approachHereId = 3u;
+		}
+		area.encounterPathCount = 2u;
+		area.encounterPaths.emplace(2u);
+		area.encounterPaths.value().back().ToAreaID = 5u;
+		area.encounterPaths.value().back().spotCount = 1u;
+		area.encounterPaths.value().back().spotContainer.emplace_back().OrderID = 9u;
+		area.visAreaCount = 1u;
+		area.visAreas.emplace(1u);
+		area.visAreas.value().front().VisibleAreaID = 4u;
+		area.customDataSize = getCustomDataSize(MajorVersion, MinorVersion);
+		area.customData.resize(area.customDataSize);
+		std::stringstream areaBuf;
+		if (!area.WriteData(*areaBuf.rdbuf(), MajorVersion, MinorVersion)) return {false, "NAV Area Lazy Sections: Write Failed!"};
+		const std::string data = areaBuf.str();
+
+		NavArea sample;
+		NavBufferReader reader(std::as_bytes(std::span(data)));
+		if (!sample.ReadData(reader, MajorVersion, MinorVersion) || reader.Remaining() != 0u) return {false, "NAV Area Lazy Sections: Read Failed!"};
+		// Nothing is decoded yet, but the counts are.
+		if (!sample.hideSpotData.second.empty() || sample.encounterPaths.has_value() || sample.hideSpotData.first != 2u || sample.encounterPathCount != 2u)
+			return {false, "NAV Area Lazy Sections: Failed! Sections were decoded early!"};
+		// Undecoded sections are written back as they were.
+		std::stringstream lazyOut;
+		if (!sample.WriteData(*lazyOut.rdbuf(), MajorVersion, MinorVersion) || lazyOut.str() != data || sample.GetDataSize(MajorVersion, MinorVersion) != data.size())
+			return {false, "NAV Area Lazy Sections: Failed! Undecoded area does not write back the same data!"};
+		// First access decodes.
+		if (sample.GetHideSpotData().second.size() != 2u || sample.GetHideSpotData().second.back().ID != 7u
+		|| !sample.GetEncounterPaths().has_value() || sample.GetEncounterPaths().value().size() != 2u || sample.GetEncounterPaths().value().back().spotContainer.front().OrderID != 9u)
+			return {false, "NAV Area Lazy Sections: Failed! Mismatching section data!"};
+		if (MajorVersion < 15 && (!sample.GetApproachSpotData().has_value() || sample.GetApproachSpotData().value().front().approachHereId != 3u))
+			return {false, "NAV Area Lazy Sections: Failed! Mismatching approach spot data!"};
+		if (MajorVersion >= 16 && (!sample.GetVisAreas().has_value() || sample.GetVisAreas().value().front().VisibleAreaID != 4u))
+			return {false, "NAV Area Lazy Sections: Failed! Mismatching visible area data!"};
+		std::stringstream decodedOut;
+		if (!sample.DecodeSections() || !sample.WriteData(*decodedOut.rdbuf(), MajorVersion, MinorVersion) || decodedOut.str() != data)
+			return {false, "NAV Area Lazy Sections: Failed! Decoded area does not write back the same data!"};
+	}
+	return {true, "NAV Area Lazy Sections: Passed!"};
+}
+
+// Tests that reading, writing, skipping and sizing area data agree on the layout of every version.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaSchema() {
+	NavArea area;
+	area.ID = 3u;
+	area.Flags = 0x1234u;
+	area.nwCorner = {1.0f, 2.0f, 3.0f};
+	area.seCorner = {4.0f, 5.0f, 6.0f};
+	area.connectionData[1].first = 2u;
+	area.connectionData[1].second.resize(2u);
+	area.hideSpotData.first = 1u;
+	area.hideSpotData.second.resize(1u);
+	area.approachSpotCount = 1u;
+	area.encounterPathCount = 1u;
+	area.encounterPaths.emplace(1u);
+	area.encounterPaths.value().front().spotCount = 2u;
+	area.ladderData[0].first = 1u;
+	area.ladderData[0].second.push_back(8u);
+	area.visAreaCount = 2u;
+	area.InheritVisibilityFromAreaID = 6u;
+	for (unsigned int MajorVersion = 1u; MajorVersion <= LATEST_NAV_MAJOR_VERSION; MajorVersion++)
+	{
+		const std::string version = " (MajorVersion="+std::to_string(MajorVersion)+")";
+		const std::optional<unsigned int> MinorVersion = 2u;
+		area.customDataSize = getCustomDataSize(MajorVersion, MinorVersion);
+		area.customData.assign(area.customDataSize, 0x7Fu);
+		std::stringstream areaBuf;
+		if (!area.WriteData(*areaBuf.rdbuf(), MajorVersion, MinorVersion)) return {false, "NAV Area Schema: Write Failed!"+version};
+		const std::string data = areaBuf.str();
+		if (area.GetDataSize(MajorVersion, MinorVersion) != data.size()) return {false, "NAV Area Schema: Failed! Size does not match written data!"+version};
+		// Skipping and reading use up exactly the written data.
+		NavBufferReader skipReader(std::as_bytes(std::span(data)));
+		std::stringbuf skipBuf(data);
+		if (NavArea::SkipData(skipReader, MajorVersion, MinorVersion) != data.size() || NavArea::SkipData(skipBuf, MajorVersion, MinorVersion) != data.size())
+			return {false, "NAV Area Schema: Failed! Skipped size does not match written data!"+version};
+		NavArea fromMemory, fromStream;
+		NavBufferReader reader(std::as_bytes(std::span(data)));
+		std::stringbuf streamBuf(data);
+		if (!fromMemory.ReadData(reader, MajorVersion, MinorVersion) || reader.Remaining() != 0u || fromMemory.size != data.size()
+		|| !fromStream.ReadData(streamBuf, MajorVersion, MinorVersion) || fromStream.size != data.size())
+			return {false, "NAV Area Schema: Read Failed!"+version};
+		std::stringstream memoryOut, streamOut;
+		if (!fromMemory.WriteData(*memoryOut.rdbuf(), MajorVersion, MinorVersion) || memoryOut.str() != data
+		|| !fromStream.WriteData(*streamOut.rdbuf(), MajorVersion, MinorVersion) || streamOut.str() != data)
+			return {false, "NAV Area Schema: Failed! Read area does not write back the same data!"+version};
+		if (fromStream.Flags != (MajorVersion < 8 ? 0x34u : 0x1234u) || fromStream.InheritVisibilityFromAreaID != (MajorVersion >= 16 ? 6u : 0u))
+			return {false, "NAV Area Schema: Failed! Mismatching field data!"+version};
+	}
+	return {true, "NAV Area Schema: Passed!"};
+}
+
+// Tests building, querying and writing back a columnar area table.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaTable() {
+	std::vector<NavArea> areas(4u);
+	for (size_t i = 0; i < areas.size(); i++)
+	{
+		NavArea& area = areas.at(i);
+		area.ID = i + 1u;
+		area.Flags = 0u;
+		area.nwCorner = {100.0f * i, 0.0f, 0.0f};
+		area.seCorner = {100.0f * i + 50.0f, 50.0f, 0.0f};
+		area.NorthEastZ = 0.0f;
+		area.SouthWestZ = 10.0f * i;
+		area.connectionData[(unsigned char)Direction::East].first = 1u;
+		area.connectionData[(unsigned char)Direction::East].second.emplace_back().TargetAreaID = (i + 1u) % areas.size() + 1u;
+		area.SourceOffset = 0u;
+	}
+	NavAreaTable table;
+	table.Build(areas);
+	if (table.size() != areas.size() || table.GetConnections(2u, Direction::East).size() != 1u || table.GetConnections(2u, Direction::East).front() != 4u
+	|| !table.GetConnections(2u, Direction::North).empty())
+		return {false, "NAV Area Table: Failed! Mismatching table data!"};
+	std::optional<NavBounds> bounds = table.GetBounds();
+	if (!bounds.has_value() || bounds.value().Min[0] != 0.0f || bounds.value().Max[0] != 350.0f || bounds.value().Max[2] != 30.0f)
+		return {false, "NAV Area Table: Failed! Wrong bounds!"};
+	// Only the middle two areas reach into X 120 to 220.
+	NavBounds filter;
+	filter.Min = {120.0f, 0.0f, 0.0f};
+	filter.Max = {220.0f, 50.0f, 50.0f};
+	if (table.FindInBounds(filter) != std::vector<size_t>{1u, 2u}) return {false, "NAV Area Table: Failed! Wrong areas in bounds!"};
+	NavAreaStats stats = table.GetStats();
+	if (stats.AreaCount != 4u || stats.ConnectionCount != 4u || stats.TotalSize != 4 * 50.0 * 50.0) return {false, "NAV Area Table: Failed! Wrong stats!"};
+	// Move only the last area back, so it is the only one that changes.
+	table.nwCorner[0].back() -= 10.0f;
+	table.seCorner[0].back() -= 10.0f;
+	if (!table.Apply(areas)) return {false, "NAV Area Table: Apply Failed!"};
+	if (areas.back().nwCorner[0] != 290.0f || !areas.back().IsDirty() || areas.front().IsDirty()) return {false, "NAV Area Table: Failed! Changes were not written back!"};
+	table.Translate({1.0f, 2.0f, 3.0f});
+	if (table.nwCorner[1].front() != 2.0f || table.SouthWestZ.back() != 33.0f) return {false, "NAV Area Table: Failed! Wrong translation!"};
+	return {true, "NAV Area Table: Passed!"};
+}
+
+// Tests that read areas allocate from their file's arena, and that copies of them don't.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavFileArena() {
+	NavFile init = MakeTestNavFile(3u, [](NavArea& area, const size_t&) {
+		area.hideSpotData.first = 1u;
+		area.hideSpotData.second.resize(1u);
+	});
+	std::stringstream TestFile;
+	if (!init.WriteData(*TestFile.rdbuf())) return {false, "NAV File Arena: Write Failed!"};
+	const std::string data = TestFile.str();
+
+	NavFile sample;
+	{
+		NavBufferReader reader(std::as_bytes(std::span(data)));
+		if (!sample.ReadData(reader)) return {false, "NAV File Arena: Read Failed!"};
+	}
+	if (sample.areas.value().front().GetMemoryResource() == std::pmr::get_default_resource()) return {false, "NAV File Arena: Failed! Areas don't use an arena!"};
+	// Copies allocate normally, so they can outlive the file.
+	NavArea copy = sample.areas.value().front();
+	if (copy.GetMemoryResource() != std::pmr::get_default_resource()) return {false, "NAV File Arena: Failed! Copied area still uses the arena!"};
+	// Assigning over the file, then reading again, must not touch released arenas.
+	sample = init;
+	{
+		NavBufferReader reader(std::as_bytes(std::span(data)));
+		if (!sample.ReadData(reader)) return {false, "NAV File Arena: Reread Failed!"};
+	}
+	sample.areas.value().back().GetHideSpotData().second.emplace_back();
+	sample.areas.value().back().hideSpotData.first++;
+	std::stringstream expected, rewritten;
+	copy.WriteData(*expected.rdbuf(), sample.GetMajorVersion(), sample.GetMinorVersion());
+	sample.areas.value().front().WriteData(*rewritten.rdbuf(), sample.GetMajorVersion(), sample.GetMinorVersion());
+	if (expected.str() != rewritten.str()) return {false, "NAV File Arena: Failed! Mismatching area data!"};
+	return {true, "NAV File Arena: Passed!"};
+}
+
+// Tests building an adjacency graph from connections and ladders.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavGraph() {
+	std::vector<NavArea> areas(3u);
+	for (size_t i = 0; i < areas.size(); i++)
+	{
+		areas.at(i).ID = (i + 1u) * 10u;
+		areas.at(i).nwCorner = {100.0f * i, 0.0f, 0.0f};
+		areas.at(i).seCorner = {100.0f * i, 0.0f, 0.0f};
+	}
+	// #10 <-> #20, and #20 -> #99, which doesn't exist.
+	areas.at(0).connectionData[(unsigned char)Direction::East].second.emplace_back().TargetAreaID = 20u;
+	areas.at(1).connectionData[(unsigned char)Direction::West].second.emplace_back().TargetAreaID = 10u;
+	areas.at(1).connectionData[(unsigned char)Direction::North].second.emplace_back().TargetAreaID = 99u;
+	// Ladder from #30 up to #10.
+	std::deque<NavLadder> ladders(1u);
+	ladders.front() = NavLadder();
+	ladders.front().BottomAreaID = 30u;
+	ladders.front().TopForwardAreaID = 10u;
+
+	NavGraph graph;
+	if (!graph.Build(areas, ladders, true)) return {false, "NAV Graph: Build Failed!"};
+	if (graph.GetAreaCount() != 3u || graph.GetEdgeCount() != 4u || graph.danglingEdgeCount != 1u) return {false, "NAV Graph: Failed! Wrong edge count!"};
+	if (graph.FindIndex(20u) != 1u || graph.FindIndex(99u).has_value()) return {false, "NAV Graph: Failed! Wrong area index!"};
+	std::span<const unsigned int> outgoing = graph.GetOutgoing(0u);
+	if (outgoing.size() != 2u || outgoing[0] != 1u || outgoing[1] != 2u
+	|| graph.edgeTypes[graph.edgeOffsets[0]] != NavEdgeType::East || graph.edgeTypes[graph.edgeOffsets[0] + 1u] != NavEdgeType::LadderDown)
+		return {false, "NAV Graph: Failed! Wrong outgoing edges!"};
+	std::span<const unsigned int> incoming = graph.GetIncoming(0u);
+	if (incoming.size() != 2u || std::count(incoming.begin(), incoming.end(), 1u) != 1u || std::count(incoming.begin(), incoming.end(), 2u) != 1u)
+		return {false, "NAV Graph: Failed! Wrong incoming edges!"};
+	if (graph.edgeCosts.size() != graph.GetEdgeCount() || graph.edgeCosts[graph.edgeOffsets[0]] != 100.0f) return {false, "NAV Graph: Failed! Wrong edge costs!"};
+	return {true, "NAV Graph: Passed!"};
+}
+
+// Tests the ID index with dense and sparse IDs, and NavFile lookups across inserting and erasing areas.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavIDMap() {
+	// Dense IDs go in a direct table, sparse IDs in a hash table. Both should behave the same.
+	for (const IntID stride : {1u, 100003u})
+	{
+		std::vector<IntID> IDs(1000u);
+		for (size_t i = 0; i < IDs.size(); i++) IDs.at(i) = (i + 1u) * stride;
+		NavIDMap map;
+		map.Build(IDs, [](const IntID& ID) { return ID; });
+		if (map.size() != IDs.size() || map.Find(IDs.at(500)) != 500u || map.Find(stride * 5000u).has_value()) return {false, "NAV ID Map: Failed! Wrong index!"};
+		// Erase every other ID.
+		for (size_t i = 0; i < IDs.size(); i += 2u) map.Erase(IDs.at(i));
+		for (size_t i = 0; i < IDs.size(); i++) if (map.Find(IDs.at(i)).has_value() != (i % 2u == 1u)) return {false, "NAV ID Map: Failed! Erase failed!"};
+		map.Shift(500u, -1);
+		if (map.Find(IDs.at(501)) != 500u || map.Find(IDs.at(499)) != 499u) return {false, "NAV ID Map: Failed! Shift failed!"};
+		if (!map.Insert(IDs.at(0), 0u) || map.Insert(IDs.at(1), 0u) || map.Find(IDs.at(0)) != 0u) return {false, "NAV ID Map: Failed! Insert failed!"};
+	}
+
+	NavFile file;
+	file.areas = std::vector<NavArea>(3u);
+	file.GetAreaCount() = 3u;
+	for (size_t i = 0; i < file.areas.value().size(); i++) file.areas.value().at(i).ID = i + 1u;
+	file.areas.value().at(1).GetHideSpotData().second.emplace_back().ID = 7u;
+	file.areas.value().at(1).hideSpotData.first = 1u;
+	file.ladders.resize(2u);
+	file.ladders.at(0).ID = 4u;
+	file.ladders.at(1).ID = 9u;
+	file.IndexAreas();
+	// Insert #4 before #2.
+	{
+		NavArea area;
+		area.ID = file.GetNextAreaID();
+		file.InsertArea(file.areas.value().begin() + 1, std::move(area));
+	}
+	if (file.GetAreaCount() != 4u || file.FindAreaIndex(4u) != 1u || file.FindAreaIndex(2u) != 2u || file.FindHideSpot(7u) != std::make_pair(size_t(2u), size_t(0u)))
+		return {false, "NAV ID Map: Failed! Wrong index after insert!"};
+	// Erase #1.
+	file.EraseArea(file.areas.value().begin());
+	if (file.GetAreaCount() != 3u || file.FindAreaIndex(1u).has_value() || file.FindAreaIndex(3u) != 2u || file.FindHideSpot(7u) != std::make_pair(size_t(1u), size_t(0u)))
+		return {false, "NAV ID Map: Failed! Wrong index after erase!"};
+	if (file.FindLadderIndex(9u) != 1u || file.FindLadderIndex(5u).has_value()) return {false, "NAV ID Map: Failed! Wrong ladder index!"};
+	// Areas read into an arena are moved, not copied, when inserting grows their container.
+	std::string data;
+	if (!MakeTestNavFile(3u, [](NavArea& area, const size_t&) {
+		area.connectionData[0].first = 1u;
+		area.connectionData[0].second.emplace_back().TargetAreaID = 1u;
+	}).SerializeData(data)) return {false, "NAV ID Map: Write Failed!"};
+	NavFile read;
+	NavBufferReader reader(std::as_bytes(std::span(data)));
+	if (!read.ReadData(reader)) return {false, "NAV ID Map: Read Failed!"};
+	const NavConnection* connections = read.areas.value().back().connectionData[0].second.data();
+	std::pmr::memory_resource* resource = read.areas.value().back().GetMemoryResource();
+	read.InsertArea(read.areas.value().begin(), NavArea());
+	if (read.areas.value().capacity() <= 3u || read.areas.value().back().connectionData[0].second.data() != connections || read.areas.value().back().GetMemoryResource() != resource)
+		return {false, "NAV ID Map: Failed! Areas were copied on insert!"};
+	return {true, "NAV ID Map: Passed!"};
+}
+
+// Tests serving commands on a loaded file, directly and over a socket, and saving only when asked to.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavServer() {
+	const std::filesystem::path TestPath = std::filesystem::temp_directory_path() / "nav_server_test.nav";
+	const std::filesystem::path SocketPath = std::filesystem::temp_directory_path() / "nav_server_test.sock";
+	{
+		NavFile init = MakeTestNavFile(4u, [](NavArea& area, const size_t& i) {
+			if (i != 1u) return;
+			area.hideSpotData.first = 1u;
+			area.hideSpotData.second.resize(1u);
+		}, 2u, TestPath);
+		if (!init.SaveFile()) return {false, "NAV Server: Save Failed!"};
+	}
+	NavServer server{toml::parse_result()};
+	const std::string fileArg = "file " + TestPath.string();
+	std::ostringstream out;
+	if (!server.HandleRequest(fileArg + " info", out) || out.str().find(TestPath.string()) == std::string::npos || out.str().find("feedface") == std::string::npos) return {false, "NAV Server: Failed! File info failed!"};
+	if (!server.HandleRequest(fileArg + " area #2 info", out) || out.str().find("Area #2") == std::string::npos) return {false, "NAV Server: Failed! Info failed!"};
+	// A failed edit changes nothing, so the file can still be closed.
+	if (server.HandleRequest(fileArg + " area #9 delete", out) || !server.HandleRequest("close " + TestPath.string(), out)) return {false, "NAV Server: Failed! Failed edit changed the file!"};
+	if (!server.HandleRequest(fileArg + " area #3 delete", out) || server.HandleRequest(fileArg + " area #3 info", out)) return {false, "NAV Server: Failed! Delete failed!"};
+	// Nothing is written until saved.
+	{
+		NavFile onDisk(TestPath);
+		if (!onDisk.ReadFileHeader(false) || onDisk.GetAreaCount() != 4u) return {false, "NAV Server: Failed! Saved without being asked to!"};
+	}
+	// Unsaved changes aren't dropped by closing.
+	if (server.HandleRequest("close " + TestPath.string(), out) || server.HandleRequest(fileArg + " area #3 info", out)) return {false, "NAV Server: Failed! Closed a changed file!"};
+	// Hide spots past the last one can't be deleted.
+	if (server.HandleRequest(fileArg + " area #2 hide-spot 1 delete", out) || !server.HandleRequest(fileArg + " area #2 hide-spot 0 delete", out)) return {false, "NAV Server: Failed! Hide spot delete failed!"};
+	// Save and stop through the socket.
+	if (!server.Listen(SocketPath)) return {false, "NAV Server: Listen Failed!"};
+	std::thread serving(&NavServer::Run, &server);
+	std::string response;
+	{
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		SocketPath.string().copy(address.sun_path, sizeof(address.sun_path) - 1u);
+		const std::string requests = "save " + TestPath.string() + "\nclose " + TestPath.string() + "\nshutdown\n";
+		if (fd != -1 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 && send(fd, requests.data(), requests.size(), 0) == static_cast<ssize_t>(requests.size())) {
+			// The server disconnects once it stops.
+			char buffer[256];
+			for (ssize_t count; (count = recv(fd, buffer, sizeof(buffer), 0)) > 0;) response.append(buffer, count);
+		}
+		else server.Stop();
+		if (fd != -1) close(fd);
+	}
+	serving.join();
+	if (response != NAV_SERVER_OK "\n" NAV_SERVER_OK "\n" NAV_SERVER_OK "\n") return {false, "NAV Server: Failed! Wrong response!"};
+	NavFile saved(TestPath);
+	if (!saved.ReadFile() || saved.GetAreaCount() != 3u || saved.FindAreaIndex(3u).has_value() || !saved.FindAreaIndex(4u).has_value() || saved.areas.value().at(1u).GetHideSpotData().first != 0u)
+		return {false, "NAV Server: Failed! Wrong saved data!"};
+	std::filesystem::remove(TestPath);
+	return {true, "NAV Server: Passed!"};
+}
+
+// Tests loading, querying, editing and writing a mesh through the C interface.
+// True on success, false on failure.
+std::pair<bool, std::string > TestLibNav() {
+	std::string data;
+	{
+		NavFile init = MakeTestNavFile(3u, [](NavArea& area, const size_t& i) {
+			// 100x100 squares in a row along x, each 10 higher than the last.
+			area.nwCorner = {100.0f * i, 0.0f, 10.0f * i};
+			area.seCorner = {100.0f * i + 100.0f, 100.0f, 10.0f * i};
+			area.NorthEastZ = area.SouthWestZ = 10.0f * i;
+		});
+		if (!init.SerializeData(data)) return {false, "libnav: Write Failed!"};
+	}
+	nav_file* file = nullptr;
+	if (nav_open_buffer(data.data(), data.size(), &file) != NAV_OK) return {false, "libnav: Open Failed!"};
+	std::unique_ptr<nav_file, void(*)(nav_file*)> owner(file, nav_close);
+	size_t index = 0u;
+	nav_area_info info;
+	if (nav_area_count(file) != 3u || nav_find_area(file, 2u, &index) != NAV_OK || index != 1u || nav_get_area(file, index, &info) != NAV_OK || info.nw_corner[0] != 100.0f)
+		return {false, "libnav: Failed! Wrong area!"};
+	// Big-endian and compressed buffers open like files do.
+	{
+		std::string big = data, compressed;
+		if (!NavFile::SwapByteOrder(std::as_writable_bytes(std::span(big)), false) || !CompressNavData(std::as_bytes(std::span(big)), NavCompression::GZIP, compressed))
+			return {false, "libnav: Swap Failed!"};
+		for (const std::string* buffer : {&big, &compressed})
+		{
+			nav_file* converted = nullptr;
+			if (nav_open_buffer(buffer->data(), buffer->size(), &converted) != NAV_OK) return {false, "libnav: Failed! Converted open failed!"};
+			std::unique_ptr<nav_file, void(*)(nav_file*)> convertedOwner(converted, nav_close);
+			nav_area_info convertedInfo;
+			if (nav_area_count(converted) != 3u || nav_get_area(converted, 1u, &convertedInfo) != NAV_OK || convertedInfo.nw_corner[0] != 100.0f)
+				return {false, "libnav: Failed! Wrong converted area!"};
+		}
+	}
+	const float min[3] = {150.0f, 50.0f, -1000.0f}, max[3] = {250.0f, 60.0f, 1000.0f}, position[3] = {250.0f, 50.0f, 0.0f};
+	size_t found[4];
+	if (nav_find_areas_in_bounds(file, min, max, found, 4u) != 2u || found[0] != 1u || found[1] != 2u) return {false, "libnav: Failed! Wrong areas in bounds!"};
+	if (nav_find_area_at(file, position, &index) != NAV_OK || index != 2u) return {false, "libnav: Failed! Wrong area at position!"};
+	// Edit.
+	info.id = 0u;
+	info.nw_corner[0] = 300.0f;
+	info.se_corner[0] = 400.0f;
+	if (nav_add_area(file, &info, &index) != NAV_OK || index != 3u || nav_add_connection(file, 0u, NAV_EAST, 4u) != NAV_OK || nav_remove_area(file, 1u) != NAV_OK)
+		return {false, "libnav: Failed! Edit failed!"};
+	void* encoded = nullptr;
+	size_t encodedSize = 0u;
+	if (nav_serialize(file, &encoded, &encodedSize) != NAV_OK) return {false, "libnav: Failed! Serialize failed!"};
+	nav_file* reloaded = nullptr;
+	const nav_result reloadResult = nav_open_buffer(encoded, encodedSize, &reloaded);
+	nav_free_buffer(encoded);
+	if (reloadResult != NAV_OK) return {false, "libnav: Failed! Reload failed!"};
+	std::unique_ptr<nav_file, void(*)(nav_file*)> reloadedOwner(reloaded, nav_close);
+	uint32_t connection = 0u;
+	if (nav_area_count(reloaded) != 3u || nav_find_area(reloaded, 2u, &index) != NAV_ERROR_NOT_FOUND || nav_find_area(reloaded, 4u, &index) != NAV_OK || index != 2u
+		|| nav_get_connections(reloaded, 0u, NAV_EAST, &connection, 1u) != 1u || connection != 4u)
+		return {false, "libnav: Failed! Wrong data after edit!"};
+	return {true, "libnav: Passed!"};
+}
+
+// Tests saving a gzip compressed file, and reading, streaming and editing it without decompressing it first.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavCompressedIO() {
+	const std::filesystem::path TestPath = std::filesystem::temp_directory_path() / "nav_compressed_test.nav";
+	NavFile init = MakeTestNavFile(6u, [](NavArea& area, const size_t& i) {
+		area.hideSpotData.first = i % 3u;
+		area.hideSpotData.second.resize(area.hideSpotData.first);
+	}, 2u, TestPath);
+	init.SetCompression(NavCompression::GZIP);
+	if (!init.SaveFile(true)) return {false, "NAV Compressed IO: Save Failed!"};
+	auto fail = [&TestPath](const std::string& message) -> std::pair<bool, std::string > {
+		std::filesystem::remove(TestPath);
+		return {false, "NAV Compressed IO: " + message};
+	};
+	// The file decompresses to the NAV data.
+	std::string saved;
+	{
+		std::ifstream savedFile(TestPath, std::ios_base::in | std::ios_base::binary);
+		std::stringstream savedData;
+		savedData << savedFile.rdbuf();
+		saved = savedData.str();
+	}
+	std::string expected;
+	if (!init.SerializeData(expected)) return fail("Write Failed!");
+	if (DetectNavCompression(std::as_bytes(std::span(saved))) != NavCompression::GZIP || saved.size() >= expected.size()) return fail("Failed! File is not compressed!");
+	{
+		int fd = open(TestPath.c_str(), O_RDONLY);
+		NavReadBuf decompressed(fd);
+		std::stringstream decompressedData;
+		decompressedData << &decompressed;
+		close(fd);
+		if (decompressed.Failed() || decompressed.GetCompression() != NavCompression::GZIP || decompressedData.str() != expected) return fail("Failed! File does not decompress to NAV data!");
+	}
+	// Read it, stream it and read its header.
+	NavFile edited(TestPath);
+	if (!edited.ReadFile() || edited.GetCompression() != NavCompression::GZIP || edited.GetAreaCount() != 6u || !edited.FindAreaIndex(6u).has_value()) return fail("Failed! Read wrong data!");
+	size_t streamed = 0u;
+	NavFile streamedFile(TestPath), header(TestPath);
+	if (!streamedFile.StreamFile([&streamed](NavArea& area, const size_t&) -> bool { return area.ID == ++streamed; }) || streamed != 6u) return fail("Failed! Streamed wrong data!");
+	// Compressed files aren't indexed, so the ladder count isn't known from the header.
+	if (!header.ReadFileHeader(true) || header.GetAreaCount() != 6u || header.IsLadderCountKnown()) return fail("Failed! Read wrong header!");
+	// Edits can't be patched in, so they rewrite the file, still compressed.
+	std::optional<NavAreaLocation> location = edited.FindAreaLocation(3u);
+	edited.areas.value().at(2).Flags = 7u;
+	edited.areas.value().at(2).MarkDirty();
+	if (location.has_value() && edited.PatchAreaData(location.value())) return fail("Failed! Patched a compressed file!");
+	if (!edited.SaveFile(true, true)) return fail("Edited Save Failed!");
+	NavFile reread(TestPath);
+	if (!reread.ReadFile() || reread.GetCompression() != NavCompression::GZIP || reread.areas.value().at(2).Flags != 7u) return fail("Failed! Edit was not saved!");
+	// Saving uncompressed writes the NAV data as is.
+	reread.SetCompression(NavCompression::NONE);
+	if (!reread.SaveFile(true, true)) return fail("Uncompressed Save Failed!");
+	{
+		std::ifstream savedFile(TestPath, std::ios_base::in | std::ios_base::binary);
+		std::stringstream savedData;
+		savedData << savedFile.rdbuf();
+		if (!reread.SerializeData(expected) || savedData.str() != expected) return fail("Failed! Uncompressed file does not match NAV data!");
+	}
+	std::filesystem::remove(TestPath);
+	return {true, "NAV Compressed IO: Passed!"};
+}
+
+// Stream buffer over a string that can't seek or tell its position, like a pipe.
+class ForwardOnlyBuf : public std::stringbuf {
+	public:
+		ForwardOnlyBuf(const std::string& data) : std::stringbuf(data, std::ios_base::in) {}
+	protected:
+		pos_type seekoff(off_type, std::ios_base::seekdir, std::ios_base::openmode) override { return pos_type(off_type(-1)); }
+		pos_type seekpos(pos_type, std::ios_base::openmode) override { return pos_type(off_type(-1)); }
+};
+
+// Tests reading NAV data from streams that can't seek, and from a pipe.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavPipeIO() {
+	// CS:GO, whose custom data size depends on the data.
+	NavFile init = MakeTestNavFile(5u, [](NavArea& area, const size_t& i) {
+		area.hideSpotData.first = i % 2u;
+		area.hideSpotData.second.resize(area.hideSpotData.first);
+	}, 1u);
+	std::string data;
+	if (!init.SerializeData(data)) return {false, "NAV Pipe I/O: Write Failed!"};
+	NavFile expected;
+	NavBufferReader reader(std::as_bytes(std::span(data)));
+	if (!expected.ReadData(reader)) return {false, "NAV Pipe I/O: Buffer Read Failed!"};
+	auto matches = [&expected](NavFile& file) -> bool {
+		if (file.GetAreaCount() != expected.GetAreaCount() || file.GetAreaDataLoc() != expected.GetAreaDataLoc() || file.GetLadderDataLoc() != expected.GetLadderDataLoc()) return false;
+		for (size_t i = 0u; i < file.areas.value().size(); i++)
+		{
+			if (file.areas.value()[i].ID != expected.areas.value()[i].ID || file.areas.value()[i].size != expected.areas.value()[i].size) return false;
+		}
+		return true;
+	};
+	{
+		ForwardOnlyBuf stream(data);
+		NavFile streamed;
+		if (!streamed.ReadData(stream)) return {false, "NAV Pipe I/O: Forward-only Read Failed!"};
+		if (!matches(streamed)) return {false, "NAV Pipe I/O: Failed! Forward-only read does not match!"};
+	}
+	// Through a pipe, compressed.
+	std::string compressed;
+	if (!CompressNavData(std::as_bytes(std::span(data)), NavCompression::GZIP, compressed)) return {false, "NAV Pipe I/O: Compress Failed!"};
+	int fds[2];
+	if (pipe(fds) == -1) return {false, "NAV Pipe I/O: Pipe Failed!"};
+	std::thread writer([&compressed, &fds]() {
+		for (size_t written = 0u; written < compressed.size();)
+		{
+			ssize_t ret = write(fds[1], compressed.data() + written, compressed.size() - written);
+			if (ret <= 0) break;
+			written += ret;
+		}
+		close(fds[1]);
+	});
+	NavReadBuf pipeBuf(fds[0]);
+	NavFile piped;
+	const bool readPipe = piped.ReadData(pipeBuf);
+	writer.join();
+	close(fds[0]);
+	if (!readPipe || pipeBuf.Failed() || pipeBuf.GetCompression() != NavCompression::GZIP) return {false, "NAV Pipe I/O: Pipe Read Failed!"};
+	if (!matches(piped)) return {false, "NAV Pipe I/O: Failed! Piped read does not match!"};
+	return {true, "NAV Pipe I/O: Passed!"};
+}
+
+// Tests swapping NAV data to big-endian and back, and saving and reading big-endian files, plain and compressed.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavByteOrder() {
+	// Runs of each width swap like one value at a time, SIMD or not.
+	for (const size_t width : {2u, 4u, 8u})
+	{
+		std::vector<std::byte> run(37u * width), expected;
+		for (size_t i = 0u; i < run.size(); i++) run[i] = static_cast<std::byte>(i * 7u);
+		expected = run;
+		for (size_t i = 0u; i < expected.size(); i += width) std::reverse(expected.begin() + i, expected.begin() + i + width);
+		SwapNavBytes(run, width);
+		if (run != expected) return {false, "NAV Byte Order: Failed! Swapped " + std::to_string(width) + "-byte values wrong!"};
+	}
+	// Runs of records with mixed field widths swap like one field at a time, across more than one batch.
+	auto swapsRecords = []<typename T>(const T&) -> bool {
+		std::vector<std::byte> run((NAV_SWAP_BATCH_COUNT * 2u + 3u) * NavRecordCodec<T>::Size), expected;
+		for (size_t i = 0u; i < run.size(); i++) run[i] = static_cast<std::byte>(i * 7u);
+		expected = run;
+		for (size_t pos = 0u; pos < expected.size();) for (const unsigned char& width : NavRecordCodec<T>::Fields)
+		{
+			std::reverse(expected.begin() + pos, expected.begin() + pos + width);
+			pos += width;
+		}
+		SwapRecordRun<T>(run);
+		return run == expected;
+	};
+	if (!swapsRecords(NavHideSpot()) || !swapsRecords(NavApproachSpot()) || !swapsRecords(NavVisibleArea()) || !swapsRecords(NavEncounterSpot()))
+		return {false, "NAV Byte Order: Failed! Swapped records wrong!"};
+	const std::filesystem::path TestPath = std::filesystem::temp_directory_path() / "nav_byte_order_test.nav";
+	// CS:GO, whose custom data holds approach spots.
+	NavFile init = MakeTestNavFile(4u, [](NavArea& area, const size_t& i) {
+		area.Flags = 0x01020304u;
+		area.nwCorner = {1.5f, -2.0f, 300.25f};
+		area.PlaceID = 0x0102u;
+		area.connectionData[i % 4u].first = 1u;
+		area.connectionData[i % 4u].second.emplace_back().TargetAreaID = 0x11223344u;
+		area.hideSpotData.first = i % 3u;
+		area.hideSpotData.second.resize(area.hideSpotData.first);
+		area.encounterPathCount = 1u;
+		area.encounterPaths.emplace(1u);
+		area.encounterPaths.value().front().ToAreaID = 0x0A0B0C0Du;
+		area.encounterPaths.value().front().spotCount = 2u;
+		area.encounterPaths.value().front().spotContainer.resize(2u);
+		area.encounterPaths.value().front().spotContainer.back().OrderID = 0x05060708u;
+		// One approach spot.
+		area.customData = {1u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u, 11u, 12u, 13u, 14u};
+		area.customDataSize = area.customData.size();
+	}, 1u, TestPath);
+	std::string little;
+	if (!init.SerializeData(little)) return {false, "NAV Byte Order: Write Failed!"};
+	// Swapping reaches the ladders, and swaps back to the same data.
+	{
+		std::string data = little;
+		const unsigned int ladderCount = 2u;
+		data.resize(data.size() - VALVE_INT_SIZE);
+		data.append(reinterpret_cast<const char*>(&ladderCount), VALVE_INT_SIZE);
+		data.append(ladderCount * LADDER_SIZE, '\x01');
+		const std::string original = data;
+		if (!NavFile::SwapByteOrder(std::as_writable_bytes(std::span(data)), false)) return {false, "NAV Byte Order: Swap Failed!"};
+		if (DetectNavByteOrder(std::as_bytes(std::span(data))) != std::endian::big || data.substr(data.size() - ladderCount * LADDER_SIZE - VALVE_INT_SIZE, VALVE_INT_SIZE) != std::string("\0\0\0\x02", 4u)) return {false, "NAV Byte Order: Failed! Data was not swapped!"};
+		if (!NavFile::SwapByteOrder(std::as_writable_bytes(std::span(data)), true) || data != original) return {false, "NAV Byte Order: Failed! Data did not swap back!"};
+		data.resize(data.size() - 1u);
+		if (NavFile::SwapByteOrder(std::as_writable_bytes(std::span(data)), false)) return {false, "NAV Byte Order: Failed! Swapped data that is cut short!"};
+	}
+	auto fail = [&TestPath](const std::string& message) -> std::pair<bool, std::string > {
+		std::filesystem::remove(TestPath);
+		return {false, "NAV Byte Order: " + message};
+	};
+	auto readSaved = [&TestPath]() -> std::string {
+		std::ifstream savedFile(TestPath, std::ios_base::in | std::ios_base::binary);
+		std::stringstream savedData;
+		savedData << savedFile.rdbuf();
+		return savedData.str();
+	};
+	// Saved big-endian, it reads back to the same data.
+	init.SetByteOrder(std::endian::big);
+	if (!init.SaveFile(true)) return fail("Save Failed!");
+	std::string big = readSaved();
+	if (big.size() != little.size() || big.substr(0u, 4u) != "\xFE\xED\xFA\xCE") return fail("Failed! File is not big-endian!");
+	NavFile reread(TestPath);
+	std::string data;
+	if (!reread.ReadFile() || reread.GetByteOrder() != std::endian::big || !reread.SerializeData(data) || data != little) return fail("Failed! Read wrong data!");
+	// Edits can't be patched in, so they rewrite the file, still big-endian.
+	std::optional<NavAreaLocation> location = reread.FindAreaLocation(2u);
+	reread.areas.value().at(1).Flags = 7u;
+	reread.areas.value().at(1).MarkDirty();
+	if (location.has_value() && reread.PatchAreaData(location.value())) return fail("Failed! Patched a big-endian file!");
+	// Compressed, it is read from a stream.
+	reread.SetCompression(NavCompression::GZIP);
+	if (!reread.SaveFile(true, true)) return fail("Compressed Save Failed!");
+	NavFile compressed(TestPath);
+	if (!compressed.ReadFile() || compressed.GetByteOrder() != std::endian::big || compressed.GetCompression() != NavCompression::GZIP || compressed.areas.value().at(1).Flags != 7u) return fail("Failed! Read wrong compressed data!");
+	// Converted back, the file is the little-endian data again.
+	compressed.areas.value().at(1).Flags = init.areas.value().at(1).Flags;
+	compressed.areas.value().at(1).MarkDirty();
+	compressed.SetCompression(NavCompression::NONE);
+	compressed.SetByteOrder(std::endian::little);
+	if (!compressed.SaveFile(true, true) || readSaved() != little) return fail("Failed! Converted file does not match NAV data!");
+	std::filesystem::remove(TestPath);
+	return {true, "NAV Byte Order: Passed!"};
+}
+
+// Tests that corrupt counts fail to read, from memory and from streams, instead of allocating for them.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavCorruptCounts() {
+	NavFile init = MakeTestNavFile(3u, [](NavArea& area, const size_t&) {
+		area.connectionData[0].first = 2u;
+		area.connectionData[0].second.resize(2u);
+		area.encounterPathCount = 1u;
+		area.encounterPaths.emplace(1u);
+	});
+	std::string data;
+	if (!init.SerializeData(data)) return {false, "NAV Corrupt Counts: Write Failed!"};
+	// Read from memory and from a stream, which can't tell how much data is left.
+	auto readsBoth = [](const std::string& data) -> bool {
+		NavFile inMemory, streamed;
+		NavBufferReader reader(std::as_bytes(std::span(data)));
+		ForwardOnlyBuf stream(data);
+		const bool readMemory = inMemory.ReadData(reader), readStream = streamed.ReadData(stream);
+		if (readMemory != readStream) throw std::logic_error("reads disagree");
+		return readMemory;
+	};
+	NavFile valid;
+	NavBufferReader reader(std::as_bytes(std::span(data)));
+	if (!valid.ReadData(reader)) return {false, "NAV Corrupt Counts: Read Failed!"};
+	// Records are allocated exactly.
+	const std::pmr::vector<NavConnection>& connections = valid.areas.value().front().connectionData[0].second;
+	if (connections.size() != 2u || connections.capacity() != 2u || valid.areas.value().capacity() != 3u) return {false, "NAV Corrupt Counts: Failed! Reserved the wrong amount!"};
+	const size_t areaDataLoc = static_cast<std::streamoff>(valid.GetAreaDataLoc()), areaCountLoc = areaDataLoc - VALVE_INT_SIZE;
+	// ID, flags, both corners and the other two heights come before the connections.
+	const size_t connectionCountLoc = areaDataLoc + VALVE_INT_SIZE * 2u + VALVE_FLOAT_SIZE * 8u;
+	const size_t encounterPathCountLoc = connectionCountLoc + (VALVE_INT_SIZE + CONNECTION_SIZE * 2u) + VALVE_INT_SIZE * 3u + VALVE_CHAR_SIZE;
+	const size_t ladderCountLoc = data.size() - VALVE_INT_SIZE;
+	const unsigned int corruptCount = 0xFFFFFFF0u;
+	try {
+		if (!readsBoth(data)) return {false, "NAV Corrupt Counts: Failed! Valid data did not read!"};
+		for (const size_t& loc : {areaCountLoc, connectionCountLoc, encounterPathCountLoc, ladderCountLoc})
+		{
+			std::string corrupt = data;
+			corrupt.replace(loc, VALVE_INT_SIZE, reinterpret_cast<const char*>(&corruptCount), VALVE_INT_SIZE);
+			if (readsBoth(corrupt)) return {false, "NAV Corrupt Counts: Failed! Read a corrupt count at " + std::to_string(loc) + "!"};
+		}
+	}
+	catch (const std::exception& e) {
+		return {false, std::string("NAV Corrupt Counts: Failed! ") + e.what()};
+	}
+	return {true, "NAV Corrupt Counts: Passed!"};
+}
+
+// Tests that custom data round-trips, from memory and from streams, with and without a codec, and that codecs decode it.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavCustomData() {
+	auto makeFile = [](const std::optional<unsigned int>& minorVersion, const std::vector<unsigned char>& customData) -> NavFile {
+		return MakeTestNavFile(3u, [&customData](NavArea& area, const size_t& i) {
+			area.encounterPathCount = 0u;
+			area.customData.assign(customData.begin(), customData.end());
+			area.customData.front() += i;
+			area.customDataSize = area.customData.size();
+		}, minorVersion);
+	};
+	// Reads data from memory and from a stream, and writes it back the same, in either byte order.
+	auto roundTrips = [](const std::string& data, const std::vector<std::byte>& trailingData) -> std::optional<std::string> {
+		NavFile inMemory, streamed;
+		NavBufferReader reader(std::as_bytes(std::span(data)));
+		ForwardOnlyBuf stream(data);
+		if (!inMemory.ReadData(reader) || !streamed.ReadData(stream)) return "Read Failed!";
+		if (inMemory.GetTrailingData() != trailingData || streamed.GetTrailingData() != trailingData) return "Failed! Trailing data does not match!";
+		std::string memoryData, streamData;
+		if (!inMemory.SerializeData(memoryData) || !streamed.SerializeData(streamData) || memoryData != data || streamData != data) return "Failed! Written data does not match!";
+		std::string swapped = data;
+		if (!NavFile::SwapByteOrder(std::as_writable_bytes(std::span(swapped)), false) || swapped == data) return "Swap Failed!";
+		if (!NavFile::SwapByteOrder(std::as_writable_bytes(std::span(swapped)), true) || swapped != data) return "Failed! Data did not swap back!";
+		return std::nullopt;
+	};
+	const std::vector<std::byte> trailingData = {std::byte{0xDE}, std::byte{0xAD}, std::byte{0xBE}, std::byte{0xEF}, std::byte{0x01}};
+	// The Left 4 Dead 2 codec is only used once registered.
+	if (getCustomDataSize(LATEST_NAV_MAJOR_VERSION, 14u) != 0u) return {false, "NAV Custom Data: Failed! Unconfirmed codec is registered!"};
+	RegisterCustomDataCodec(EngineVersion::LEFT_4_DEAD_2, LeftFourDead2Codec);
+	// Left 4 Dead 2: spawn attributes, and data after the ladders.
+	NavFile l4d2 = makeFile(14u, {0x10u, 0x00u, 0x00u, 0x80u});
+	l4d2.GetTrailingData() = trailingData;
+	std::string data;
+	std::optional<std::string> error;
+	if (!l4d2.SerializeData(data)) error = "Write Failed!";
+	else error = roundTrips(data, trailingData);
+	// Swapped, spawn attributes are reversed but trailing data isn't.
+	std::string swapped = data;
+	if (!error.has_value() && (!NavFile::SwapByteOrder(std::as_writable_bytes(std::span(swapped)), false) || swapped.substr(swapped.size() - trailingData.size()) != data.substr(data.size() - trailingData.size())))
+		error = "Failed! Trailing data was swapped!";
+	std::ostringstream output;
+	OutputCustomData(output, std::as_bytes(std::span(l4d2.areas.value().front().customData)), l4d2.GetMajorVersion(), l4d2.GetMinorVersion());
+	RegisterCustomDataCodec(EngineVersion::LEFT_4_DEAD_2, NavCustomDataCodec());
+	if (error.has_value()) return {false, "NAV Custom Data: Left 4 Dead 2 " + error.value()};
+	// A codec of our own: pre-area data, and 2 bytes of custom data per area passed through as they are.
+	const NavCustomDataCodec original = GetCustomDataCodec(LATEST_NAV_MAJOR_VERSION, 5u);
+	NavCustomDataCodec codec;
+	codec.Name = "Test";
+	codec.AreaMinSize = 2u;
+	codec.PreAreaSize = 8u;
+	RegisterCustomDataCodec(EngineVersion::DEFAULT, codec);
+	NavFile custom = makeFile(5u, {0x20u, 0x21u});
+	custom.GetPreAreaData() = {std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}, std::byte{6}, std::byte{7}, std::byte{8}};
+	if (!custom.SerializeData(data)) error = "Write Failed!";
+	else {
+		NavFile reread;
+		NavBufferReader reader(std::as_bytes(std::span(data)));
+		if (!reread.ReadData(reader) || reread.GetPreAreaData() != custom.GetPreAreaData() || reread.areas.value().back().customData.size() != 2u) error = "Failed! Read wrong data!";
+		else error = roundTrips(data, {});
+	}
+	RegisterCustomDataCodec(EngineVersion::DEFAULT, original);
+	if (error.has_value()) return {false, "NAV Custom Data: Custom Codec " + error.value()};
+	// Output is decoded by the codec of the game.
+	OutputCustomData(output, std::as_bytes(std::span(makeFile(2u, {0x04u, 0x00u, 0x00u, 0x00u}).areas.value().front().customData)), LATEST_NAV_MAJOR_VERSION, 2u);
+	if (output.str().find("Spawn Attributes Flag: 0x80000010") == std::string::npos || output.str().find("TFAttributes Flag: 0x4") == std::string::npos) return {false, "NAV Custom Data: Failed! Output was not decoded!"};
+	return {true, "NAV Custom Data: Passed!"};
+}
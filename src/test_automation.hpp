@@ -22,4 +22,84 @@ std::pair<bool, std::string > TestNavAreaDataIO();
 // Tests the I/O of NAV files.
 // True on success, false on failure.
 std::pair<bool, std::string > TestNAVFileIO();
+
+// Tests that decoding NAV data from memory matches decoding it from a stream.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavBufferIO();
+
+// Tests that decoding and encoding areas on several threads matches doing it serially.
+// True on success, false on failure.
+std::pair<bool, std::string > TestParallelAreaDecode();
+
+// Tests that streaming areas gives the same areas as reading the whole file.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaStream();
+
+// Tests patching fixed-width area fields in place.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaPatch();
+
+// Tests that saving replaces the whole file.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavFileSave();
+
+// Tests that incremental saves copy clean areas and encode dirty ones correctly.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavIncrementalSave();
+
+// Tests that reading only the header gets the same counts as a full read, with the ladder count known only through the sidecar index.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavFileHeader();
+
+// Tests that heavy area sections are decoded on first access, and written back unchanged until then.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaLazySections();
+
+// Tests that reading, writing, skipping and sizing area data agree on the layout of every version.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaSchema();
+
+// Tests building, querying and writing back a columnar area table.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavAreaTable();
+
+// Tests that read areas allocate from their file's arena, and that copies of them don't.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavFileArena();
+
+// Tests building an adjacency graph from connections and ladders.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavGraph();
+
+// Tests the ID index with dense and sparse IDs, and NavFile lookups across inserting and erasing areas.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavIDMap();
+
+// Tests serving commands on a loaded file, directly and over a socket, and saving only when asked to.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavServer();
+
+// Tests loading, querying, editing and writing a mesh through the C interface.
+// True on success, false on failure.
+std::pair<bool, std::string > TestLibNav();
+
+// Tests saving a gzip compressed file, and reading, streaming and editing it without decompressing it first.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavCompressedIO();
+
+// Tests reading NAV data from streams that can't seek, and from a pipe.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavPipeIO();
+
+// Tests swapping NAV data to big-endian and back, and saving and reading big-endian files, plain and compressed.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavByteOrder();
+
+// Tests that corrupt counts fail to read, from memory and from streams, instead of allocating for them.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavCorruptCounts();
+
+// Tests that custom data round-trips, from memory and from streams, with and without a codec, and that codecs decode it.
+// True on success, false on failure.
+std::pair<bool, std::string > TestNavCustomData();
 #endif
\ No newline at end of file
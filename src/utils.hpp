@@ -1,6 +1,7 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 #include <utility>
+#include <optional>
 #include <regex>
 // Utility regxes.
 extern std::regex IDrx;